@@ -0,0 +1,496 @@
+// End-to-end benchmark: generates corpora with XmlGenerator at several scale
+// factors and layouts, runs a fixed query workload through the full
+// lexer -> parser -> executor pipeline and records throughput, latency
+// percentiles and peak RSS to a JSON results file. Each benchmark runs in a
+// child process of its own, so its peak RSS is not inflated by the ones
+// before it.
+//
+// Usage:
+//   bench_e2e [--scale 1MB|100MB|10GB]... [--layout small|huge|both]
+//             [--iterations <n>] [--corpus-dir <dir>] [--regenerate]
+//             [--filter <substr>] [--output <results.json>]
+//             [--compare <baseline.json>] [--threshold <percent>]
+//             [--schema <file.xsd>]
+
+#include "parser/lexer.h"
+#include "parser/parser.h"
+#include "executor/query_executor.h"
+#include "generator/xsd_parser.h"
+#include "generator/xml_generator.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef EXPOCLI_BENCH_SCHEMA
+#define EXPOCLI_BENCH_SCHEMA "bench/corpus_schema.xsd"
+#endif
+
+using namespace expocli;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Files produced for the "huge" layout, regardless of scale
+const size_t kHugeFileCount = 4;
+
+struct Options {
+    std::vector<std::string> scales;
+    std::string layout = "both";
+    int iterations = 5;
+    std::string corpusDir = (fs::temp_directory_path() / "expocli_bench").string();
+    bool regenerate = false;
+    std::string filter;
+    std::string output = "bench_e2e_results.json";
+    std::string compare;
+    double thresholdPercent = 10.0;
+    std::string schema = EXPOCLI_BENCH_SCHEMA;
+};
+
+struct WorkloadQuery {
+    const char* name;
+    const char* text;   // "{dir}" is replaced by the corpus directory
+};
+
+// Fixed workload: filters, partial paths, FOR joins, GROUP BY, ORDER BY/LIMIT, DISTINCT
+const WorkloadQuery kWorkload[] = {
+    {"filter", "SELECT purchase.customer, purchase.amount FROM '{dir}' WHERE purchase.amount > 500"},
+    {"partial_path", "SELECT .sku, .price FROM '{dir}' WHERE .price > 900"},
+    {"for_join", "SELECT o.customer, i.sku FROM '{dir}' FOR o IN sales.purchase FOR i IN o.item WHERE i.price > 500"},
+    {"group_by", "SELECT o.region, COUNT(o.amount) FROM '{dir}' FOR o IN sales.purchase GROUP BY o.region"},
+    {"order_limit", "SELECT purchase.customer, purchase.amount FROM '{dir}' ORDER BY amount DESC LIMIT 10"},
+    {"distinct", "SELECT DISTINCT purchase.region FROM '{dir}'"},
+};
+
+struct Corpus {
+    std::string label;   // e.g. "1MB/small"
+    std::string dir;
+    size_t files = 0;
+    uintmax_t bytes = 0;
+};
+
+struct Result {
+    std::string name;
+    uintmax_t corpusBytes = 0;
+    size_t files = 0;
+    size_t rows = 0;
+    int iterations = 0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double throughputMBps = 0.0;
+    long peakRssKb = 0;
+};
+
+void printUsage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --scale <size>         Corpus size (e.g. 1MB, 100MB, 10GB); repeatable, default 1MB\n"
+              << "  --layout <l>           small (many small files), huge (few large files) or both\n"
+              << "  --iterations <n>       Runs per query (default 5)\n"
+              << "  --corpus-dir <dir>     Where corpora are generated and cached\n"
+              << "  --regenerate           Regenerate corpora even if cached\n"
+              << "  --filter <substr>      Only run matching benchmarks\n"
+              << "  --output <file>        JSON results file (default bench_e2e_results.json)\n"
+              << "  --compare <file>       Compare against a baseline results file\n"
+              << "  --threshold <pct>      Regression threshold in percent (default 10)\n"
+              << "  --schema <file.xsd>    Schema used to generate corpora\n";
+}
+
+uintmax_t parseSize(const std::string& text) {
+    size_t pos = 0;
+    double value = std::stod(text, &pos);
+    std::string unit = text.substr(pos);
+    std::transform(unit.begin(), unit.end(), unit.begin(), ::toupper);
+    double multiplier = 1.0;
+    if (unit == "KB") multiplier = 1024.0;
+    else if (unit == "MB") multiplier = 1024.0 * 1024.0;
+    else if (unit == "GB") multiplier = 1024.0 * 1024.0 * 1024.0;
+    else if (!unit.empty() && unit != "B") {
+        throw std::runtime_error("Invalid size unit: " + text);
+    }
+    return static_cast<uintmax_t>(value * multiplier);
+}
+
+// Nearest-rank percentile over sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+uintmax_t directoryBytes(const std::string& dir, size_t& files) {
+    uintmax_t total = 0;
+    files = 0;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".xml") {
+            total += entry.file_size();
+            ++files;
+        }
+    }
+    return total;
+}
+
+// Many small files: one generated document per file until the target is reached
+void generateSmallLayout(XmlGenerator& generator, const XsdSchema& schema,
+                         const std::string& dir, uintmax_t target) {
+    uintmax_t written = 0;
+    for (size_t i = 0; written < target; ++i) {
+        std::ostringstream name;
+        name << dir << "/doc_" << std::setfill('0') << std::setw(7) << i << ".xml";
+        std::FILE* out = std::fopen(name.str().c_str(), "wb");
+        if (!out) {
+            throw std::runtime_error("Cannot write " + name.str());
+        }
+        written += generator.writeDocument(schema, out);
+        std::fclose(out);
+    }
+}
+
+// Few huge files: the schema's record lists repeated until each file reaches its share
+void generateHugeLayout(XmlGenerator& generator, const XsdSchema& schema,
+                        const std::string& dir, uintmax_t target) {
+    uintmax_t perFile = std::max<uintmax_t>(1, target / kHugeFileCount);
+
+    for (size_t f = 0; f < kHugeFileCount; ++f) {
+        std::ostringstream name;
+        name << dir << "/huge_" << f << ".xml";
+        std::FILE* out = std::fopen(name.str().c_str(), "wb");
+        if (!out) {
+            throw std::runtime_error("Cannot write " + name.str());
+        }
+        generator.writeDocument(schema, out, perFile);
+        std::fclose(out);
+    }
+}
+
+Corpus prepareCorpus(const Options& options, const XsdSchema& schema,
+                     const std::string& scale, const std::string& layout) {
+    Corpus corpus;
+    corpus.label = scale + "/" + layout;
+    corpus.dir = (fs::path(options.corpusDir) / (scale + "_" + layout)).string();
+
+    uintmax_t target = parseSize(scale);
+    fs::path marker = fs::path(corpus.dir) / ".complete";
+
+    bool cached = false;
+    if (!options.regenerate && fs::exists(marker)) {
+        std::ifstream in(marker);
+        uintmax_t cachedTarget = 0;
+        in >> cachedTarget;
+        cached = (cachedTarget == target);
+    }
+
+    if (!cached) {
+        std::cerr << "Generating " << corpus.label << " corpus in " << corpus.dir << "..." << std::endl;
+        fs::remove_all(corpus.dir);
+        fs::create_directories(corpus.dir);
+
+        XmlGenerator generator;
+        if (layout == "small") {
+            generateSmallLayout(generator, schema, corpus.dir, target);
+        } else {
+            generateHugeLayout(generator, schema, corpus.dir, target);
+        }
+        std::ofstream(marker) << target << "\n";
+    }
+
+    corpus.bytes = directoryBytes(corpus.dir, corpus.files);
+    return corpus;
+}
+
+Result runQuery(const Corpus& corpus, const WorkloadQuery& query, int iterations) {
+    std::string text = query.text;
+    text.replace(text.find("{dir}"), 5, corpus.dir);
+
+    Lexer lexer(text);
+    auto tokens = lexer.tokenize();
+
+    Result result;
+    result.name = corpus.label + "/" + query.name;
+    result.corpusBytes = corpus.bytes;
+    result.files = corpus.files;
+    result.iterations = iterations;
+
+    std::vector<double> samples;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        Parser parser(tokens);
+        auto ast = parser.parse();
+        auto rows = QueryExecutor::execute(*ast);
+        auto end = std::chrono::steady_clock::now();
+
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        result.rows = rows.size();
+    }
+    std::sort(samples.begin(), samples.end());
+
+    result.p50Ms = percentile(samples, 0.50);
+    result.p99Ms = percentile(samples, 0.99);
+    if (result.p50Ms > 0) {
+        result.throughputMBps = (corpus.bytes / (1024.0 * 1024.0)) / (result.p50Ms / 1000.0);
+    }
+    return result;
+}
+
+// Fields a child process reports back for runIsolated
+struct ChildReport {
+    size_t rows;
+    double p50Ms;
+    double p99Ms;
+    double throughputMBps;
+    int failed;
+};
+
+// runQuery in a forked child; the child's own peak RSS comes from wait4,
+// since ru_maxrss of this process never goes down between benchmarks
+Result runIsolated(const Corpus& corpus, const WorkloadQuery& query, int iterations) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("Cannot create a pipe for the benchmark process");
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw std::runtime_error("Cannot fork the benchmark process");
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        ChildReport report{};
+        try {
+            Result r = runQuery(corpus, query, iterations);
+            report = {r.rows, r.p50Ms, r.p99Ms, r.throughputMBps, 0};
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            report.failed = 1;
+        }
+        ssize_t written = write(fds[1], &report, sizeof(report));
+        _exit(written == static_cast<ssize_t>(sizeof(report)) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ChildReport report{};
+    ssize_t got = read(fds[0], &report, sizeof(report));
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0 || got != static_cast<ssize_t>(sizeof(report)) ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0 || report.failed) {
+        throw std::runtime_error("Benchmark " + corpus.label + "/" + query.name + " failed");
+    }
+
+    Result result;
+    result.name = corpus.label + "/" + query.name;
+    result.corpusBytes = corpus.bytes;
+    result.files = corpus.files;
+    result.iterations = iterations;
+    result.rows = report.rows;
+    result.p50Ms = report.p50Ms;
+    result.p99Ms = report.p99Ms;
+    result.throughputMBps = report.throughputMBps;
+    result.peakRssKb = usage.ru_maxrss;  // Kilobytes on Linux
+    return result;
+}
+
+void writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "{\n  \"benchmark\": \"bench_e2e\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        // One object per line so baselines can be diffed and parsed line-wise
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"corpus_bytes\": " << r.corpusBytes
+            << ", \"files\": " << r.files
+            << ", \"rows\": " << r.rows
+            << ", \"iterations\": " << r.iterations
+            << std::fixed << std::setprecision(3)
+            << ", \"p50_ms\": " << r.p50Ms
+            << ", \"p99_ms\": " << r.p99Ms
+            << ", \"throughput_mbps\": " << r.throughputMBps
+            << ", \"peak_rss_kb\": " << r.peakRssKb << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Extract a numeric or string field from a single-line JSON object
+std::string jsonField(const std::string& line, const std::string& key) {
+    std::string needle = "\"" + key + "\": ";
+    size_t pos = line.find(needle);
+    if (pos == std::string::npos) return "";
+    pos += needle.size();
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        return line.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end - pos);
+}
+
+std::map<std::string, Result> readBaseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open baseline file: " + path);
+    }
+    std::map<std::string, Result> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string name = jsonField(line, "name");
+        if (name.empty()) continue;
+        Result r;
+        r.name = name;
+        r.p50Ms = std::stod(jsonField(line, "p50_ms"));
+        r.p99Ms = std::stod(jsonField(line, "p99_ms"));
+        r.throughputMBps = std::stod(jsonField(line, "throughput_mbps"));
+        r.peakRssKb = std::stol(jsonField(line, "peak_rss_kb"));
+        baseline[name] = r;
+    }
+    return baseline;
+}
+
+// Returns the number of regressions beyond the threshold
+int compareWithBaseline(const std::vector<Result>& results,
+                        const std::map<std::string, Result>& baseline,
+                        double thresholdPercent) {
+    double limit = 1.0 + thresholdPercent / 100.0;
+    int regressions = 0;
+
+    std::cout << "\nComparison against baseline (threshold " << thresholdPercent << "%)\n";
+    std::cout << std::left << std::setw(32) << "Benchmark" << std::right
+              << std::setw(12) << "p50 base" << std::setw(12) << "p50 now"
+              << std::setw(10) << "delta" << std::setw(12) << "RSS delta" << "  Status\n";
+    std::cout << std::string(90, '-') << "\n";
+
+    for (const auto& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end()) {
+            std::cout << std::left << std::setw(32) << r.name << "  (not in baseline)\n";
+            continue;
+        }
+        const Result& base = it->second;
+        double latencyRatio = base.p50Ms > 0 ? r.p50Ms / base.p50Ms : 1.0;
+        double rssRatio = base.peakRssKb > 0 ? static_cast<double>(r.peakRssKb) / base.peakRssKb : 1.0;
+
+        std::string status = "ok";
+        if (latencyRatio > limit) {
+            status = "REGRESSION (latency)";
+        } else if (rssRatio > limit) {
+            status = "REGRESSION (memory)";
+        }
+        if (status != "ok") ++regressions;
+
+        std::cout << std::left << std::setw(32) << r.name << std::right << std::fixed
+                  << std::setprecision(2)
+                  << std::setw(12) << base.p50Ms << std::setw(12) << r.p50Ms
+                  << std::setw(9) << (latencyRatio - 1.0) * 100.0 << "%"
+                  << std::setw(11) << (rssRatio - 1.0) * 100.0 << "%"
+                  << "  " << status << "\n";
+    }
+
+    std::cout << "\n" << regressions << " regression(s) found\n";
+    return regressions;
+}
+
+bool parseArgs(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--scale") options.scales.push_back(next());
+        else if (arg == "--layout") options.layout = next();
+        else if (arg == "--iterations") options.iterations = std::max(1, std::atoi(next().c_str()));
+        else if (arg == "--corpus-dir") options.corpusDir = next();
+        else if (arg == "--regenerate") options.regenerate = true;
+        else if (arg == "--filter") options.filter = next();
+        else if (arg == "--output") options.output = next();
+        else if (arg == "--compare") options.compare = next();
+        else if (arg == "--threshold") options.thresholdPercent = std::stod(next());
+        else if (arg == "--schema") options.schema = next();
+        else if (arg == "-h" || arg == "--help") { printUsage(argv[0]); return false; }
+        else throw std::runtime_error("Unknown argument: " + arg);
+    }
+
+    if (options.scales.empty()) {
+        options.scales.push_back("1MB");
+    }
+    if (options.layout != "small" && options.layout != "huge" && options.layout != "both") {
+        throw std::runtime_error("Invalid layout: " + options.layout);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options;
+        if (!parseArgs(argc, argv, options)) {
+            return 0;
+        }
+
+        auto schema = XsdParser::parse(options.schema);
+
+        std::vector<std::string> layouts;
+        if (options.layout == "small" || options.layout == "both") layouts.push_back("small");
+        if (options.layout == "huge" || options.layout == "both") layouts.push_back("huge");
+
+        std::cout << std::left << std::setw(32) << "Benchmark" << std::right
+                  << std::setw(10) << "files" << std::setw(10) << "rows"
+                  << std::setw(12) << "p50 ms" << std::setw(12) << "p99 ms"
+                  << std::setw(10) << "MB/s" << std::setw(12) << "RSS KB" << "\n";
+        std::cout << std::string(98, '-') << "\n";
+
+        std::vector<Result> results;
+        for (const auto& scale : options.scales) {
+            for (const auto& layout : layouts) {
+                Corpus corpus = prepareCorpus(options, *schema, scale, layout);
+
+                for (const auto& query : kWorkload) {
+                    std::string name = corpus.label + "/" + query.name;
+                    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                        continue;
+                    }
+
+                    Result r = runIsolated(corpus, query, options.iterations);
+                    std::cout << std::left << std::setw(32) << r.name << std::right
+                              << std::setw(10) << r.files << std::setw(10) << r.rows
+                              << std::fixed << std::setprecision(2)
+                              << std::setw(12) << r.p50Ms << std::setw(12) << r.p99Ms
+                              << std::setw(10) << r.throughputMBps
+                              << std::setw(12) << r.peakRssKb << std::endl;
+                    results.push_back(r);
+                }
+            }
+        }
+
+        writeJson(options.output, results);
+        std::cout << "\nResults written to " << options.output << "\n";
+
+        if (!options.compare.empty()) {
+            auto baseline = readBaseline(options.compare);
+            if (compareWithBaseline(results, baseline, options.thresholdPercent) > 0) {
+                return 2;
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,186 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace expocli {
+namespace bench {
+
+// Prevent the optimizer from discarding a benchmark result
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Per-benchmark outcome (nanoseconds per operation over repetitions)
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;   // Iterations per repetition
+    double median_ns = 0.0;
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+    double bytes_per_op = 0.0; // 0 when throughput is not meaningful
+};
+
+// Small built-in harness: calibrates the iteration count so that one
+// repetition takes roughly `min_time_ms`, then reports the median of
+// `repetitions` runs. Benchmarks are registered as closures taking the
+// number of iterations to run.
+class Harness {
+public:
+    using BenchFn = std::function<void(uint64_t iterations)>;
+
+    // Parse --filter <substr>, --json, --repetitions <n>, --min-time-ms <n>
+    bool parseArgs(int argc, char* argv[]) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) {
+                filter_ = argv[++i];
+            } else if (arg == "--json") {
+                json_ = true;
+            } else if (arg == "--repetitions" && i + 1 < argc) {
+                repetitions_ = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--min-time-ms" && i + 1 < argc) {
+                minTimeMs_ = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "-h" || arg == "--help") {
+                std::cout << "Usage: " << argv[0]
+                          << " [--filter <substr>] [--json] [--repetitions <n>] [--min-time-ms <n>]\n";
+                return false;
+            } else {
+                std::cerr << "Unknown argument: " << arg << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Register a benchmark; bytesPerOp enables MB/s reporting
+    void add(const std::string& name, BenchFn fn, double bytesPerOp = 0.0) {
+        benchmarks_.push_back({name, std::move(fn), bytesPerOp});
+    }
+
+    // Run all benchmarks matching the filter and print results
+    int run() {
+        std::vector<BenchResult> results;
+        if (!json_) {
+            std::cout << std::left << std::setw(48) << "Benchmark"
+                      << std::right << std::setw(14) << "ns/op"
+                      << std::setw(14) << "min"
+                      << std::setw(14) << "max"
+                      << std::setw(12) << "iters"
+                      << std::setw(12) << "MB/s" << "\n";
+            std::cout << std::string(114, '-') << "\n";
+        }
+
+        for (const auto& bench : benchmarks_) {
+            if (!filter_.empty() && bench.name.find(filter_) == std::string::npos) {
+                continue;
+            }
+            BenchResult result = measure(bench);
+            if (!json_) {
+                printRow(result);
+            }
+            results.push_back(result);
+        }
+
+        if (json_) {
+            printJson(results);
+        }
+        return 0;
+    }
+
+private:
+    struct Registered {
+        std::string name;
+        BenchFn fn;
+        double bytesPerOp;
+    };
+
+    std::vector<Registered> benchmarks_;
+    std::string filter_;
+    bool json_ = false;
+    int repetitions_ = 5;
+    int minTimeMs_ = 100;
+
+    static double timeNs(const BenchFn& fn, uint64_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        fn(iterations);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    BenchResult measure(const Registered& bench) const {
+        // Calibrate: grow the iteration count until one run is long enough
+        const double targetNs = minTimeMs_ * 1e6;
+        uint64_t iterations = 1;
+        double elapsed = timeNs(bench.fn, iterations);
+        while (elapsed < targetNs && iterations < (1ULL << 40)) {
+            double scale = elapsed > 0 ? (targetNs * 1.2) / elapsed : 10.0;
+            scale = std::min(10.0, std::max(2.0, scale));
+            iterations = static_cast<uint64_t>(iterations * scale);
+            elapsed = timeNs(bench.fn, iterations);
+        }
+
+        std::vector<double> perOp;
+        perOp.reserve(repetitions_);
+        for (int r = 0; r < repetitions_; ++r) {
+            perOp.push_back(timeNs(bench.fn, iterations) / iterations);
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        BenchResult result;
+        result.name = bench.name;
+        result.iterations = iterations;
+        result.median_ns = perOp[perOp.size() / 2];
+        result.min_ns = perOp.front();
+        result.max_ns = perOp.back();
+        result.bytes_per_op = bench.bytesPerOp;
+        return result;
+    }
+
+    static void printRow(const BenchResult& r) {
+        std::cout << std::left << std::setw(48) << r.name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << r.median_ns
+                  << std::setw(14) << r.min_ns
+                  << std::setw(14) << r.max_ns
+                  << std::setw(12) << r.iterations;
+        if (r.bytes_per_op > 0 && r.median_ns > 0) {
+            std::cout << std::setw(12) << (r.bytes_per_op / r.median_ns) * 1e9 / (1024.0 * 1024.0);
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << "\n";
+    }
+
+    static void printJson(const std::vector<BenchResult>& results) {
+        std::cout << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            std::cout << "    {\"name\": \"" << r.name << "\""
+                      << ", \"iterations\": " << r.iterations
+                      << std::fixed << std::setprecision(3)
+                      << ", \"median_ns\": " << r.median_ns
+                      << ", \"min_ns\": " << r.min_ns
+                      << ", \"max_ns\": " << r.max_ns
+                      << ", \"bytes_per_op\": " << r.bytes_per_op << "}"
+                      << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        std::cout << "  ]\n}\n";
+    }
+};
+
+} // namespace bench
+} // namespace expocli
+
+#endif // BENCH_HARNESS_H
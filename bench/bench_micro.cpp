@@ -0,0 +1,574 @@
+// Micro-benchmarks for the hot components of the query pipeline:
+// lexer, parser, navigator path search, predicate evaluation, batch kernels,
+// the raw-bytes literal prefilter, shorthand WHERE scaling, aggregates
+// (including COUNT without a DOM), ORDER BY comparator and result formatting.
+//
+// Usage: bench_micro [--filter <substr>] [--json] [--repetitions <n>] [--min-time-ms <n>]
+
+#include "bench_harness.h"
+#include "synthetic_xml.h"
+
+#include "parser/lexer.h"
+#include "parser/parser.h"
+#include "executor/query_executor.h"
+#include "executor/xml_navigator.h"
+#include "executor/region_index.h"
+#include "executor/batch_filter.h"
+#include "executor/column_batch.h"
+#include "executor/literal_prefilter.h"
+#include "executor/element_counter.h"
+#include "utils/result_formatter.h"
+#include "generator/xml_generator.h"
+#include "generator/xsd_parser.h"
+#include "validator/xml_validator.h"
+
+#include <pugixml.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef EXPOCLI_BENCH_SCHEMA
+#define EXPOCLI_BENCH_SCHEMA "bench/corpus_schema.xsd"
+#endif
+
+using namespace expocli;
+using namespace expocli::bench;
+
+namespace {
+
+const char* kSimpleQuery = "SELECT title FROM ./tests/data";
+const char* kComplexQuery =
+    "SELECT DISTINCT .title, .author, @isbn, FILE_NAME FROM ./tests/data "
+    "WHERE (.price > 10.5 AND .year >= 2000) OR (.category IN ('fiction', 'history') "
+    "AND .title LIKE /^The.*/) ORDER BY price DESC LIMIT 10 OFFSET 2";
+
+std::unique_ptr<pugi::xml_document> loadDocument(const std::string& xml) {
+    auto doc = std::make_unique<pugi::xml_document>();
+    if (!doc->load_buffer(xml.data(), xml.size())) {
+        std::cerr << "Failed to parse synthetic document" << std::endl;
+        std::exit(1);
+    }
+    return doc;
+}
+
+// Rows shaped like query results: (field, value) pairs
+std::vector<ResultRow> makeRows(size_t count, bool numericOrderKey) {
+    std::vector<ResultRow> rows;
+    rows.reserve(count);
+    uint64_t x = 88172645463325252ULL;
+    for (size_t i = 0; i < count; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        std::string key = numericOrderKey
+            ? std::to_string(x % 100000) + "." + std::to_string(x % 100)
+            : "title_" + std::to_string(x % 1000000);
+        rows.push_back({
+            {"FILE_NAME", "file" + std::to_string(i % 50) + ".xml"},
+            {"title", "Title number " + std::to_string(i)},
+            {"price", key}
+        });
+    }
+    return rows;
+}
+
+void registerLexerParser(Harness& h) {
+    for (const char* query : {kSimpleQuery, kComplexQuery}) {
+        std::string name = (query == kSimpleQuery) ? "simple" : "complex";
+        std::string text = query;
+
+        h.add("lexer/tokenize/" + name, [text](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                Lexer lexer(text);
+                auto tokens = lexer.tokenize();
+                doNotOptimize(tokens);
+            }
+        }, static_cast<double>(text.size()));
+
+        Lexer lexer(text);
+        auto tokens = lexer.tokenize();
+        h.add("parser/parse/" + name, [tokens](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                Parser parser(tokens);
+                auto ast = parser.parse();
+                doNotOptimize(ast);
+            }
+        });
+    }
+}
+
+void registerNavigator(Harness& h) {
+    struct Case { const char* label; size_t records; size_t depth; };
+    const Case cases[] = {
+        {"small_shallow", 100, 2},
+        {"large_shallow", 5000, 2},
+        {"large_deep", 5000, 12},
+    };
+
+    for (const auto& c : cases) {
+        SyntheticShape shape;
+        shape.records = c.records;
+        shape.depth = c.depth;
+        std::string xml = generateSyntheticXml(shape);
+        std::shared_ptr<pugi::xml_document> doc = loadDocument(xml);
+        double bytes = static_cast<double>(xml.size());
+
+        h.add(std::string("navigator/findNodesByPartialPath/") + c.label, [doc](uint64_t n) {
+            std::vector<std::string> path = {"record", "field1"};
+            for (uint64_t i = 0; i < n; ++i) {
+                std::vector<pugi::xml_node> results;
+                XmlNavigator::findNodesByPartialPath(*doc, path, results);
+                doNotOptimize(results);
+            }
+        }, bytes);
+
+        h.add(std::string("navigator/findFirstElementByName/") + c.label, [doc](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                auto node = XmlNavigator::findFirstElementByName(*doc, "leaf");
+                doNotOptimize(node);
+            }
+        });
+
+        h.add(std::string("navigator/regionIndex/build/") + c.label, [doc](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                RegionIndex index(*doc);
+                doNotOptimize(index);
+            }
+        }, bytes);
+
+        auto index = std::make_shared<RegionIndex>(*doc);
+        h.add(std::string("navigator/regionIndex/elementsByPartialPath/") + c.label, [doc, index](uint64_t n) {
+            std::vector<std::string> path = {"record", "field1"};
+            for (uint64_t i = 0; i < n; ++i) {
+                std::vector<pugi::xml_node> results;
+                index->elementsByPartialPath(*doc, path, results);
+                doNotOptimize(results);
+            }
+        }, bytes);
+
+        h.add(std::string("navigator/extractValues/") + c.label, [doc](uint64_t n) {
+            FieldPath field;
+            field.components = {"field3"};
+            field.is_partial_path = true;
+            for (uint64_t i = 0; i < n; ++i) {
+                auto values = XmlNavigator::extractValues(*doc, "bench.xml", field);
+                doNotOptimize(values);
+            }
+        }, bytes);
+
+        // A SELECT list of several fields on one document: the fields share
+        // one lazily built index instead of each walking the tree
+        h.add(std::string("navigator/extractValues/sharedIndex/") + c.label, [doc](uint64_t n) {
+            std::vector<FieldPath> fields(3);
+            fields[0].is_attribute = true;
+            fields[0].attribute_name = "id";
+            fields[1].components = {"record", "field1"};
+            fields[1].is_partial_path = true;
+            fields[2].components = {"record", "field3"};
+            fields[2].is_partial_path = true;
+            for (uint64_t i = 0; i < n; ++i) {
+                DocumentIndex index(*doc);
+                for (const auto& field : fields) {
+                    auto values = XmlNavigator::extractValues(*doc, "bench.xml", field, &index);
+                    doNotOptimize(values);
+                }
+            }
+        }, bytes);
+    }
+}
+
+void registerPredicates(Harness& h) {
+    struct Case { const char* label; ComparisonOp op; const char* node; const char* target; bool numeric; };
+    const Case cases[] = {
+        {"eq_string", ComparisonOp::EQUALS, "The Great Gatsby", "The Great Gatsby", false},
+        {"neq_string", ComparisonOp::NOT_EQUALS, "The Great Gatsby", "Moby Dick", false},
+        {"lt_numeric", ComparisonOp::LESS_THAN, "12.99", "20", true},
+        {"ge_numeric", ComparisonOp::GREATER_EQUAL, "1999", "2000", true},
+        {"like_regex", ComparisonOp::LIKE, "The Great Gatsby", "^The.*y$", false},
+        {"not_like_regex", ComparisonOp::NOT_LIKE, "Moby Dick", "^The.*", false},
+    };
+
+    for (const auto& c : cases) {
+        std::string node = c.node;
+        std::string target = c.target;
+        ComparisonOp op = c.op;
+        bool numeric = c.numeric;
+        h.add(std::string("predicate/compareValues/") + c.label, [=](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                bool r = XmlNavigator::compareValues(node, target, op, numeric);
+                doNotOptimize(r);
+            }
+        });
+    }
+
+    // Full WHERE evaluation against record nodes
+    SyntheticShape shape;
+    shape.records = 1000;
+    std::shared_ptr<pugi::xml_document> doc = loadDocument(generateSyntheticXml(shape));
+    Lexer lexer("SELECT field1 FROM ./x WHERE record.field0 > 50000 AND record.field1 != 'abc'");
+    std::shared_ptr<Query> query(Parser(lexer.tokenize()).parse().release());
+    std::vector<pugi::xml_node> records;
+    XmlNavigator::findNodesByPartialPath(*doc, {"record"}, records);
+
+    h.add("predicate/evaluateWhereExpr/1000_records", [doc, query, records](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            size_t matches = 0;
+            for (const auto& node : records) {
+                if (XmlNavigator::evaluateWhereExpr(node, query->where.get(), 1)) {
+                    ++matches;
+                }
+            }
+            doNotOptimize(matches);
+        }
+    });
+
+    // A numeric WHERE node by node, then as batch kernels over the same records
+    Lexer numericLexer("SELECT field1 FROM ./x WHERE (record.field0 > 50000 AND record.field2 <= 70000) "
+                       "OR record.field4 IN (1, 2, 3)");
+    std::shared_ptr<Query> numericQuery(Parser(numericLexer.tokenize()).parse().release());
+    std::shared_ptr<BatchFilter> filter(BatchFilter::compile(numericQuery->where.get()).release());
+
+    h.add("predicate/numericWhere/perNode/1000_records", [doc, numericQuery, records](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            size_t matches = 0;
+            for (const auto& node : records) {
+                if (XmlNavigator::evaluateWhereExpr(node, numericQuery->where.get(), 1)) {
+                    ++matches;
+                }
+            }
+            doNotOptimize(matches);
+        }
+    });
+    std::vector<bool> modes = {false};
+    if (BatchKernels::avx2Available()) {
+        modes.push_back(true);
+    }
+    for (bool avx2 : modes) {
+        h.add(std::string("predicate/numericWhere/batch_") + (avx2 ? "avx2" : "scalar") + "/1000_records",
+            [doc, filter, records, avx2](uint64_t n) {
+                BatchKernels::setAvx2(avx2);
+                for (uint64_t i = 0; i < n; ++i) {
+                    std::vector<uint32_t> selection;
+                    filter->filter(records, 1, selection);
+                    doNotOptimize(selection);
+                }
+                BatchKernels::setAvx2(true);
+            });
+    }
+}
+
+// The batch kernels on one full batch, scalar and AVX2 (where available)
+void registerBatchKernels(Harness& h) {
+    auto batch = std::make_shared<ColumnBatch>();
+    uint64_t x = 88172645463325252ULL;
+    while (!batch->full()) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        batch->append(x % 10 == 0 ? std::string("n/a") : std::to_string(x % 100000) + "." + std::to_string(x % 100));
+    }
+    double bytes = static_cast<double>(sizeof(batch->values));
+
+    h.add("batch/append/1024", [](uint64_t n) {
+        ColumnBatch local;
+        for (uint64_t i = 0; i < n; ++i) {
+            local.clear();
+            while (!local.full()) {
+                local.append("12345.67");
+            }
+            doNotOptimize(local.size);
+        }
+    });
+
+    std::vector<bool> modes = {false};
+    if (BatchKernels::avx2Available()) {
+        modes.push_back(true);
+    }
+    for (bool avx2 : modes) {
+        std::string suffix = avx2 ? "/avx2" : "/scalar";
+        h.add("batch/compare" + suffix, [batch, avx2](uint64_t n) {
+            BatchKernels::setAvx2(avx2);
+            uint64_t mask[kBatchWords];
+            for (uint64_t i = 0; i < n; ++i) {
+                BatchKernels::compare(*batch, ComparisonOp::GREATER_THAN, 50000.0, mask);
+                doNotOptimize(mask[0]);
+            }
+            BatchKernels::setAvx2(true);
+        }, bytes);
+        h.add("batch/in" + suffix, [batch, avx2](uint64_t n) {
+            BatchKernels::setAvx2(avx2);
+            std::vector<double> set = {10.0, 20.0, 30.0, 40.0};
+            uint64_t mask[kBatchWords];
+            for (uint64_t i = 0; i < n; ++i) {
+                BatchKernels::in(*batch, set, mask);
+                doNotOptimize(mask[0]);
+            }
+            BatchKernels::setAvx2(true);
+        }, bytes);
+        h.add("batch/accumulate" + suffix, [batch, avx2](uint64_t n) {
+            BatchKernels::setAvx2(avx2);
+            for (uint64_t i = 0; i < n; ++i) {
+                BatchSummary summary;
+                BatchKernels::accumulate(*batch, nullptr, summary);
+                doNotOptimize(summary.sum);
+            }
+            BatchKernels::setAvx2(true);
+        }, bytes);
+    }
+}
+
+// Scanning raw bytes for a literal that is not there, and a selective
+// equality over files of which one matches: with the prefilter the others
+// are never parsed, while the equivalent range comparison parses them all.
+void registerPrefilter(Harness& h) {
+    auto xml = std::make_shared<std::string>(generateSyntheticXmlOfSize(1 << 20));
+    double bytes = static_cast<double>(xml->size());
+
+    std::vector<bool> modes = {false};
+    if (BatchKernels::avx2Available()) {
+        modes.push_back(true);
+    }
+    for (bool avx2 : modes) {
+        h.add(std::string("prefilter/contains/") + (avx2 ? "avx2" : "scalar") + "/1MB", [xml, avx2](uint64_t n) {
+            BatchKernels::setAvx2(avx2);
+            for (uint64_t i = 0; i < n; ++i) {
+                bool found = LiteralPrefilter::contains(xml->data(), xml->size(), "C-99812");
+                doNotOptimize(found);
+            }
+            BatchKernels::setAvx2(true);
+        }, bytes);
+    }
+
+    // Enough alternatives for the Aho-Corasick pass
+    std::string values;
+    for (int i = 0; i < 32; ++i) {
+        values += std::string(i ? ", " : "") + "\"C-" + std::to_string(99800 + i) + "\"";
+    }
+    Lexer inLexer("SELECT field1 FROM \"x.xml\" WHERE field1 IN (" + values + ")");
+    std::shared_ptr<Query> inQuery(Parser(inLexer.tokenize()).parse().release());
+    std::shared_ptr<LiteralPrefilter> manyLiterals(LiteralPrefilter::compile(*inQuery).release());
+    h.add("prefilter/mayMatch/32_literals/1MB", [xml, manyLiterals](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            bool match = manyLiterals->mayMatch(xml->data(), xml->size());
+            doNotOptimize(match);
+        }
+    }, bytes);
+
+    // 20 files of ~100 KB; the literal is a field1 value of the first
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "expocli_bench_prefilter";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    std::string literal;
+    double totalBytes = 0;
+    for (int f = 0; f < 20; ++f) {
+        SyntheticShape shape;
+        shape.seed = 1000 + f;
+        std::string file = generateSyntheticXmlOfSize(100 << 10, shape);
+        if (f == 0) {
+            size_t start = file.find("<field1>") + 8;
+            literal = file.substr(start, file.find('<', start) - start);
+        }
+        std::string path = (dir / ("file_" + std::to_string(f) + ".xml")).string();
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) {
+            std::cerr << "Skipping prefilter query benchmarks: cannot write " << path << std::endl;
+            return;
+        }
+        std::fwrite(file.data(), 1, file.size(), out);
+        std::fclose(out);
+        totalBytes += static_cast<double>(file.size());
+    }
+
+    const std::pair<const char*, std::string> wheres[] = {
+        {"range", "field1 >= \"" + literal + "\" AND field1 <= \"" + literal + "\""},
+        {"equality", "field1 = \"" + literal + "\""},
+    };
+    for (const auto& [label, where] : wheres) {
+        Lexer lexer("SELECT field0 FROM \"" + dir.string() + "\" WHERE " + where);
+        std::shared_ptr<Query> query(Parser(lexer.tokenize()).parse().release());
+        h.add(std::string("query/selectiveWhere/") + label + "/20_files", [query](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                auto rows = QueryExecutor::execute(*query);
+                doNotOptimize(rows);
+            }
+        }, totalBytes);
+    }
+}
+
+// Shorthand WHERE (a one-component field) on documents of growing depth.
+// Time per op should grow with the document, so MB/s stays flat: the
+// evaluator visits each element once whatever the nesting.
+void registerShorthandWhere(Harness& h) {
+    const size_t depths[] = {16, 64, 256, 1024};
+
+    for (size_t depth : depths) {
+        SyntheticShape shape;
+        shape.records = 50;
+        shape.depth = depth;
+        std::string xml = generateSyntheticXml(shape);
+        std::string path = (std::filesystem::temp_directory_path() /
+                            ("expocli_bench_where_" + std::to_string(depth) + ".xml")).string();
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) {
+            std::cerr << "Skipping shorthand WHERE benchmarks: cannot write " << path << std::endl;
+            return;
+        }
+        std::fwrite(xml.data(), 1, xml.size(), out);
+        std::fclose(out);
+
+        Lexer lexer("SELECT field1 FROM \"" + path + "\" WHERE field0 < 10000");
+        std::shared_ptr<Query> query(Parser(lexer.tokenize()).parse().release());
+        h.add("query/shorthandWhere/depth_" + std::to_string(depth), [query](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                auto rows = QueryExecutor::execute(*query);
+                doNotOptimize(rows);
+            }
+        }, static_cast<double>(xml.size()));
+    }
+}
+
+void registerAggregatesAndSort(Harness& h) {
+    for (size_t count : {1000u, 100000u}) {
+        std::string suffix = "/" + std::to_string(count);
+        auto rows = std::make_shared<std::vector<ResultRow>>(makeRows(count, true));
+
+        for (auto func : {AggregateFunc::COUNT, AggregateFunc::SUM, AggregateFunc::MAX}) {
+            FieldPath field;
+            field.components = {"price"};
+            field.aggregate = func;
+            const char* label = func == AggregateFunc::COUNT ? "count"
+                              : func == AggregateFunc::SUM ? "sum" : "max";
+            h.add(std::string("aggregate/") + label + suffix, [rows, field](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    auto value = QueryExecutor::computeAggregate(field, *rows);
+                    doNotOptimize(value);
+                }
+            });
+        }
+
+    }
+
+    // COUNT of an element over a 1 MB document: through the DOM (parse and
+    // extract, as the executor falls back to) and from the raw bytes
+    auto xml = std::make_shared<std::string>(generateSyntheticXmlOfSize(1 << 20));
+    double bytes = static_cast<double>(xml->size());
+    FieldPath counted;
+    counted.components = {"field1"};
+    counted.is_partial_path = true;
+    h.add("aggregate/countElements/dom/1MB", [xml, counted](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            pugi::xml_document doc;
+            doc.load_buffer(xml->data(), xml->size());
+            size_t count = XmlNavigator::extractValues(doc, "bench.xml", counted).size();
+            doNotOptimize(count);
+        }
+    }, bytes);
+    std::shared_ptr<ElementCounter> counter(ElementCounter::compile(counted).release());
+    h.add("aggregate/countElements/scan/1MB", [xml, counter](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            size_t count = 0;
+            counter->count(xml->data(), xml->size(), count);
+            doNotOptimize(count);
+        }
+    }, bytes);
+
+    // String keys take the exception path in the comparator, so keep sizes modest
+    for (size_t count : {1000u, 10000u}) {
+        for (bool numeric : {true, false}) {
+            auto source = std::make_shared<std::vector<ResultRow>>(makeRows(count, numeric));
+            h.add(std::string("orderby/") + (numeric ? "numeric" : "string") + "/" + std::to_string(count),
+                [source](uint64_t n) {
+                    for (uint64_t i = 0; i < n; ++i) {
+                        auto sorted = *source;
+                        std::sort(sorted.begin(), sorted.end(),
+                            [](const ResultRow& a, const ResultRow& b) {
+                                return QueryExecutor::compareRows(a, b, "price", false);
+                            });
+                        doNotOptimize(sorted);
+                    }
+                });
+        }
+    }
+}
+
+void registerFormatter(Harness& h) {
+    for (size_t count : {100u, 10000u}) {
+        auto rows = std::make_shared<std::vector<ResultRow>>(makeRows(count, true));
+        h.add("formatter/formatAsText/" + std::to_string(count), [rows](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                auto text = ResultFormatter::formatAsText(*rows);
+                doNotOptimize(text);
+            }
+        });
+    }
+}
+
+// Validation cost relative to parsing the same document
+void registerValidator(Harness& h) {
+    std::shared_ptr<XsdSchema> schema;
+    try {
+        schema = XsdParser::parse(EXPOCLI_BENCH_SCHEMA);
+    } catch (const std::exception& e) {
+        std::cerr << "Skipping validator benchmarks: " << e.what() << std::endl;
+        return;
+    }
+
+    // One document of ~1 MB built from many generated records
+    std::string path = (std::filesystem::temp_directory_path() / "expocli_bench_validate.xml").string();
+    {
+        XmlGenerator generator;
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) {
+            std::cerr << "Skipping validator benchmarks: cannot write " << path << std::endl;
+            return;
+        }
+        generator.writeDocument(*schema, out, 1 << 20);
+        std::fclose(out);
+    }
+    double bytes = static_cast<double>(std::filesystem::file_size(path));
+    std::shared_ptr<CompiledSchema> compiled = CompiledSchema::compile(*schema);
+
+    h.add("validator/compileSchema", [schema](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            auto result = CompiledSchema::compile(*schema);
+            doNotOptimize(result);
+        }
+    });
+
+    h.add("validator/parseOnly", [path](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            pugi::xml_document doc;
+            auto result = doc.load_file(path.c_str());
+            doNotOptimize(result);
+        }
+    }, bytes);
+
+    h.add("validator/validateFile", [path, compiled](uint64_t n) {
+        XmlValidator validator;
+        for (uint64_t i = 0; i < n; ++i) {
+            auto result = validator.validateFile(path, *compiled);
+            doNotOptimize(result);
+        }
+    }, bytes);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Harness harness;
+    if (!harness.parseArgs(argc, argv)) {
+        return 1;
+    }
+
+    registerLexerParser(harness);
+    registerNavigator(harness);
+    registerPredicates(harness);
+    registerBatchKernels(harness);
+    registerPrefilter(harness);
+    registerShorthandWhere(harness);
+    registerAggregatesAndSort(harness);
+    registerFormatter(harness);
+    registerValidator(harness);
+
+    return harness.run();
+}
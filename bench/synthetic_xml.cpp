@@ -0,0 +1,77 @@
+#include "synthetic_xml.h"
+
+namespace expocli {
+namespace bench {
+
+namespace {
+
+// Small deterministic generator so output does not depend on the standard library
+struct SplitMix64 {
+    uint64_t state;
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+void appendValue(std::string& out, SplitMix64& rng, size_t length, bool numeric) {
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+    if (numeric) {
+        out += std::to_string(rng.next() % 100000);
+        return;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        out += letters[rng.next() % 26];
+    }
+}
+
+} // anonymous namespace
+
+std::string generateSyntheticXml(const SyntheticShape& shape) {
+    SplitMix64 rng(shape.seed);
+    std::string out;
+    out.reserve(shape.records * (shape.width * (shape.valueLength + 20) + shape.depth * 13 + 64));
+
+    out += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<root>\n";
+    for (size_t r = 0; r < shape.records; ++r) {
+        out += "  <record id=\"";
+        out += std::to_string(r);
+        out += "\">\n";
+
+        // Even fields are numeric, odd fields are text
+        for (size_t f = 0; f < shape.width; ++f) {
+            std::string tag = "field" + std::to_string(f);
+            out += "    <" + tag + ">";
+            appendValue(out, rng, shape.valueLength, f % 2 == 0);
+            out += "</" + tag + ">\n";
+        }
+
+        for (size_t d = 0; d < shape.depth; ++d) {
+            out += "<nest>";
+        }
+        out += "<leaf>";
+        appendValue(out, rng, shape.valueLength, false);
+        out += "</leaf>";
+        for (size_t d = 0; d < shape.depth; ++d) {
+            out += "</nest>";
+        }
+        out += "\n  </record>\n";
+    }
+    out += "</root>\n";
+    return out;
+}
+
+std::string generateSyntheticXmlOfSize(size_t targetBytes, SyntheticShape shape) {
+    // Measure one record and scale the record count to hit the target
+    SyntheticShape probe = shape;
+    probe.records = 1;
+    size_t perRecord = generateSyntheticXml(probe).size();
+    shape.records = perRecord > 0 ? (targetBytes / perRecord) + 1 : 1;
+    return generateSyntheticXml(shape);
+}
+
+} // namespace bench
+} // namespace expocli
@@ -0,0 +1,30 @@
+#ifndef SYNTHETIC_XML_H
+#define SYNTHETIC_XML_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace expocli {
+namespace bench {
+
+// Shape of a deterministic synthetic document:
+//   <root><record id=".."><field0>..</field0>...<nest><nest>...<leaf>..</leaf></nest></nest></record>...</root>
+struct SyntheticShape {
+    size_t records = 1000;   // Number of <record> children under the root
+    size_t width = 8;        // Number of <fieldN> leaf children per record
+    size_t depth = 3;        // Nesting depth of the <nest> chain ending in <leaf>
+    size_t valueLength = 12; // Length of each text value
+    uint64_t seed = 42;      // Seed for value generation (same seed, same bytes)
+};
+
+// Generate a document with the given shape
+std::string generateSyntheticXml(const SyntheticShape& shape);
+
+// Generate a document of roughly `targetBytes` by adjusting the record count
+std::string generateSyntheticXmlOfSize(size_t targetBytes, SyntheticShape shape = SyntheticShape());
+
+} // namespace bench
+} // namespace expocli
+
+#endif // SYNTHETIC_XML_H
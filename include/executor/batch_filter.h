@@ -0,0 +1,47 @@
+#ifndef BATCH_FILTER_H
+#define BATCH_FILTER_H
+
+#include "parser/ast.h"
+#include "executor/column_batch.h"
+#include <pugixml.hpp>
+#include <memory>
+#include <vector>
+
+namespace expocli {
+
+// A WHERE expression evaluated over candidate nodes a batch at a time
+// instead of node by node.
+//
+// Applies when every condition is a numeric comparison or an IN / NOT IN
+// list of numbers, combined with AND and OR. For each batch, the values of
+// each condition's field are gathered into a column batch, the condition
+// runs as a kernel over it, and the resulting bitmaps are combined; the set
+// bits are the selection vector handed back to the caller for projection.
+// IN lists are matched numerically first and the hits confirmed as text, so
+// results are exactly those of XmlNavigator::evaluateWhereExpr.
+class BatchFilter {
+public:
+    // nullptr if some condition needs node-by-node evaluation
+    static std::unique_ptr<BatchFilter> compile(const WhereExpr* expr);
+
+    // Indices into nodes of those that satisfy the expression, in order.
+    // parentDepth is as for XmlNavigator::evaluateWhereExpr.
+    void filter(const std::vector<pugi::xml_node>& nodes, size_t parentDepth,
+                std::vector<uint32_t>& selection) const;
+
+private:
+    // The expression in postfix order
+    struct Step {
+        enum Kind { COMPARE, IN, NOT_IN, AND, OR } kind;
+        const WhereCondition* condition = nullptr;
+        double literal = 0;
+        std::vector<double> set;
+    };
+    std::vector<Step> program_;
+
+    bool append(const WhereExpr* expr);
+};
+
+} // namespace expocli
+
+#endif // BATCH_FILTER_H
@@ -0,0 +1,77 @@
+#ifndef COLUMN_BATCH_H
+#define COLUMN_BATCH_H
+
+#include "parser/ast.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace expocli {
+
+// Values per batch, and 64-bit words in a bitmap covering one batch
+constexpr size_t kBatchSize = 1024;
+constexpr size_t kBatchWords = kBatchSize / 64;
+
+// One column of up to kBatchSize numbers gathered from text values. Bit i
+// of valid is set when the text at row i parsed as a number (with the rules
+// of std::stod); present marks the rows whose text was not empty.
+struct ColumnBatch {
+    alignas(32) double values[kBatchSize];
+    uint64_t valid[kBatchWords];
+    uint64_t present[kBatchWords];
+    size_t size = 0;
+
+    // Rows past size are still read by the vector kernels (and masked off),
+    // so values starts out initialised
+    ColumnBatch() : values{} { clear(); }
+
+    void clear();
+    bool full() const { return size == kBatchSize; }
+
+    void append(const char* text);
+    void append(const std::string& text) { append(text.c_str()); }
+};
+
+// Running totals over the selected, valid rows of column batches
+struct BatchSummary {
+    size_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+};
+
+// Kernels over column batches. Comparisons and IN tests write a bitmap of
+// the rows that pass (only valid rows can pass); aggregates fold the rows of
+// a bitmap into a summary. Each kernel has an AVX2 version, used when the
+// CPU supports it, and a scalar version that gives identical results
+// (sums are accumulated in four lanes either way).
+class BatchKernels {
+public:
+    static bool avx2Available();
+
+    // Select the AVX2 kernels (if available) or the scalar ones; for
+    // benchmarks and comparisons
+    static void setAvx2(bool enabled);
+    static bool usingAvx2();
+
+    // out = valid rows where value <op> literal (the six comparison operators)
+    static void compare(const ColumnBatch& batch, ComparisonOp op, double literal, uint64_t* out);
+
+    // out = valid rows whose value equals one of set
+    static void in(const ColumnBatch& batch, const std::vector<double>& set, uint64_t* out);
+
+    // Fold the valid rows selected by selection (all rows if null) into summary
+    static void accumulate(const ColumnBatch& batch, const uint64_t* selection, BatchSummary& summary);
+
+    // Indices of the set bits of mask among the first size rows, plus base
+    static void select(const uint64_t* mask, size_t size, uint32_t base, std::vector<uint32_t>& indices);
+
+    // Parse text as std::stod would, without exceptions; false if it does not
+    // start with a number or is out of range
+    static bool parseNumber(const char* text, double& value);
+};
+
+} // namespace expocli
+
+#endif // COLUMN_BATCH_H
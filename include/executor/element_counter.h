@@ -0,0 +1,41 @@
+#ifndef ELEMENT_COUNTER_H
+#define ELEMENT_COUNTER_H
+
+#include "parser/ast.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace expocli {
+
+// COUNT of one element path computed from the raw bytes of a document,
+// without building a DOM.
+//
+// Start and end tags are followed on a stack of names (comments, CDATA
+// sections and processing instructions are stepped over), so each element
+// is matched against the path as it opens. Like COUNT on the DOM, an element
+// counts when its first text child is not empty: text that is not all
+// whitespace, or a non-empty CDATA section.
+//
+// Anything the scanner does not follow exactly (a DOCTYPE, a non-UTF-8
+// encoding, markup that is not well-formed) and a partial path found at more
+// than one location make count() return false: the caller then uses the DOM,
+// which gives the same count or reports the error.
+class ElementCounter {
+public:
+    // nullptr unless field is an element path the scanner can match
+    // (as extracted for COUNT: no attribute, FILE_NAME or variable)
+    static std::unique_ptr<ElementCounter> compile(const FieldPath& field);
+
+    // Number of matching elements with a value; false if the DOM is needed
+    bool count(const char* data, size_t size, size_t& result) const;
+
+private:
+    std::vector<std::string> path_;
+    bool partial_ = false;
+};
+
+} // namespace expocli
+
+#endif // ELEMENT_COUNTER_H
@@ -0,0 +1,94 @@
+#ifndef INCREMENTAL_STATE_H
+#define INCREMENTAL_STATE_H
+
+#include "executor/query_executor.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace expocli {
+
+// What one query has read of XML files that grow by records appended to
+// their root element (--incremental <file>), so that a rerun parses only the
+// records added since.
+//
+// For each file the state keeps the bytes up to the end of the root start
+// tag, the offset just past the last complete top-level record, the bytes
+// just before that offset, and the rows its records produced. A later run
+// that finds the same leading and trailing bytes reads the file from the
+// offset on and parses the complete records there inside the saved root
+// start tag, so the cost follows the new data. Files are taken to grow only
+// by appending: one whose leading or trailing bytes differ (rewritten), or
+// that has no state yet, is read in full, and a file still being written
+// (its root not yet closed) is read up to its last complete record.
+//
+// The state belongs to one query text and starts over for another. Only
+// queries whose rows come from each record on its own can use it: FOR
+// clauses (per-document GROUP BY and aggregates) and VALIDATE AGAINST
+// (whole-document checks) are excluded, see supports(). Thread-safe.
+class IncrementalState {
+public:
+    // Bytes kept from before the offset to recognise an append
+    static constexpr size_t kTailBytes = 64;
+
+    // A file as it was last processed
+    struct FileState {
+        std::string header;      // Bytes through the root start tag
+        std::string root;        // Root element name
+        uint64_t offset = 0;     // Just past the last complete record
+        std::string tail;        // Up to kTailBytes bytes before offset
+        std::vector<ResultRow> rows;
+    };
+
+    // What to parse of a file now
+    struct Delta {
+        std::vector<ResultRow> rows;   // Produced by the records read before
+        std::string bytes;             // Document to parse (empty: nothing new)
+        uint64_t scanned = 0;          // Bytes read from the file
+        bool resumable = false;        // Records were found: the file can be recorded
+        FileState next;                // State once the new records are processed
+    };
+
+    IncrementalState(const std::string& path, const std::string& queryText);
+
+    IncrementalState(const IncrementalState&) = delete;
+    IncrementalState& operator=(const IncrementalState&) = delete;
+
+    static bool supports(const Query& query);
+
+    // Read what was appended to the file since it was recorded, or all of it
+    Delta read(const std::string& file);
+
+    // Record the file once all of its rows (earlier and new) are known
+    void commit(const std::string& file, const Delta& delta, const std::vector<ResultRow>& rows);
+
+    // Write the state back (files that no longer exist are dropped); throws
+    // std::runtime_error if the file cannot be written
+    void save();
+
+    size_t appendedFiles() const { return appended_; }
+    size_t fullFiles() const { return full_; }
+    uint64_t bytesRead() const { return bytesRead_; }
+
+private:
+    std::string path_;
+    std::string query_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, FileState> files_;
+
+    std::atomic<size_t> appended_{0};
+    std::atomic<size_t> full_{0};
+    std::atomic<uint64_t> bytesRead_{0};
+
+    void load();
+    // Delta from the recorded state; false if the file was not only appended to
+    bool readAppended(const std::string& file, const FileState& state, Delta& delta) const;
+};
+
+} // namespace expocli
+
+#endif // INCREMENTAL_STATE_H
@@ -0,0 +1,66 @@
+#ifndef LITERAL_PREFILTER_H
+#define LITERAL_PREFILTER_H
+
+#include "parser/ast.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace expocli {
+
+// A test on the raw bytes of a file, run before it is parsed, that rules out
+// files in which the WHERE clause cannot hold.
+//
+// String equalities and IN lists require their literal to appear in the
+// file; the WHERE clause as a whole requires an AND of such alternatives
+// (e.g. `a = 'x' AND b IN ('y', 'z')` needs "x" and one of "y", "z"). The
+// text of a value can differ from its bytes on disk: the predefined entities
+// (&amp; ...) stand for & < > " ', whitespace is normalised, and non-ASCII
+// text may be in another encoding. So each literal is cut down to its
+// longest run of plain ASCII characters, which the file must contain
+// verbatim. Files using character references, DTD entities, or a UTF-16/32
+// encoding are always parsed.
+//
+// Up to kDirectPatterns literals are searched for one at a time (with AVX2
+// when BatchKernels uses it); more are matched together in a single
+// Aho-Corasick pass.
+class LiteralPrefilter {
+public:
+    static constexpr size_t kDirectPatterns = 8;
+
+    // nullptr if the WHERE clause requires no literal (or the query must see
+    // every document, as VALIDATE AGAINST does)
+    static std::unique_ptr<LiteralPrefilter> compile(const Query& query);
+
+    // False only if no document with these bytes can satisfy the WHERE clause
+    bool mayMatch(const char* data, size_t size) const;
+
+    // True if pattern occurs in data (exposed for benchmarks)
+    static bool contains(const char* data, size_t size, const std::string& pattern);
+
+private:
+    // AND of ORs of indices into patterns_
+    std::vector<std::vector<uint32_t>> clauses_;
+    std::vector<std::string> patterns_;
+
+    // Aho-Corasick automaton over byte classes, when there are many patterns
+    struct Automaton {
+        uint8_t classOf[256] = {};
+        uint32_t classCount = 1;
+        std::vector<uint32_t> next;                   // state * classCount + class
+        std::vector<std::vector<uint32_t>> output;    // patterns ending at each state
+        std::vector<char> accepting;                  // output not empty
+        std::vector<std::vector<uint32_t>> clausesOf; // clauses each pattern satisfies
+        bool starts[256] = {};                        // bytes leaving the start state
+    };
+    std::unique_ptr<Automaton> automaton_;
+
+    bool clausesHold(const char* data, size_t size) const;
+    void buildAutomaton();
+};
+
+} // namespace expocli
+
+#endif // LITERAL_PREFILTER_H
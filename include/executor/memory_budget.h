@@ -0,0 +1,63 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <cstdint>
+#include <string>
+
+namespace expocli {
+
+// Admission control for the memory documents take while they are queried.
+//
+// Before loading a file, a worker reserves what the file is expected to take
+// in memory: its size times an expansion factor measured once by parsing and
+// indexing a sample document. A reservation waits (first come, first served)
+// until it fits next to those in flight, so the bytes in flight stay under
+// the limit and extra workers simply wait instead of growing the heap. A file
+// whose estimate exceeds the whole budget is admitted alone once nothing
+// else is in flight, so it is processed rather than blocking forever.
+//
+// Process-wide, set by --max-memory and SET MEMORY; 0 means no limit.
+class MemoryBudget {
+public:
+    static void setLimit(uint64_t bytes);
+    static uint64_t limit();
+
+    // <n>[B|KB|MB|GB|TB] (powers of 1024; bytes without a unit), e.g. 512MB
+    static bool parseSize(const std::string& text, uint64_t& bytes);
+
+    // Bytes in memory per byte of file for a parsed and indexed document
+    static double expansionFactor();
+
+    // Expected bytes in memory for a file of fileBytes
+    static uint64_t estimate(uint64_t fileBytes);
+
+    // Bytes held until destroyed
+    class Reservation {
+    public:
+        Reservation() = default;
+        Reservation(Reservation&& other) noexcept : bytes_(other.bytes_) { other.bytes_ = 0; }
+        Reservation& operator=(Reservation&& other) noexcept;
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+        ~Reservation() { release(); }
+
+        uint64_t bytes() const { return bytes_; }
+        void release();
+
+    private:
+        friend class MemoryBudget;
+        explicit Reservation(uint64_t bytes) : bytes_(bytes) {}
+        uint64_t bytes_ = 0;
+    };
+
+    // Waits until bytes can be admitted; a no-op without a limit
+    static Reservation reserve(uint64_t bytes);
+
+    // Most bytes reserved at once since the last reset
+    static uint64_t peak();
+    static void resetPeak();
+};
+
+} // namespace expocli
+
+#endif // MEMORY_BUDGET_H
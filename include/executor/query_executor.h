@@ -3,39 +3,103 @@
 
 #include "parser/ast.h"
 #include "executor/xml_navigator.h"
+#include "executor/region_index.h"
+#include "executor/literal_prefilter.h"
+#include "executor/query_guard.h"
 #include <vector>
 #include <string>
 #include <utility>
 #include <atomic>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <cstdint>
+#include <stdexcept>
 
 namespace expocli {
 
+class ScanCheckpoint;
+class IncrementalState;
+
+// Raised when a document fails VALIDATE AGAINST ... FAIL; aborts the query
+class DocumentValidationError : public std::runtime_error {
+public:
+    explicit DocumentValidationError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
 // Result row (multiple fields) - using vector to preserve field order
 using ResultRow = std::vector<std::pair<std::string, std::string>>;
 
 // Progress callback: (completed_files, total_files, thread_count)
 using ProgressCallback = std::function<void(size_t, size_t, size_t)>;
 
+// Cost of one file during execution (slow query log attribution)
+struct FileCost {
+    std::string path;
+    uintmax_t bytes = 0;
+    double parse_ms = 0.0;   // Loading and parsing the document
+    double eval_ms = 0.0;    // Evaluating the query against the document
+    size_t rows = 0;
+};
+
+// Duration of a named execution stage
+struct StageTiming {
+    std::string name;
+    double ms = 0.0;
+};
+
 // Execution statistics
 struct ExecutionStats {
     size_t total_files = 0;
     size_t thread_count = 0;
     double execution_time_seconds = 0.0;
     bool used_threading = false;
+    size_t result_rows = 0;
+    size_t invalid_files = 0;          // Documents skipped by VALIDATE AGAINST ... SKIP INVALID
+    std::string limit_reached;         // Limit that cut a partial result short (empty if none)
+    size_t resumed_files = 0;          // Files a checkpoint showed were already scanned
+
+    // Execution strategy and stage breakdown (always filled)
+    std::string plan;
+    std::vector<StageTiming> stages;
+
+    // Per-file cost attribution, collected only when top_files_limit > 0
+    size_t top_files_limit = 0;
+    std::vector<FileCost> top_files;   // Most expensive files (parse + eval), descending
+    double total_parse_ms = 0.0;
+    double total_eval_ms = 0.0;
+
+    bool collectFileCosts() const { return top_files_limit > 0; }
+
+    // Keep the file if it is among the top_files_limit most expensive (not thread-safe)
+    void recordFileCost(const FileCost& cost);
+
+    // Sort top_files by descending cost once execution is complete
+    void finalizeFileCosts();
 };
 
 class QueryExecutor {
 public:
-    // Execute the query and return results
-    static std::vector<ResultRow> execute(const Query& query);
+    // Execute the query and return results (optionally filling execution stats);
+    // throws QueryLimitExceeded when a limit is hit, unless limits.partial.
+    // With a checkpoint, files it records as done are skipped and their
+    // saved rows used, and each file is recorded as it completes. With an
+    // incremental state (for queries it supports), only the records appended
+    // to a file since it was recorded are parsed.
+    static std::vector<ResultRow> execute(const Query& query, ExecutionStats* stats = nullptr,
+                                          const QueryLimits& limits = QueryLimits(),
+                                          ScanCheckpoint* checkpoint = nullptr,
+                                          IncrementalState* incremental = nullptr);
 
     // Execute with progress tracking (for VERBOSE mode)
     static std::vector<ResultRow> executeWithProgress(
         const Query& query,
         ProgressCallback progressCallback,
-        ExecutionStats* stats = nullptr
+        ExecutionStats* stats = nullptr,
+        const QueryLimits& limits = QueryLimits(),
+        ScanCheckpoint* checkpoint = nullptr,
+        IncrementalState* incremental = nullptr
     );
 
     // Validate query for ambiguous attributes (used in VERBOSE mode)
@@ -48,14 +112,73 @@ public:
     // Calculate if threading should be used based on file count and estimated work
     static bool shouldUseThreading(size_t fileCount);
 
+    // ORDER BY comparator: chronological when both values are ISO-8601 dates or
+    // date-times, numeric when both parse as numbers, else string
+    // (strict weak ordering, shared by execute() and executeWithProgress())
+    static bool compareRows(
+        const ResultRow& a,
+        const ResultRow& b,
+        const std::string& orderField,
+        bool descending
+    );
+
+    // Compute aggregate function value
+    static std::string computeAggregate(const FieldPath& field, const std::vector<ResultRow>& allResults);
+
+    // Describe the execution strategy chosen for a query (slow query log, VERBOSE)
+    static std::string describePlan(const Query& query);
+
 private:
     // Get all XML files from directory
     static std::vector<std::string> getXmlFiles(const std::string& path);
 
-    // Process a single XML file
+    // Process a single XML file (cost, if given, receives size and parse time;
+    // invalid, if given, is set when VALIDATE AGAINST skipped the document;
+    // a file whose bytes the prefilter rules out is not parsed; nothing is
+    // read once guard has stopped the query; with incremental, see
+    // processAppended)
     static std::vector<ResultRow> processFile(
         const std::string& filepath,
-        const Query& query
+        const Query& query,
+        FileCost* cost = nullptr,
+        bool* invalid = nullptr,
+        const LiteralPrefilter* prefilter = nullptr,
+        QueryGuard* guard = nullptr,
+        IncrementalState* incremental = nullptr
+    );
+
+    // Process only the records appended to a file since incremental recorded
+    // it, returning them after the rows recorded before
+    static std::vector<ResultRow> processAppended(
+        const std::string& filepath,
+        const Query& query,
+        FileCost* cost,
+        bool* invalid,
+        const LiteralPrefilter* prefilter,
+        QueryGuard* guard,
+        IncrementalState& incremental
+    );
+
+    // Evaluate the query against a parsed document (processFile after loading)
+    static std::vector<ResultRow> processDocument(
+        const std::string& filepath,
+        const Query& query,
+        const pugi::xml_document& doc,
+        bool* invalid = nullptr,
+        QueryGuard* guard = nullptr
+    );
+
+    // Process a file, attributing its cost to stats when collection is enabled
+    // (statsMutex guards stats when called from worker threads) and its rows
+    // to guard
+    static std::vector<ResultRow> processFileTracked(
+        const std::string& filepath,
+        const Query& query,
+        ExecutionStats* stats,
+        std::mutex* statsMutex = nullptr,
+        const LiteralPrefilter* prefilter = nullptr,
+        QueryGuard* guard = nullptr,
+        IncrementalState* incremental = nullptr
     );
 
     // Process a single XML file with FOR clause context binding
@@ -63,23 +186,44 @@ private:
         const std::string& filepath,
         const Query& query,
         const pugi::xml_document& doc,
-        const std::string& filename
+        const DocumentIndex& documentIndex,
+        const std::string& filename,
+        QueryGuard* guard = nullptr
+    );
+
+    // Partial aggregates of one file's FOR bindings, one row per GROUP BY
+    // group: its __GROUP_BY__ values, then each aggregate's count, sum, min
+    // and max so far encoded as the field value
+    static std::vector<ResultRow> partialForAggregates(
+        const Query& query,
+        const std::vector<ResultRow>& bindings
     );
 
-    // Recursive function to process nested FOR clauses
+    // The aggregate rows of all files from their partial rows (HAVING applied)
+    static std::vector<ResultRow> mergeForAggregates(
+        const Query& query,
+        const std::vector<ResultRow>& partials
+    );
+
+    // Recursive function to process nested FOR clauses (index labels the
+    // document's elements, so bindings are found without walking subtrees;
+    // binding stops once guard stops the query)
     static void processNestedForClauses(
         const pugi::xml_node& currentContext,
         const Query& query,
+        const RegionIndex& index,
         std::map<std::string, pugi::xml_node>& varContext,
         std::map<std::string, size_t>& positionContext,
         size_t forClauseIndex,
         const std::string& filename,
-        std::vector<ResultRow>& results
+        std::vector<ResultRow>& results,
+        QueryGuard* guard = nullptr
     );
 
     // Resolve field value using variable context
     static std::string resolveFieldWithContext(
         const FieldPath& field,
+        const RegionIndex& index,
         const std::map<std::string, pugi::xml_node>& varContext,
         const std::map<std::string, size_t>& positionContext,
         const pugi::xml_node& fallbackContext,
@@ -99,11 +243,13 @@ private:
         const std::vector<std::string>& xmlFiles,
         const Query& query,
         size_t threadCount,
-        std::atomic<size_t>* completedCounter = nullptr
+        std::atomic<size_t>* completedCounter = nullptr,
+        ExecutionStats* stats = nullptr,
+        const LiteralPrefilter* prefilter = nullptr,
+        QueryGuard* guard = nullptr,
+        ScanCheckpoint* checkpoint = nullptr,
+        IncrementalState* incremental = nullptr
     );
-
-    // Compute aggregate function value
-    static std::string computeAggregate(const FieldPath& field, const std::vector<ResultRow>& allResults);
 };
 
 } // namespace expocli
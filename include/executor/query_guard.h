@@ -0,0 +1,124 @@
+#ifndef QUERY_GUARD_H
+#define QUERY_GUARD_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace expocli {
+
+// Resources one query may use; 0 means no limit
+struct QueryLimits {
+    double timeout_seconds = 0.0;       // Wall clock
+    double cpu_seconds = 0.0;           // CPU time of the threads working on the query
+    uint64_t max_bytes_scanned = 0;     // Total size of the files read
+    uint64_t max_rows = 0;              // Rows produced (FOR bindings before aggregation)
+    uint64_t max_result_bytes = 0;      // Memory held by the rows produced
+    bool partial = false;               // On a limit, return the rows so far instead of failing
+
+    bool any() const {
+        return timeout_seconds > 0 || cpu_seconds > 0 || max_bytes_scanned > 0 ||
+               max_rows > 0 || max_result_bytes > 0;
+    }
+
+    // Settings by name, shared by SET and the command line: TIMEOUT and
+    // MAX_CPU_SECONDS <seconds>, MAX_BYTES_SCANNED and MAX_RESULT_MEMORY
+    // <size>, MAX_ROWS <n> (each OFF to clear), ON_LIMIT <FAIL|PARTIAL>
+    static bool isSetting(const std::string& name);
+    // False with a message in error if value does not suit the setting
+    bool set(const std::string& name, const std::string& value, std::string& error);
+
+    // One line per setting, as SHOW LIMITS prints them
+    std::string describe() const;
+};
+
+// Raised at the end of a query that hit a limit (unless partial results
+// were asked for)
+class QueryLimitExceeded : public std::runtime_error {
+public:
+    explicit QueryLimitExceeded(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+// Enforces QueryLimits cooperatively: the executor's loops ask it whether to
+// go on, and a limit, once hit, stops every worker at its next check.
+//
+// Row and byte counts are compared on every update; the clocks are read on
+// every file and on every kPollInterval-th poll from inner loops, so a check
+// costs a load and an increment in the common case.
+//
+// CPU time is counted per query, not per process, so that queries run side
+// by side (workload replay) do not use up each other's budget: each thread
+// adds its own CPU time (CLOCK_THREAD_CPUTIME_ID) since its previous check to
+// the query's total. A thread's time before its first check for the query
+// is not counted.
+class QueryGuard {
+public:
+    static constexpr uint32_t kPollInterval = 1024;
+
+    explicit QueryGuard(const QueryLimits& limits);
+
+    const QueryLimits& limits() const { return limits_; }
+
+    // True once a limit has been hit
+    bool stopped() const { return stopped_.load(std::memory_order_relaxed); }
+
+    // Per file: reads the clocks; false if the query must stop
+    bool checkpoint();
+
+    // From inner loops: reads the clocks now and then; false if the query must stop
+    bool poll() {
+        if (stopped()) {
+            return false;
+        }
+        // Per thread, so that counting takes no atomic operation
+        static thread_local uint32_t polls = 0;
+        if (++polls % kPollInterval != 0) {
+            return true;
+        }
+        return checkpoint();
+    }
+
+    // Before reading a file of fileBytes; false (stopping the query) if it
+    // would take the bytes scanned past the limit
+    bool scan(uint64_t fileBytes);
+
+    // Rows produced; false if the query must stop
+    bool addRow(const std::vector<std::pair<std::string, std::string>>& row);
+    bool addRows(const std::vector<std::vector<std::pair<std::string, std::string>>>& rows);
+
+    // Message naming the limit that was hit (empty if none)
+    std::string reason() const;
+
+    // After the scan: throws QueryLimitExceeded if a limit was hit and
+    // partial results were not asked for
+    void finish() const;
+
+private:
+    QueryLimits limits_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t id_;                           // Tells a thread's readings for this query apart
+    std::atomic<uint64_t> cpuNanos_{0};     // CPU time counted so far
+
+    std::atomic<bool> stopped_{false};
+    std::atomic<uint64_t> bytesScanned_{0};
+    std::atomic<uint64_t> rows_{0};
+    std::atomic<uint64_t> resultBytes_{0};
+
+    mutable std::mutex reasonMutex_;
+    std::string reason_;
+
+    void stop(const std::string& reason);
+
+    // Adds the calling thread's CPU time since its last check; the query's total
+    uint64_t addThreadCpu();
+};
+
+} // namespace expocli
+
+#endif // QUERY_GUARD_H
@@ -0,0 +1,124 @@
+#ifndef REGION_INDEX_H
+#define REGION_INDEX_H
+
+#include <pugixml.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace expocli {
+
+// Region labels of a document's elements, built in one pass at load time.
+//
+// Every element gets its pre-order number (its position in document order),
+// its post-order number and its level. The descendants of an element are
+// exactly the pre-order range (pre, end), so ancestor/descendant tests are
+// two integer comparisons. Element names are interned, and each name keeps
+// the pre-order numbers of its elements: the elements named X below a node
+// are a binary search plus a range scan of that list, and suffix paths are
+// checked by walking parent numbers and comparing name ids, without
+// recursing through the DOM or building strings. Attribute names get the
+// same treatment: the elements carrying an attribute, in document order.
+class RegionIndex {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    explicit RegionIndex(const pugi::xml_document& doc);
+
+    size_t size() const { return nodes_.size(); }
+
+    // Pre-order number of an element of the document, or npos. The first
+    // call sorts the node table, so lookups that start from the document
+    // never pay for it.
+    uint32_t pre(const pugi::xml_node& node) const;
+
+    uint32_t post(uint32_t pre) const { return post_[pre]; }
+    uint32_t level(uint32_t pre) const { return level_[pre]; }          // Root element = 0
+    uint32_t parent(uint32_t pre) const { return parent_[pre]; }        // npos for the root
+    uint32_t end(uint32_t pre) const { return end_[pre]; }              // One past the last descendant
+    uint32_t nameId(uint32_t pre) const { return names_[pre]; }
+    const pugi::xml_node& node(uint32_t pre) const { return nodes_[pre]; }
+
+    // Interned id of an element name, or npos if no element has it
+    uint32_t findName(const std::string& name) const;
+
+    // True if a is a proper ancestor of d
+    bool isAncestor(uint32_t a, uint32_t d) const {
+        return a < d && post_[d] < post_[a];
+    }
+
+    // The node itself and its descendants named name, in document order
+    void elementsNamed(const pugi::xml_node& node, const std::string& name,
+                       std::vector<pugi::xml_node>& results) const;
+
+    // First of elementsNamed() (as XmlNavigator::findFirstElementByName)
+    pugi::xml_node firstNamed(const pugi::xml_node& node, const std::string& name) const;
+
+    // The node and its descendants whose path from the root ends with path
+    // (as XmlNavigator::findNodesByPartialPath)
+    void elementsByPartialPath(const pugi::xml_node& node, const std::vector<std::string>& path,
+                               std::vector<pugi::xml_node>& results) const;
+
+    // Elements at exactly this path from the root element
+    void elementsByAbsolutePath(const std::vector<std::string>& path,
+                                std::vector<pugi::xml_node>& results) const;
+
+    // Elements that carry the attribute, in document order
+    void elementsWithAttribute(const std::string& name, std::vector<pugi::xml_node>& results) const;
+
+    // Dotted path from the root element ("library.book.title")
+    std::string pathOf(uint32_t pre) const;
+
+private:
+    std::vector<pugi::xml_node> nodes_;
+    std::vector<uint32_t> names_;
+    std::vector<uint32_t> post_;
+    std::vector<uint32_t> level_;
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> end_;
+    mutable std::vector<std::pair<const void*, uint32_t>> preByNode_;  // Sorted by node address on first use
+    mutable bool preSorted_ = false;
+    std::unordered_map<std::string, uint32_t> nameIds_;
+    std::vector<std::vector<uint32_t>> postings_;   // Per name id, pre-order numbers
+    std::unordered_map<std::string, std::vector<uint32_t>> attributePostings_;
+
+    // Pre-order range of the node and its descendants: [first, last)
+    bool region(const pugi::xml_node& node, uint32_t& first, uint32_t& last) const;
+
+    // Name ids of path, or false if a component names no element
+    bool resolve(const std::vector<std::string>& path, std::vector<uint32_t>& ids) const;
+
+    // True if the path from the root to pre ends with ids
+    bool endsWith(uint32_t pre, const std::vector<uint32_t>& ids) const;
+};
+
+// The RegionIndex of a document, built the first time a lookup asks for it,
+// so queries that never need one (anchored paths, root-only fields) do not
+// pay for it. It stays valid as long as the document does and is meant to be
+// kept beside it: every field, predicate and query evaluated on the same
+// document shares one build. Not thread-safe; a document is processed by
+// one thread at a time.
+class DocumentIndex {
+public:
+    explicit DocumentIndex(const pugi::xml_document& doc) : doc_(doc) {}
+
+    const RegionIndex& get() const {
+        if (!index_) {
+            index_ = std::make_unique<RegionIndex>(doc_);
+        }
+        return *index_;
+    }
+
+    bool built() const { return index_ != nullptr; }
+
+private:
+    const pugi::xml_document& doc_;
+    mutable std::unique_ptr<RegionIndex> index_;
+};
+
+} // namespace expocli
+
+#endif // REGION_INDEX_H
@@ -0,0 +1,78 @@
+#ifndef SCAN_CHECKPOINT_H
+#define SCAN_CHECKPOINT_H
+
+#include "executor/query_executor.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace expocli {
+
+// Progress of a scan kept on disk (--checkpoint <file>), so that a query
+// that dies part way through resumes where it stopped.
+//
+// The file starts with the query text and a fingerprint of the corpus (the
+// path, size and modification time of every file), then has one record per
+// completed file: its path, the rows it produced and its raw element count.
+// Aggregates, ORDER BY/LIMIT and GROUP BY are all computed from these rows
+// once the scan is over, so the rows are the state to merge. Records are
+// appended as files complete and flushed every kFlushInterval, and a
+// record cut short by a crash is dropped when the file is read back.
+//
+// A run of the same query over the same corpus skips the completed files
+// and starts from their rows; anything else starts over. The file is
+// removed once a scan completes. Thread-safe.
+class ScanCheckpoint {
+public:
+    static constexpr std::chrono::seconds kFlushInterval{2};
+
+    ScanCheckpoint(const std::string& path, const std::string& queryText);
+    ~ScanCheckpoint();
+
+    ScanCheckpoint(const ScanCheckpoint&) = delete;
+    ScanCheckpoint& operator=(const ScanCheckpoint&) = delete;
+
+    // Once the files are known: resume from the file if it belongs to this
+    // query and corpus, else start it afresh
+    void begin(const std::vector<std::string>& files);
+
+    bool completed(const std::string& file) const;
+
+    // Rows and element count of the files completed by earlier runs (moved out)
+    std::vector<ResultRow> takeRows();
+    uint64_t counted() const { return counted_; }
+    size_t resumedFiles() const { return resumed_; }
+
+    // Record a file whose processing finished
+    void complete(const std::string& file, const std::vector<ResultRow>& rows, uint64_t counted = 0);
+
+    // The scan is over: the checkpoint is no longer needed
+    void finish();
+
+private:
+    std::string path_;
+    std::string query_;
+    uint64_t fingerprint_ = 0;
+
+    std::unordered_set<std::string> completed_;
+    std::vector<ResultRow> rows_;
+    uint64_t counted_ = 0;
+    size_t resumed_ = 0;
+
+    mutable std::mutex mutex_;
+    std::ofstream out_;
+    std::string pending_;
+    std::chrono::steady_clock::time_point lastFlush_;
+
+    // Length of the valid prefix of the saved file (0 if it cannot be resumed)
+    size_t load();
+    void flush();
+};
+
+} // namespace expocli
+
+#endif // SCAN_CHECKPOINT_H
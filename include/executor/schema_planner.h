@@ -0,0 +1,27 @@
+#ifndef SCHEMA_PLANNER_H
+#define SCHEMA_PLANNER_H
+
+#include "parser/ast.h"
+#include "validator/compiled_schema.h"
+#include <string>
+
+namespace expocli {
+
+// Resolves a query against the element structure of a schema before any
+// document is read, assuming the documents conform to it:
+// - a path that can only match one element path is rewritten to that
+//   absolute path and navigated by anchored descent from the root
+// - a path or attribute the schema cannot contain is rejected
+// - WHERE comparisons on xs:integer/xs:decimal fields compare numerically and
+//   on xs:date/xs:dateTime fields as instants, whatever the literal's token
+// Queries with FOR clauses are left unchanged (their paths are relative to
+// the bound variables).
+class SchemaPlanner {
+public:
+    // Throws std::runtime_error for a path no conforming document can contain
+    static void plan(Query& query, const CompiledSchema& schema, const std::string& schemaName);
+};
+
+} // namespace expocli
+
+#endif // SCHEMA_PLANNER_H
@@ -2,6 +2,7 @@
 #define XML_NAVIGATOR_H
 
 #include "parser/ast.h"
+#include "executor/region_index.h"
 #include <pugixml.hpp>
 #include <string>
 #include <vector>
@@ -16,11 +17,15 @@ struct XmlResult {
 
 class XmlNavigator {
 public:
-    // Navigate XML document and extract values matching the field path
+    // Navigate XML document and extract values matching the field path.
+    // Name-driven lookups (attributes, partial paths) are answered from the
+    // document's index; pass the one kept with the document to share it
+    // between fields, or leave it out for a one-off lookup.
     static std::vector<XmlResult> extractValues(
         const pugi::xml_document& doc,
         const std::string& filename,
-        const FieldPath& field
+        const FieldPath& field,
+        const DocumentIndex* index = nullptr
     );
 
     // Evaluate WHERE expression (condition or logical combination)
@@ -61,6 +66,14 @@ public:
         std::vector<pugi::xml_node>& results
     );
 
+    // Value of the first node (in document order) at an anchored path, which
+    // is absolute from the document root. The search starts at `node`, so it
+    // finds nothing unless the path passes through it.
+    static std::string getAnchoredValue(
+        const pugi::xml_node& node,
+        const std::vector<std::string>& path
+    );
+
     // Find first element with given name in XML tree (depth-first search)
     static pugi::xml_node findFirstElementByName(
         const pugi::xml_node& node,
@@ -74,12 +87,19 @@ public:
         const std::vector<std::string>& partialPath
     );
 
-private:
+    // Compare values
+    static bool compareValues(
+        const std::string& nodeValue,
+        const std::string& targetValue,
+        ComparisonOp op,
+        bool isNumeric
+    );
 
-    // Get value from node for comparison
-    static std::string getNodeValue(
-        const pugi::xml_node& node,
-        const FieldPath& field
+    // Compare a node value with the pre-parsed date/date-time literal of the
+    // condition; values that are not ISO-8601 are compared as text
+    static bool compareTemporal(
+        const std::string& nodeValue,
+        const WhereCondition& condition
     );
 
     // Get value from node using relative path (skipping first 'offset' components)
@@ -89,12 +109,31 @@ private:
         size_t offset
     );
 
-    // Compare values
-    static bool compareValues(
-        const std::string& nodeValue,
-        const std::string& targetValue,
-        ComparisonOp op,
-        bool isNumeric
+    // getNodeValueRelative without the copy: the text is owned by the document
+    static const char* nodeValueRelative(
+        const pugi::xml_node& node,
+        const FieldPath& field,
+        size_t offset
+    );
+
+private:
+    // First node matching path[depth..] below node (depth-first)
+    static pugi::xml_node findFirstNode(
+        const pugi::xml_node& node,
+        const std::vector<std::string>& path,
+        size_t depth
+    );
+
+    // getAnchoredValue without the copy
+    static const char* anchoredValue(
+        const pugi::xml_node& node,
+        const std::vector<std::string>& path
+    );
+
+    // Get value from node for comparison
+    static std::string getNodeValue(
+        const pugi::xml_node& node,
+        const FieldPath& field
     );
 };
 
@@ -0,0 +1,35 @@
+#ifndef CORPUS_PROFILER_H
+#define CORPUS_PROFILER_H
+
+#include "generation_profile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace expocli {
+
+// Summary of a profiling run
+struct CorpusSummary {
+    size_t files = 0;           // Files profiled
+    size_t skipped = 0;         // Files that could not be parsed
+    uint64_t bytes = 0;
+    size_t paths = 0;           // Distinct element and attribute paths
+};
+
+// Scans an existing corpus and records what a look-alike needs: the element
+// and attribute structure, per-path value types, value and length
+// distributions, distinct-value counts and skew, occurrence counts and file
+// sizes. The result is a GenerationProfile that declares the structure, so
+// GENERATE XML ... PROFILE can synthesize an equivalent corpus without the
+// original data or an XSD. No values are copied into the profile.
+class CorpusProfiler {
+public:
+    // Files are parsed in parallel (threadCount 0 = one per hardware thread)
+    static GenerationProfile profile(const std::vector<std::string>& files,
+                                     CorpusSummary* summary = nullptr,
+                                     size_t threadCount = 0);
+};
+
+} // namespace expocli
+
+#endif // CORPUS_PROFILER_H
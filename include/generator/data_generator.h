@@ -2,6 +2,9 @@
 #define DATA_GENERATOR_H
 
 #include "xsd_schema.h"
+#include "generation_profile.h"
+#include <cstdint>
+#include <ctime>
 #include <string>
 #include <random>
 
@@ -11,9 +14,26 @@ class DataGenerator {
 public:
     DataGenerator();
 
+    // Deterministic stream: the same seed always yields the same values, and
+    // dates are drawn relative to a fixed UTC reference instead of today
+    explicit DataGenerator(uint64_t seed);
+
+    // Restart the stream from a seed (cheaper than constructing a new generator)
+    void reseed(uint64_t seed);
+
+    // Uniform integer in [min, max], drawn from the same stream as the values
+    int randomInt(int min, int max);
+
+    // Stream used for profile distributions
+    std::mt19937& engine() { return rng_; }
+
     // Generate random data based on XSD type
     std::string generateValue(XsdType type);
 
+    // Same, with numbers and string lengths drawn from the profile's
+    // value and length distributions when it sets them
+    std::string generateValue(XsdType type, const PathProfile& profile);
+
     // Generate specific data types
     std::string generateString(int minLength = 5, int maxLength = 20);
     std::string generateInteger(int min = 1, int max = 1000);
@@ -22,9 +42,16 @@ public:
     std::string generateDate();
     std::string generateDateTime();
 
+    // Random letters, first one capitalized
+    std::string generateWord(int length);
+
 private:
     std::mt19937 rng_;
     std::uniform_int_distribution<int> char_dist_;
+    std::time_t reference_time_;    // Dates are generated in the 5 years before this
+    bool utc_ = false;              // Format dates in UTC (seeded) or local time
+
+    std::tm calendarTime(int daysAgo) const;
 
     // Helper data for realistic values
     static const std::vector<std::string> sample_words_;
@@ -0,0 +1,127 @@
+#ifndef GENERATION_PROFILE_H
+#define GENERATION_PROFILE_H
+
+#include "xsd_schema.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace expocli {
+
+// Random distribution of a profile setting, written as
+//   uniform(min, max)      normal(mean, stddev)     zipf(n, exponent)
+//   lognormal(median, sigma)   pareto(min, alpha)   or a constant
+// Arguments accept size units (64KB, 2MB, ...).
+class Distribution {
+public:
+    enum class Kind { NONE, CONSTANT, UNIFORM, NORMAL, ZIPF, LOGNORMAL, PARETO };
+
+    Distribution() = default;
+
+    // Throws std::runtime_error on malformed text
+    static Distribution parse(const std::string& text);
+
+    static Distribution constant(double value);
+    static Distribution uniform(double min, double max);
+    static Distribution normal(double mean, double stddev);
+    static Distribution lognormal(double median, double sigma);
+    static Distribution zipf(uint64_t n, double exponent);
+
+    bool empty() const { return kind_ == Kind::NONE; }
+    Kind kind() const { return kind_; }
+
+    double sample(std::mt19937& rng) const;
+
+    // Whole-number sample; uniform(a, b) gives every integer of [a, b] equal weight
+    int64_t sampleInteger(std::mt19937& rng) const;
+
+    std::string toString() const;
+
+private:
+    Kind kind_ = Kind::NONE;
+    double a_ = 0.0;
+    double b_ = 0.0;
+
+    // Rejection-inversion Zipf sampler (Hörmann & Derflinger), O(1) per draw
+    double zipfH(double x) const;
+    double zipfHIntegral(double x) const;
+    double zipfHIntegralInverse(double x) const;
+    double h_integral_x1_ = 0.0;
+    double h_integral_n_ = 0.0;
+    double s_ = 0.0;
+};
+
+// Settings for the elements (or attributes) at one path
+struct PathProfile {
+    std::string path;           // library.book.price, library.book.@isbn or .price (any depth)
+    bool hasType = false;       // Declares the node (profiles that describe the structure)
+    XsdType type = XsdType::STRING;
+    bool hasOccurs = false;
+    int minOccurs = 1;
+    int maxOccurs = 1;          // -1 means unbounded
+    Distribution value;         // Numbers drawn for xs:integer/xs:decimal values
+    Distribution length;        // Length of generated strings
+    Distribution repeat;        // Occurrences per parent, clamped to minOccurs/maxOccurs
+    uint64_t cardinality = 0;   // Distinct values (0 = unrestricted)
+    double skew = 0.0;          // Zipf exponent over the distinct values (0 = uniform)
+    double nullRate = -1.0;     // Probability of leaving the node out (-1 = schema default)
+
+    // Index into the distinct values, most frequent first
+    Distribution pick;
+};
+
+// Statistical shape of a generated corpus, loaded from a text file:
+//
+//   # comment
+//   FILE_SIZE             lognormal(48KB, 1.2)
+//   library.book          repeat=zipf(200, 1.1)
+//   library.book.@isbn    cardinality=100000
+//   .category             cardinality=12 skew=1.3 null=0.05
+//   .price                value=normal(40, 12)
+//   .title                length=uniform(5, 40)
+//
+// Paths are element names from the root separated by dots; a leading dot
+// matches the path at any depth and the most specific rule wins.
+//
+// A profile can also describe the document structure itself, with
+// type=(string|integer|decimal|boolean|date|datetime|complex) and
+// occurs=<min>..<max|*> on absolute paths listed parents first, in document
+// order (as written by CorpusProfiler). No XSD is needed to generate from it.
+class GenerationProfile {
+public:
+    // Throws std::runtime_error with the line number on malformed input
+    static GenerationProfile load(const std::string& file);
+    static GenerationProfile parse(const std::string& text, const std::string& source = "profile");
+
+    // Profile text that parse() reads back
+    std::string toString() const;
+    void save(const std::string& file) const;
+
+    // Rule for the node at path (element names from the root, an attribute
+    // as "@name"), or nullptr
+    const PathProfile* find(const std::vector<std::string>& path) const;
+
+    const Distribution& fileSize() const { return file_size_; }
+    void setFileSize(const Distribution& size) { file_size_ = size; }
+
+    const std::vector<PathProfile>& rules() const { return rules_; }
+    void addRule(PathProfile rule);
+
+    // True if the rules declare the document structure
+    bool hasStructure() const;
+
+    // Schema of the declared structure; throws std::runtime_error if a
+    // declared node has no declared parent
+    std::shared_ptr<XsdSchema> toSchema() const;
+
+private:
+    Distribution file_size_;
+    std::vector<PathProfile> rules_;
+    std::vector<std::vector<std::string>> components_;  // Per rule, split path
+};
+
+} // namespace expocli
+
+#endif // GENERATION_PROFILE_H
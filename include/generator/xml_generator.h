@@ -3,17 +3,50 @@
 
 #include "xsd_schema.h"
 #include "data_generator.h"
-#include <pugixml.hpp>
+#include "generation_profile.h"
+#include <cstdint>
+#include <cstdio>
+#include <optional>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace expocli {
 
+// Settings of a GENERATE XML run
+struct GenerationOptions {
+    int count = 1;
+    std::string prefix = "generated_";
+    std::optional<uint64_t> seed;   // Reproducible output; random if unset
+    size_t threads = 0;             // 0 = one per hardware thread
+    uint64_t targetBytes = 0;       // Total corpus size to reach (0 = natural size)
+    std::shared_ptr<const GenerationProfile> profile;  // Value, repeat and size distributions
+};
+
+// Outcome of generateFiles
+struct GenerationSummary {
+    int files = 0;                  // Files written successfully
+    uint64_t bytes = 0;
+    size_t threads = 1;
+    double elapsedMs = 0.0;
+};
+
 class XmlGenerator {
 public:
     XmlGenerator();
 
-    // Generate XML instances from schema
+    // Generate XML instances from schema. Documents are streamed straight to
+    // their files without building a DOM, on several threads. With a seed,
+    // document i is always generated from the same random stream, so the
+    // corpus is identical whatever the thread count.
+    GenerationSummary generateFiles(
+        const XsdSchema& schema,
+        const std::string& destDir,
+        const GenerationOptions& options
+    );
+
+    // Generate XML instances from schema with default options
     void generateFiles(
         const XsdSchema& schema,
         int count,
@@ -21,20 +54,62 @@ public:
         const std::string& prefix = "generated_"
     );
 
+    // Stream a single XML document to an open file; returns bytes written.
+    // sizeBudget > 0 repeats the schema's first unbounded element list until
+    // the document reaches about that many bytes.
+    uint64_t writeDocument(const XsdSchema& schema, std::FILE* out, uint64_t sizeBudget = 0);
+
+    // Random stream of the next document (deterministic generators only)
+    void reseed(uint64_t seed) { data_gen_.reseed(seed); }
+
+    // Draw values, repeat counts and null rates from a profile. Distinct
+    // values are derived from poolSeed, so every generator given the same
+    // seed produces the same value set.
+    void setProfile(const GenerationProfile* profile, uint64_t poolSeed);
+
 private:
+    // Element (or attribute) at one path of the generated tree, with its
+    // profile rule resolved; children are created on first visit
+    struct PathNode {
+        const XsdElement* element = nullptr;
+        const PathNode* parent = nullptr;
+        const PathProfile* profile = nullptr;
+        uint64_t pathHash = 0;
+        bool expanded = false;
+        std::vector<std::unique_ptr<PathNode>> attributes;
+        std::vector<std::unique_ptr<PathNode>> children;
+        std::unordered_map<uint64_t, std::string> pool;  // Distinct values used so far, by rank
+    };
+
     DataGenerator data_gen_;
+    DataGenerator pool_gen_{0};     // Distinct values of profiled paths
+    const GenerationProfile* profile_ = nullptr;
+    uint64_t pool_seed_ = 0;
+    std::unique_ptr<PathNode> root_node_;
+    std::string buffer_;            // Pending output, flushed in large blocks
+    std::FILE* out_ = nullptr;
+    uint64_t written_ = 0;          // Bytes of the current document
+    uint64_t budget_ = 0;
+    const XsdSchema* growth_schema_ = nullptr;
+    std::vector<const XsdElement*> growth_path_;  // Root to the element whose lists grow
+    bool grown_ = false;
 
-    // Generate a single XML document
-    pugi::xml_document generateDocument(const XsdSchema& schema);
+    explicit XmlGenerator(uint64_t seed);
 
     // Generate an element based on schema definition
-    void generateElement(
-        pugi::xml_node& parent,
-        const std::shared_ptr<XsdElement>& element
-    );
+    void generateElement(PathNode& node, size_t depth);
+
+    void writeElement(PathNode& node, size_t depth);
+    void expand(PathNode& node);
+    std::unique_ptr<PathNode> makeNode(const XsdElement& element, const PathNode* parent);
+    std::string generateValue(PathNode& node);
+    void indent(size_t depth);
+    void append(const char* data, size_t length);
+    void appendEscaped(const std::string& value, bool attribute);
+    void flush();
 
     // Determine how many times to repeat an element (for maxOccurs > 1)
-    int determineRepeatCount(const std::shared_ptr<XsdElement>& element);
+    int determineRepeatCount(const PathNode& node);
 };
 
 } // namespace expocli
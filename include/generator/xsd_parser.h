@@ -6,43 +6,62 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <set>
+#include <vector>
 
 namespace expocli {
 
+// Parsing state is per instance, so schemas can be parsed concurrently
 class XsdParser {
 public:
     // Parse an XSD file and return the schema model
     static std::unique_ptr<XsdSchema> parse(const std::string& xsd_file_path);
 
+    // The XSD file followed by every local file it pulls in through
+    // xs:include, xs:import or xs:redefine (recursively, each listed once)
+    static std::vector<std::string> collectSchemaFiles(const std::string& xsd_file_path);
+
 private:
+    std::unique_ptr<XsdSchema> parseFile(const std::string& xsd_file_path);
+
+    // Register the named types of included schemas (before the including
+    // schema's own, which take precedence)
+    void loadIncludedTypes(const pugi::xml_node& schemaNode, const std::string& schemaPath);
+
     // Store named types for lookup
-    static std::map<std::string, std::shared_ptr<XsdElement>> named_types_;
+    std::map<std::string, std::shared_ptr<XsdElement>> named_types_;
+    std::set<std::string> loaded_files_;
 
-    static std::shared_ptr<XsdElement> parseElement(
+    std::shared_ptr<XsdElement> parseElement(
         const pugi::xml_node& node,
         const pugi::xml_document& doc
     );
 
-    static std::shared_ptr<XsdElement> parseComplexType(
+    std::shared_ptr<XsdElement> parseComplexType(
         const pugi::xml_node& complexTypeNode,
         const pugi::xml_document& doc
     );
 
-    static std::shared_ptr<XsdElement> parseSequence(
+    std::shared_ptr<XsdElement> parseSequence(
         const pugi::xml_node& sequenceNode,
         const pugi::xml_document& doc
     );
 
-    static void parseAndStoreNamedTypes(
+    void parseAndStoreNamedTypes(
         const pugi::xml_node& schemaNode,
         const pugi::xml_document& doc
     );
 
-    static std::shared_ptr<XsdElement> createElementFromType(
+    std::shared_ptr<XsdElement> createElementFromType(
         const std::string& typeName,
         const std::string& elementName
     );
 
+    static pugi::xml_node findSchemaNode(const pugi::xml_document& doc);
+    static std::vector<std::string> scanIncludeLocations(const std::string& text,
+                                                         const std::string& schemaPath);
+    static std::vector<std::string> includeLocations(const pugi::xml_node& schemaNode,
+                                                     const std::string& schemaPath);
     static XsdType parseType(const std::string& typeName);
     static int parseOccurs(const pugi::xml_node& node, const char* attrName, int defaultValue);
     static std::string stripNamespacePrefix(const std::string& name);
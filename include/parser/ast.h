@@ -1,6 +1,7 @@
 #ifndef AST_H
 #define AST_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -119,6 +120,7 @@ struct FieldPath {
 
     // Path resolution
     bool is_partial_path = false;        // True if path starts with dot (e.g., .price, .book.price)
+    bool is_anchored = false;            // Absolute path from the document root (resolved against the schema)
 };
 
 // Logical operators for combining conditions
@@ -139,6 +141,8 @@ struct WhereCondition : public WhereExpr {
     ComparisonOp op;
     std::string value;
     bool is_numeric;
+    bool is_temporal = false;         // Compare as ISO-8601 dates/date-times
+    int64_t temporal_value = 0;       // The literal in microseconds since the epoch (when is_temporal)
     std::vector<std::string> values;  // For IN/NOT_IN operators
 };
 
@@ -170,11 +174,20 @@ struct OrderByField {
     SortDirection direction = SortDirection::ASC;
 };
 
+// What to do with documents failing VALIDATE AGAINST
+enum class InvalidDocumentPolicy {
+    SKIP,   // Exclude the document from the results (default)
+    FAIL    // Abort the query
+};
+
 // Main Query AST
 struct Query {
     std::vector<FieldPath> select_fields;     // Fields to select
     bool distinct = false;                     // DISTINCT flag
     std::string from_path;                     // Directory path
+    std::string validate_schema;               // VALIDATE AGAINST schema (empty = no validation)
+    InvalidDocumentPolicy invalid_policy = InvalidDocumentPolicy::SKIP;
+    std::string planning_schema;               // Schema that resolved paths and comparison types (empty = none)
     std::vector<ForClause> for_clauses;        // Optional FOR clauses for iteration context
     std::unique_ptr<WhereExpr> where;          // Optional WHERE clause (can be condition or logical)
     std::vector<std::string> group_by_fields;  // GROUP BY fields
@@ -32,12 +32,14 @@ private:
     bool match(TokenType type);
     bool isAtEnd() const;
     void expect(TokenType type, const std::string& message);
+    bool checkWord(const char* word, size_t ahead = 0) const;  // Contextual keyword (IDENTIFIER)
 
     // Parsing methods
     FieldPath parseFieldPath();
     FieldPath parseSelectField();  // Parse SELECT field (may include aggregation)
     std::string parseFilePath();  // Parse filesystem path (quoted or unquoted)
     ForClause parseForClause();   // Parse FOR...IN clause
+    void parseValidateClause(Query& query);  // Parse VALIDATE AGAINST <xsd> [SKIP INVALID | FAIL]
     std::unique_ptr<WhereExpr> parseWhereClause();
     std::unique_ptr<WhereExpr> parseWhereExpression();
     std::unique_ptr<WhereExpr> parseWhereOr();
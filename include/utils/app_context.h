@@ -1,6 +1,7 @@
 #ifndef APP_CONTEXT_H
 #define APP_CONTEXT_H
 
+#include "executor/query_guard.h"
 #include <string>
 #include <optional>
 
@@ -25,10 +26,33 @@ public:
     void setVerbose(bool verbose);
     bool isVerbose() const;
 
+    // Slow query log: queries taking at least the threshold (ms) are logged
+    void setSlowQueryThresholdMs(std::optional<double> ms);
+    std::optional<double> getSlowQueryThresholdMs() const;
+    void setSlowQueryLogPath(const std::string& path);
+    std::string getSlowQueryLogPath() const;
+
+    // Per-query resource limits applied to every query of the session
+    void setQueryLimits(const QueryLimits& limits);
+    const QueryLimits& getQueryLimits() const;
+
+    // Scan checkpoint file (--checkpoint); empty when queries are not checkpointed
+    void setCheckpointPath(const std::string& path);
+    std::string getCheckpointPath() const;
+
+    // Incremental state file (--incremental); empty when files are read in full
+    void setIncrementalPath(const std::string& path);
+    std::string getIncrementalPath() const;
+
 private:
     std::optional<std::string> xsd_path_;
     std::optional<std::string> dest_path_;
     bool verbose_ = false;
+    std::optional<double> slow_query_ms_;
+    std::string slow_query_log_path_;
+    QueryLimits query_limits_;
+    std::string checkpoint_path_;
+    std::string incremental_path_;
 };
 
 } // namespace expocli
@@ -2,7 +2,9 @@
 #define COMMAND_HANDLER_H
 
 #include "app_context.h"
+#include "parser/ast.h"
 #include <string>
+#include <vector>
 
 namespace expocli {
 
@@ -17,9 +19,11 @@ private:
     AppContext& context_;
 
     bool handleSetCommand(const std::string& input);
+    bool handleSetOption(const std::string& option, const std::vector<Token>& tokens);
     bool handleShowCommand(const std::string& input);
     bool handleGenerateCommand(const std::string& input);
     bool handleCheckCommand(const std::string& input);
+    bool handleProfileCommand(const std::string& input);
 
     void setXsdPath(const std::string& path);
     void setDestPath(const std::string& path);
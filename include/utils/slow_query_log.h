@@ -0,0 +1,34 @@
+#ifndef SLOW_QUERY_LOG_H
+#define SLOW_QUERY_LOG_H
+
+#include "executor/query_executor.h"
+#include <string>
+
+namespace expocli {
+
+// Appends one JSON record per slow query (JSON Lines) with the normalised
+// query, execution plan, stage timings and the most expensive files
+class SlowQueryLog {
+public:
+    // Number of files attributed per record
+    static constexpr size_t kTopFiles = 5;
+
+    // Default log location: ~/.expocli_slow_queries.log (or the working directory)
+    static std::string defaultPath();
+
+    // Replace literals with '?' and collapse whitespace so that queries
+    // differing only in constants share the same normalised form
+    static std::string normalizeQuery(const std::string& query);
+
+    // Append a record; throws std::runtime_error if the log cannot be written
+    static void append(
+        const std::string& path,
+        const std::string& query,
+        double totalMs,
+        const ExecutionStats& stats
+    );
+};
+
+} // namespace expocli
+
+#endif // SLOW_QUERY_LOG_H
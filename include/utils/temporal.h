@@ -0,0 +1,30 @@
+#ifndef TEMPORAL_H
+#define TEMPORAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace expocli {
+
+// ISO-8601 dates (xs:date) and date-times (xs:dateTime) as microseconds since
+// the Unix epoch in UTC, so they compare as plain integers. Values without a
+// time zone are taken as UTC; a date is its first instant.
+class Temporal {
+public:
+    // YYYY-MM-DD[Z|(+|-)hh:mm]
+    static bool parseDate(const char* text, size_t length, int64_t& micros);
+
+    // YYYY-MM-DDThh:mm:ss[.fraction][Z|(+|-)hh:mm]
+    static bool parseDateTime(const char* text, size_t length, int64_t& micros);
+
+    // Either form
+    static bool parse(const char* text, size_t length, int64_t& micros);
+    static bool parse(const std::string& text, int64_t& micros) {
+        return parse(text.data(), text.size(), micros);
+    }
+};
+
+} // namespace expocli
+
+#endif // TEMPORAL_H
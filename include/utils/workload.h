@@ -0,0 +1,81 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "executor/query_guard.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace expocli {
+
+// One captured query from an interactive session
+struct WorkloadEntry {
+    int64_t timestamp_ms = 0;   // Wall-clock time the query was submitted (Unix epoch)
+    double offset_ms = 0.0;     // Time since capture started (used for pacing on replay)
+    double elapsed_ms = 0.0;    // Execution time when captured
+    size_t rows = 0;            // Result cardinality
+    size_t files = 0;           // Number of files scanned
+    bool ok = true;             // false if the query failed (parse or execution error)
+    std::string query;          // Query text (single line)
+};
+
+// Records queries to a workload file (tab-separated, one query per line)
+class WorkloadRecorder {
+public:
+    WorkloadRecorder() = default;
+
+    // Start capturing to the given file (appends if it exists)
+    // Throws std::runtime_error if the file cannot be opened
+    void open(const std::string& path);
+
+    bool isActive() const { return out_.is_open(); }
+    const std::string& path() const { return path_; }
+
+    // Append an entry; timestamp and offset are filled in from the capture clock
+    void record(WorkloadEntry entry);
+
+private:
+    std::ofstream out_;
+    std::string path_;
+    std::chrono::steady_clock::time_point start_;
+    std::mutex mutex_;
+};
+
+// Replay options
+struct ReplayOptions {
+    size_t concurrency = 1;   // Number of queries in flight
+    double speed = 0.0;       // 0 = no pacing, 1 = recorded pacing, 2 = twice as fast, ...
+    QueryLimits limits;       // Applied to each replayed query
+};
+
+// Outcome of replaying one entry
+struct ReplayResult {
+    WorkloadEntry recorded;
+    double elapsed_ms = 0.0;
+    size_t rows = 0;
+    bool ok = true;
+    std::string error;
+};
+
+class WorkloadReplayer {
+public:
+    // Load a workload file written by WorkloadRecorder
+    // Throws std::runtime_error on unreadable files or malformed lines
+    static std::vector<WorkloadEntry> load(const std::string& path);
+
+    // Replay entries in recorded order; results are returned in the same order
+    static std::vector<ReplayResult> replay(
+        const std::vector<WorkloadEntry>& entries,
+        const ReplayOptions& options
+    );
+
+    // Print per-query latency deltas and a summary
+    static void printReport(const std::vector<ReplayResult>& results, double wallSeconds);
+};
+
+} // namespace expocli
+
+#endif // WORKLOAD_H
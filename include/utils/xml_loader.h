@@ -12,6 +12,12 @@ public:
     // Load an XML file and return the document
     static std::unique_ptr<pugi::xml_document> load(const std::string& filepath);
 
+    // Read a file's raw bytes, for callers that look at them before parsing
+    static std::string readFile(const std::string& filepath);
+
+    // Parse bytes read from filepath (named in errors)
+    static std::unique_ptr<pugi::xml_document> load(const std::string& filepath, const std::string& bytes);
+
     // Check if a file is a valid XML file
     static bool isXmlFile(const std::string& filepath);
 };
@@ -0,0 +1,145 @@
+#ifndef COMPILED_SCHEMA_H
+#define COMPILED_SCHEMA_H
+
+#include "generator/xsd_schema.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace expocli {
+
+// Element declaration inside a content model (or the root element)
+struct CompiledElement {
+    uint32_t name = 0;          // Index into the interned name table
+    XsdType type = XsdType::STRING;
+    int32_t minOccurs = 1;
+    int32_t maxOccurs = 1;      // -1 means unbounded
+    uint32_t contentType = 0;   // Index of the element's attributes/children table
+};
+
+// Attribute declaration
+struct CompiledAttribute {
+    uint32_t name = 0;
+    XsdType type = XsdType::STRING;
+    bool required = false;
+};
+
+// Collision-free lookup table over a fixed key set (slot -1 = empty)
+struct PerfectHash {
+    uint32_t offset = 0;        // First entry in CompiledSchema::slots_
+    uint32_t mask = 0;          // Table size - 1 (power of two)
+    uint32_t seed = 0;
+};
+
+// Attributes and child content model of one element declaration. Child
+// occurrences are tracked by one counter per slot: the counters are the
+// automaton state, the perfect hash is the transition function and the
+// occurrence bounds are the accepting condition.
+struct CompiledContentType {
+    uint32_t firstChild = 0;    // Range in CompiledSchema::elements_
+    uint32_t childCount = 0;
+    uint32_t firstAttribute = 0; // Range in CompiledSchema::attributes_
+    uint32_t attributeCount = 0;
+    PerfectHash childLookup;
+    PerfectHash attributeLookup;
+};
+
+// Flat, immutable form of an XsdSchema used by the validator. Built once per
+// schema and safe to share between threads.
+class CompiledSchema {
+public:
+    // Where load() found the schema
+    enum class LoadSource { MEMORY, DISK_CACHE, COMPILED };
+
+    static std::unique_ptr<CompiledSchema> compile(const XsdSchema& schema);
+
+    // Parse and compile an XSD file, reusing the result while the file and
+    // the schemas it includes are unchanged (thread-safe). Compiled tables
+    // are also kept in a disk cache keyed by the content of those files, so
+    // later sessions skip parsing. Throws std::runtime_error if it cannot be parsed.
+    static std::shared_ptr<const CompiledSchema> load(const std::string& xsdFile,
+                                                      LoadSource* source = nullptr);
+
+    // Directory of the disk cache: $EXPOCLI_SCHEMA_CACHE, else
+    // $XDG_CACHE_HOME/expocli/schemas or ~/.cache/expocli/schemas.
+    // Empty if caching is disabled (EXPOCLI_SCHEMA_CACHE set to "" or "off").
+    static std::string cacheDirectory();
+
+    // Binary image of the tables. deserialize() returns nullptr if the data
+    // was written by an incompatible version or is damaged.
+    std::string serialize() const;
+    static std::unique_ptr<CompiledSchema> deserialize(const std::string& data);
+
+    // Hash of the binary image: equal for schemas that validate alike
+    uint64_t fingerprint() const;
+
+    // Rebuild the schema model (for the generator); content models shared
+    // between elements stay shared, as in the parser's output
+    std::unique_ptr<XsdSchema> toSchema() const;
+
+    const std::string& targetNamespace() const { return targetNamespace_; }
+    size_t elementCount() const { return elements_.size(); }
+
+    bool hasRoot() const { return hasRoot_; }
+    const CompiledElement& root() const { return elements_[rootIndex_]; }
+
+    const std::string& name(uint32_t id) const { return names_[id]; }
+    const CompiledElement& element(uint32_t index) const { return elements_[index]; }
+    const CompiledAttribute& attribute(uint32_t index) const { return attributes_[index]; }
+    const CompiledContentType& contentType(uint32_t index) const { return contentTypes_[index]; }
+
+    // Child slot (0..childCount-1) of the given name, or -1 if not declared
+    int32_t findChild(const CompiledContentType& type, const char* name, size_t length) const {
+        return lookup(type.childLookup, name, length, type.firstChild, true);
+    }
+
+    // Attribute slot (0..attributeCount-1) of the given name, or -1 if not declared
+    int32_t findAttribute(const CompiledContentType& type, const char* name, size_t length) const {
+        return lookup(type.attributeLookup, name, length, type.firstAttribute, false);
+    }
+
+    static uint32_t hashName(const char* name, size_t length, uint32_t seed) {
+        uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (size_t i = 0; i < length; ++i) {
+            h ^= static_cast<unsigned char>(name[i]);
+            h *= 16777619u;
+        }
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+private:
+    friend class CompiledSchemaBuilder;
+    friend class SchemaRebuilder;
+
+    int32_t lookup(const PerfectHash& hash, const char* name, size_t length,
+                   uint32_t first, bool children) const {
+        int32_t slot = slots_[hash.offset + (hashName(name, length, hash.seed) & hash.mask)];
+        if (slot < 0) {
+            return -1;
+        }
+        const std::string& candidate = names_[children ? elements_[first + slot].name
+                                                       : attributes_[first + slot].name];
+        if (candidate.size() != length || std::memcmp(candidate.data(), name, length) != 0) {
+            return -1;
+        }
+        return slot;
+    }
+
+    std::vector<std::string> names_;
+    std::vector<CompiledElement> elements_;
+    std::vector<CompiledAttribute> attributes_;
+    std::vector<CompiledContentType> contentTypes_;
+    std::vector<int32_t> slots_;
+    std::string targetNamespace_;
+    uint32_t rootIndex_ = 0;
+    bool hasRoot_ = false;
+};
+
+} // namespace expocli
+
+#endif // COMPILED_SCHEMA_H
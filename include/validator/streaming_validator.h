@@ -0,0 +1,29 @@
+#ifndef STREAMING_VALIDATOR_H
+#define STREAMING_VALIDATOR_H
+
+#include "validator/xml_validator.h"
+#include "validator/compiled_schema.h"
+#include <string>
+
+namespace expocli {
+
+// Validates an XML file against a compiled schema while reading it, without
+// building a DOM. Memory is bounded by document depth (plus the text of the
+// simple element being checked), so arbitrarily large files can be checked.
+//
+// Checks are the same as the DOM validator's, but errors carry line numbers
+// and an element's occurrence errors are reported when its end tag is read,
+// i.e. after the errors of its descendants.
+class StreamingValidator {
+public:
+    explicit StreamingValidator(const CompiledSchema& schema) : schema_(schema) {}
+
+    ValidationResult validateFile(const std::string& xmlFile);
+
+private:
+    const CompiledSchema& schema_;
+};
+
+} // namespace expocli
+
+#endif // STREAMING_VALIDATOR_H
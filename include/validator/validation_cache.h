@@ -0,0 +1,74 @@
+#ifndef VALIDATION_CACHE_H
+#define VALIDATION_CACHE_H
+
+#include "validator/xml_validator.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace expocli {
+
+// State of a file when lookup() saw it, handed back to store()
+struct FileStamp {
+    std::string key;            // Absolute path
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t hash = 0;          // Content hash, taken before validation
+    bool valid = false;         // False if the file could not be read
+};
+
+// Verdicts of earlier CHECK runs against one schema, kept on disk so that
+// re-checking a mostly unchanged archive only validates the new files.
+//
+// Entries are keyed by absolute path and remember the file's size,
+// modification time and content hash. A file whose size and mtime are
+// unchanged reuses its verdict; if only the mtime moved (a copy, a touch),
+// the content hash decides. As in git's index, an mtime not older than the
+// last save is not trusted on its own, since the file could have changed
+// again within the same clock tick. Thread-safe.
+class ValidationCache {
+public:
+    // schemaKey identifies everything a verdict depends on
+    // (see XmlValidator::resultKey); each key has its own cache file
+    ValidationCache(const std::string& directory, uint64_t schemaKey);
+
+    // Directory of the cache: $EXPOCLI_VALIDATION_CACHE, else
+    // $XDG_CACHE_HOME/expocli/validation or ~/.cache/expocli/validation.
+    // Empty if caching is disabled (EXPOCLI_VALIDATION_CACHE set to "" or "off").
+    static std::string cacheDirectory();
+
+    // True (with the cached verdict in result) if the file is unchanged
+    // since it was last validated
+    bool lookup(const std::string& file, ValidationResult& result, FileStamp& stamp);
+
+    // Remember the verdict of a file validated after lookup() missed
+    void store(const FileStamp& stamp, const ValidationResult& result);
+
+    // Write the cache back if anything changed; failures only cost a
+    // re-validation next time
+    void save();
+
+    size_t hits() const { return hits_; }
+
+private:
+    struct Entry {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;
+        ValidationResult result;
+    };
+
+    std::string file_;
+    int64_t savedAt_ = 0;       // mtime clock when the loaded cache was written
+    std::unordered_map<std::string, Entry> entries_;
+    std::mutex mutex_;
+    size_t hits_ = 0;
+    bool dirty_ = false;
+
+    void load();
+};
+
+} // namespace expocli
+
+#endif // VALIDATION_CACHE_H
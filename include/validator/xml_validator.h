@@ -4,11 +4,16 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <cstdint>
 #include <pugixml.hpp>
 #include "generator/xsd_schema.h"
+#include "validator/compiled_schema.h"
 
 namespace expocli {
 
+class ValidationCache;
+
 struct ValidationError {
     std::string message;
     std::string path;       // XPath-like location in the document
@@ -20,9 +25,9 @@ struct ValidationResult {
     std::vector<ValidationError> errors;
     std::vector<std::string> warnings;
 
-    void addError(const std::string& message, const std::string& path = "") {
+    void addError(const std::string& message, const std::string& path = "", int line = -1) {
         isValid = false;
-        errors.push_back({message, path, -1});
+        errors.push_back({message, path, line});
     }
 
     void addWarning(const std::string& message) {
@@ -30,53 +35,123 @@ struct ValidationResult {
     }
 };
 
+// Receives each file's result as soon as it (and every file before it) is done
+using ValidationCallback = std::function<void(const std::string&, const ValidationResult&)>;
+
 class XmlValidator {
 public:
+    // Files at least this large are validated by streaming instead of via a DOM
+    static constexpr uintmax_t kDefaultStreamingThreshold = 256ull * 1024 * 1024;
+
     XmlValidator() = default;
 
+    // Streaming threshold in bytes (0 = always stream)
+    void setStreamingThreshold(uintmax_t bytes) { streamingThreshold_ = bytes; }
+
+    // Reuse verdicts of unchanged files in validateFiles() (nullptr = off);
+    // the cache must have been opened with resultKey() of the same schema
+    void setCache(ValidationCache* cache) { cache_ = cache; }
+
+    // Identifies what a file's verdict depends on besides its content:
+    // the schema and the streaming threshold
+    uint64_t resultKey(const CompiledSchema& schema) const;
+
     // Validate an XML file against an XSD schema
     ValidationResult validateFile(
         const std::string& xmlFile,
         const std::string& xsdFile
     );
 
+    // Validate an XML file against an already parsed schema
+    ValidationResult validateFile(
+        const std::string& xmlFile,
+        const XsdSchema& schema
+    );
+
+    // Validate an XML file against a compiled schema (thread-safe); large
+    // files go through the streaming validator
+    ValidationResult validateFile(
+        const std::string& xmlFile,
+        const CompiledSchema& schema
+    );
+
+    // Validate an already loaded document (thread-safe)
+    ValidationResult validateDocument(
+        const pugi::xml_document& doc,
+        const CompiledSchema& schema
+    ) {
+        return validateAgainstSchema(doc, schema);
+    }
+
     // Validate multiple files
     std::vector<std::pair<std::string, ValidationResult>> validateFiles(
         const std::vector<std::string>& xmlFiles,
         const std::string& xsdFile
     );
 
+    // Parse and compile the schema once and validate files on a worker pool.
+    // Results are delivered to the callback in input order, one at a time,
+    // so the callback does not need to be thread-safe.
+    // threadCount = 0 uses the hardware concurrency.
+    void validateFiles(
+        const std::vector<std::string>& xmlFiles,
+        const std::string& xsdFile,
+        const ValidationCallback& onResult,
+        size_t threadCount = 0
+    );
+
     // Expand glob patterns to file list
     static std::vector<std::string> expandPattern(const std::string& pattern);
 
+    // Check a text value against a simple type (empty values always match)
+    static bool matchesType(const char* value, XsdType type);
+
 private:
+    uintmax_t streamingThreshold_ = kDefaultStreamingThreshold;
+    ValidationCache* cache_ = nullptr;
+
+    // validateFile() through the cache, if one is set
+    ValidationResult validateCached(const std::string& xmlFile, const CompiledSchema& schema);
+
+    // Per-document working memory: the current element path (built into a
+    // string only when something is reported) and stacked counter/attribute
+    // slots for the content models being checked
+    struct ValidationScratch {
+        std::vector<const char*> path;
+        std::vector<int> counters;
+        std::vector<const char*> attributeValues;
+
+        std::string buildPath() const;
+    };
+
     ValidationResult validateAgainstSchema(
         const pugi::xml_document& doc,
-        const XsdSchema& schema
+        const CompiledSchema& schema
     );
 
     bool validateElement(
         const pugi::xml_node& node,
-        const std::shared_ptr<XsdElement>& schemaElement,
+        const CompiledSchema& schema,
+        const CompiledElement& schemaElement,
         ValidationResult& result,
-        const std::string& path
+        ValidationScratch& scratch
     );
 
     bool validateAttributes(
         const pugi::xml_node& node,
-        const std::shared_ptr<XsdElement>& schemaElement,
+        const CompiledSchema& schema,
+        const CompiledContentType& contentType,
         ValidationResult& result,
-        const std::string& path
+        ValidationScratch& scratch
     );
 
     bool validateChildren(
         const pugi::xml_node& node,
-        const std::shared_ptr<XsdElement>& schemaElement,
+        const CompiledSchema& schema,
+        const CompiledContentType& contentType,
         ValidationResult& result,
-        const std::string& path
+        ValidationScratch& scratch
     );
-
-    bool matchesType(const std::string& value, XsdType type);
 };
 
 } // namespace expocli
@@ -0,0 +1,158 @@
+#include "executor/batch_filter.h"
+#include "executor/xml_navigator.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+
+namespace expocli {
+
+namespace {
+
+using Mask = std::array<uint64_t, kBatchWords>;
+
+// A literal that is a number in full, so that text equal to it is that number
+bool wholeNumber(const std::string& text, double& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && end == text.c_str() + text.size() && errno != ERANGE;
+}
+
+bool isComparison(ComparisonOp op) {
+    switch (op) {
+        case ComparisonOp::EQUALS:
+        case ComparisonOp::NOT_EQUALS:
+        case ComparisonOp::LESS_THAN:
+        case ComparisonOp::LESS_EQUAL:
+        case ComparisonOp::GREATER_THAN:
+        case ComparisonOp::GREATER_EQUAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+std::unique_ptr<BatchFilter> BatchFilter::compile(const WhereExpr* expr) {
+    auto filter = std::unique_ptr<BatchFilter>(new BatchFilter());
+    if (!expr || !filter->append(expr)) {
+        return nullptr;
+    }
+    return filter;
+}
+
+bool BatchFilter::append(const WhereExpr* expr) {
+    if (const auto* logical = dynamic_cast<const WhereLogical*>(expr)) {
+        if (logical->op != LogicalOp::AND && logical->op != LogicalOp::OR) {
+            return false;
+        }
+        if (!logical->left || !logical->right ||
+            !append(logical->left.get()) || !append(logical->right.get())) {
+            return false;
+        }
+        Step step;
+        step.kind = logical->op == LogicalOp::AND ? Step::AND : Step::OR;
+        program_.push_back(std::move(step));
+        return true;
+    }
+
+    const auto* condition = dynamic_cast<const WhereCondition*>(expr);
+    if (!condition || condition->field.include_filename || condition->field.is_variable_ref) {
+        return false;
+    }
+
+    Step step;
+    step.condition = condition;
+    if (condition->op == ComparisonOp::IN || condition->op == ComparisonOp::NOT_IN) {
+        step.kind = condition->op == ComparisonOp::IN ? Step::IN : Step::NOT_IN;
+        for (const auto& value : condition->values) {
+            double number;
+            if (!wholeNumber(value, number)) {
+                return false;
+            }
+            step.set.push_back(number);
+        }
+    } else if (condition->is_numeric && !condition->is_temporal && isComparison(condition->op)) {
+        step.kind = Step::COMPARE;
+        if (!BatchKernels::parseNumber(condition->value.c_str(), step.literal)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    program_.push_back(std::move(step));
+    return true;
+}
+
+void BatchFilter::filter(const std::vector<pugi::xml_node>& nodes, size_t parentDepth,
+                         std::vector<uint32_t>& selection) const {
+    ColumnBatch batch;
+    std::vector<const char*> texts;
+    std::vector<Mask> stack;
+
+    for (size_t base = 0; base < nodes.size(); base += kBatchSize) {
+        size_t count = std::min(kBatchSize, nodes.size() - base);
+        stack.clear();
+
+        for (const Step& step : program_) {
+            if (step.kind == Step::AND || step.kind == Step::OR) {
+                Mask right = stack.back();
+                stack.pop_back();
+                Mask& left = stack.back();
+                for (size_t w = 0; w < kBatchWords; ++w) {
+                    left[w] = step.kind == Step::AND ? left[w] & right[w] : left[w] | right[w];
+                }
+                continue;
+            }
+
+            // Gather the field of this condition for every node of the batch;
+            // the text stays in the document
+            bool keepText = step.kind != Step::COMPARE;
+            batch.clear();
+            texts.clear();
+            for (size_t i = 0; i < count; ++i) {
+                const char* value = XmlNavigator::nodeValueRelative(nodes[base + i], step.condition->field, parentDepth);
+                batch.append(value);
+                if (keepText) {
+                    texts.push_back(value);
+                }
+            }
+
+            stack.emplace_back();
+            Mask& mask = stack.back();
+            if (step.kind == Step::COMPARE) {
+                BatchKernels::compare(batch, step.condition->op, step.literal, mask.data());
+                continue;
+            }
+
+            // Numeric hits are candidates; the text must equal one of the values
+            BatchKernels::in(batch, step.set, mask.data());
+            std::vector<uint32_t> hits;
+            BatchKernels::select(mask.data(), count, 0, hits);
+            for (uint32_t row : hits) {
+                bool found = false;
+                for (const auto& value : step.condition->values) {
+                    if (value == texts[row]) {
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    mask[row / 64] &= ~(uint64_t(1) << (row % 64));
+                }
+            }
+            if (step.kind == Step::NOT_IN) {
+                for (size_t w = 0; w < kBatchWords; ++w) {
+                    mask[w] = batch.present[w] & ~mask[w];
+                }
+            }
+        }
+
+        BatchKernels::select(stack.back().data(), count, static_cast<uint32_t>(base), selection);
+    }
+}
+
+} // namespace expocli
@@ -0,0 +1,326 @@
+#include "executor/column_batch.h"
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EXPOCLI_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace expocli {
+
+namespace {
+
+bool useAvx2 = BatchKernels::avx2Available();
+
+inline size_t wordsFor(size_t size) {
+    return (size + 63) / 64;
+}
+
+// Per-batch totals, merged into the running summary the same way by both
+// kernel flavours
+struct LaneTotals {
+    double sum[4] = {0, 0, 0, 0};
+    double min[4];
+    double max[4];
+    size_t count = 0;
+
+    LaneTotals() {
+        for (int lane = 0; lane < 4; ++lane) {
+            min[lane] = std::numeric_limits<double>::infinity();
+            max[lane] = -std::numeric_limits<double>::infinity();
+        }
+    }
+
+    void mergeInto(BatchSummary& summary) const {
+        if (count == 0) {
+            return;
+        }
+        double batchMin = min[0];
+        double batchMax = max[0];
+        for (int lane = 1; lane < 4; ++lane) {
+            if (min[lane] < batchMin) batchMin = min[lane];
+            if (max[lane] > batchMax) batchMax = max[lane];
+        }
+        if (summary.count == 0 || batchMin < summary.min) summary.min = batchMin;
+        if (summary.count == 0 || batchMax > summary.max) summary.max = batchMax;
+        summary.sum += (sum[0] + sum[1]) + (sum[2] + sum[3]);
+        summary.count += count;
+    }
+};
+
+// Rows that are both valid and selected
+inline uint64_t rowsOf(const ColumnBatch& batch, const uint64_t* selection, size_t word) {
+    return selection ? batch.valid[word] & selection[word] : batch.valid[word];
+}
+
+size_t popcount(uint64_t word) {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#else
+    size_t count = 0;
+    for (; word; word &= word - 1) ++count;
+    return count;
+#endif
+}
+
+unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+    unsigned bit = 0;
+    while (!(word & 1)) { word >>= 1; ++bit; }
+    return bit;
+#endif
+}
+
+// --- Scalar kernels -------------------------------------------------------
+
+template <typename Compare>
+void compareScalar(const ColumnBatch& batch, Compare pass, uint64_t* out) {
+    size_t words = wordsFor(batch.size);
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t bits = 0;
+        size_t base = w * 64;
+        size_t end = base + 64 < batch.size ? base + 64 : batch.size;
+        for (size_t i = base; i < end; ++i) {
+            bits |= static_cast<uint64_t>(pass(batch.values[i])) << (i - base);
+        }
+        out[w] = bits & batch.valid[w];
+    }
+}
+
+void accumulateScalar(const ColumnBatch& batch, const uint64_t* selection, LaneTotals& totals) {
+    size_t words = wordsFor(batch.size);
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t rows = rowsOf(batch, selection, w);
+        totals.count += popcount(rows);
+        for (size_t i = 0; i < 64; ++i) {
+            int lane = static_cast<int>(i % 4);
+            double v = (rows >> i) & 1 ? batch.values[w * 64 + i] : 0.0;
+            totals.sum[lane] += v;
+            if ((rows >> i) & 1) {
+                if (v < totals.min[lane]) totals.min[lane] = v;
+                if (v > totals.max[lane]) totals.max[lane] = v;
+            }
+        }
+    }
+}
+
+// --- AVX2 kernels ---------------------------------------------------------
+
+#ifdef EXPOCLI_BATCH_AVX2
+
+template <int Predicate>
+__attribute__((target("avx2")))
+void compareAvx2(const ColumnBatch& batch, double literal, uint64_t* out) {
+    const __m256d target = _mm256_set1_pd(literal);
+    size_t words = wordsFor(batch.size);
+    for (size_t w = 0; w < words; ++w) {
+        const double* values = batch.values + w * 64;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 64; i += 4) {
+            __m256d v = _mm256_load_pd(values + i);
+            uint64_t lanes = static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(v, target, Predicate)));
+            bits |= lanes << i;
+        }
+        out[w] = bits & batch.valid[w];
+    }
+}
+
+__attribute__((target("avx2")))
+void inAvx2(const ColumnBatch& batch, const std::vector<double>& set, uint64_t* out) {
+    size_t words = wordsFor(batch.size);
+    for (size_t w = 0; w < words; ++w) {
+        const double* values = batch.values + w * 64;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 64; i += 4) {
+            __m256d v = _mm256_load_pd(values + i);
+            __m256d hit = _mm256_setzero_pd();
+            for (double member : set) {
+                hit = _mm256_or_pd(hit, _mm256_cmp_pd(v, _mm256_set1_pd(member), _CMP_EQ_OQ));
+            }
+            bits |= static_cast<uint64_t>(_mm256_movemask_pd(hit)) << i;
+        }
+        out[w] = bits & batch.valid[w];
+    }
+}
+
+__attribute__((target("avx2")))
+void accumulateAvx2(const ColumnBatch& batch, const uint64_t* selection, LaneTotals& totals) {
+    // Lane masks for every 4-bit group of a bitmap
+    alignas(32) static const int64_t kLaneMasks[16][4] = {
+        {0, 0, 0, 0}, {-1, 0, 0, 0}, {0, -1, 0, 0}, {-1, -1, 0, 0},
+        {0, 0, -1, 0}, {-1, 0, -1, 0}, {0, -1, -1, 0}, {-1, -1, -1, 0},
+        {0, 0, 0, -1}, {-1, 0, 0, -1}, {0, -1, 0, -1}, {-1, -1, 0, -1},
+        {0, 0, -1, -1}, {-1, 0, -1, -1}, {0, -1, -1, -1}, {-1, -1, -1, -1},
+    };
+
+    __m256d sum = _mm256_loadu_pd(totals.sum);
+    __m256d min = _mm256_loadu_pd(totals.min);
+    __m256d max = _mm256_loadu_pd(totals.max);
+    const __m256d zero = _mm256_setzero_pd();
+
+    size_t words = wordsFor(batch.size);
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t rows = rowsOf(batch, selection, w);
+        totals.count += popcount(rows);
+        const double* values = batch.values + w * 64;
+        for (size_t i = 0; i < 64; i += 4) {
+            __m256d mask = _mm256_castsi256_pd(
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(kLaneMasks[(rows >> i) & 0xF])));
+            __m256d v = _mm256_load_pd(values + i);
+            sum = _mm256_add_pd(sum, _mm256_blendv_pd(zero, v, mask));
+            min = _mm256_blendv_pd(min, v, _mm256_and_pd(mask, _mm256_cmp_pd(v, min, _CMP_LT_OQ)));
+            max = _mm256_blendv_pd(max, v, _mm256_and_pd(mask, _mm256_cmp_pd(v, max, _CMP_GT_OQ)));
+        }
+    }
+
+    _mm256_storeu_pd(totals.sum, sum);
+    _mm256_storeu_pd(totals.min, min);
+    _mm256_storeu_pd(totals.max, max);
+}
+
+#endif // EXPOCLI_BATCH_AVX2
+
+} // namespace
+
+void ColumnBatch::clear() {
+    std::memset(valid, 0, sizeof(valid));
+    std::memset(present, 0, sizeof(present));
+    size = 0;
+}
+
+void ColumnBatch::append(const char* text) {
+    double value = 0;
+    uint64_t bit = uint64_t(1) << (size % 64);
+    if (*text) {
+        present[size / 64] |= bit;
+        if (BatchKernels::parseNumber(text, value)) {
+            valid[size / 64] |= bit;
+        } else {
+            value = 0;
+        }
+    }
+    values[size++] = value;
+}
+
+bool BatchKernels::avx2Available() {
+#ifdef EXPOCLI_BATCH_AVX2
+    // Also called from a static initialiser, before the CPU model is set up
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+void BatchKernels::setAvx2(bool enabled) {
+    useAvx2 = enabled && avx2Available();
+}
+
+bool BatchKernels::usingAvx2() {
+    return useAvx2;
+}
+
+void BatchKernels::compare(const ColumnBatch& batch, ComparisonOp op, double literal, uint64_t* out) {
+    std::memset(out, 0, kBatchWords * sizeof(uint64_t));
+#ifdef EXPOCLI_BATCH_AVX2
+    if (useAvx2) {
+        switch (op) {
+            case ComparisonOp::EQUALS:        compareAvx2<_CMP_EQ_OQ>(batch, literal, out); return;
+            case ComparisonOp::NOT_EQUALS:    compareAvx2<_CMP_NEQ_UQ>(batch, literal, out); return;
+            case ComparisonOp::LESS_THAN:     compareAvx2<_CMP_LT_OQ>(batch, literal, out); return;
+            case ComparisonOp::LESS_EQUAL:    compareAvx2<_CMP_LE_OQ>(batch, literal, out); return;
+            case ComparisonOp::GREATER_THAN:  compareAvx2<_CMP_GT_OQ>(batch, literal, out); return;
+            case ComparisonOp::GREATER_EQUAL: compareAvx2<_CMP_GE_OQ>(batch, literal, out); return;
+            default: return;
+        }
+    }
+#endif
+    switch (op) {
+        case ComparisonOp::EQUALS:        compareScalar(batch, [=](double v) { return v == literal; }, out); return;
+        case ComparisonOp::NOT_EQUALS:    compareScalar(batch, [=](double v) { return v != literal; }, out); return;
+        case ComparisonOp::LESS_THAN:     compareScalar(batch, [=](double v) { return v < literal; }, out); return;
+        case ComparisonOp::LESS_EQUAL:    compareScalar(batch, [=](double v) { return v <= literal; }, out); return;
+        case ComparisonOp::GREATER_THAN:  compareScalar(batch, [=](double v) { return v > literal; }, out); return;
+        case ComparisonOp::GREATER_EQUAL: compareScalar(batch, [=](double v) { return v >= literal; }, out); return;
+        default: return;
+    }
+}
+
+void BatchKernels::in(const ColumnBatch& batch, const std::vector<double>& set, uint64_t* out) {
+    std::memset(out, 0, kBatchWords * sizeof(uint64_t));
+#ifdef EXPOCLI_BATCH_AVX2
+    if (useAvx2) {
+        inAvx2(batch, set, out);
+        return;
+    }
+#endif
+    compareScalar(batch, [&](double v) {
+        bool hit = false;
+        for (double member : set) {
+            hit |= v == member;
+        }
+        return hit;
+    }, out);
+}
+
+void BatchKernels::accumulate(const ColumnBatch& batch, const uint64_t* selection, BatchSummary& summary) {
+    LaneTotals totals;
+#ifdef EXPOCLI_BATCH_AVX2
+    if (useAvx2) {
+        accumulateAvx2(batch, selection, totals);
+        totals.mergeInto(summary);
+        return;
+    }
+#endif
+    accumulateScalar(batch, selection, totals);
+    totals.mergeInto(summary);
+}
+
+void BatchKernels::select(const uint64_t* mask, size_t size, uint32_t base, std::vector<uint32_t>& indices) {
+    size_t words = wordsFor(size);
+    for (size_t w = 0; w < words; ++w) {
+        for (uint64_t bits = mask[w]; bits; bits &= bits - 1) {
+            size_t row = w * 64 + lowestBit(bits);
+            if (row < size) {
+                indices.push_back(base + static_cast<uint32_t>(row));
+            }
+        }
+    }
+}
+
+bool BatchKernels::parseNumber(const char* text, double& value) {
+#if defined(__cpp_lib_to_chars)
+    // Plain decimals take the fast path; from_chars rounds exactly as strtod
+    // does. Whitespace, signs, hex, and zero or subnormal results (where
+    // strtod reports underflow) go through strtod below.
+    const char* start = *text == '-' ? text + 1 : text;
+    if ((*start >= '0' && *start <= '9') || *start == '.') {
+        bool hex = start[0] == '0' && (start[1] == 'x' || start[1] == 'X');
+        const char* end = text + std::strlen(text);
+        auto result = std::from_chars(text, end, value);
+        if (!hex && result.ec == std::errc() &&
+            std::fabs(value) >= std::numeric_limits<double>::min() &&
+            std::fabs(value) <= std::numeric_limits<double>::max()) {
+            return true;
+        }
+    }
+#endif
+    char* end = nullptr;
+    int savedErrno = errno;
+    errno = 0;
+    value = std::strtod(text, &end);
+    bool ok = end != text && errno != ERANGE;
+    if (errno == 0) {
+        errno = savedErrno;
+    }
+    return ok;
+}
+
+} // namespace expocli
@@ -0,0 +1,338 @@
+#include "executor/element_counter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace expocli {
+
+namespace {
+
+// Name characters as the parser reads them (bytes >= 0x80 are part of names)
+bool nameStart(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' || c >= 0x80;
+}
+
+bool nameChar(unsigned char c) {
+    return nameStart(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+bool space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool allSpace(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        if (!space(*p)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* skipName(const char* p, const char* end) {
+    while (p < end && nameChar(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+    return p;
+}
+
+// First occurrence of token in [p, end), or nullptr
+const char* find(const char* p, const char* end, const char* token) {
+    size_t length = std::strlen(token);
+    while (end - p >= static_cast<std::ptrdiff_t>(length)) {
+        p = static_cast<const char*>(std::memchr(p, token[0], static_cast<size_t>(end - p) - length + 1));
+        if (!p) {
+            return nullptr;
+        }
+        if (std::memcmp(p, token, length) == 0) {
+            return p;
+        }
+        ++p;
+    }
+    return nullptr;
+}
+
+bool startsWith(const char* p, const char* end, const char* token) {
+    size_t length = std::strlen(token);
+    return static_cast<size_t>(end - p) >= length && std::memcmp(p, token, length) == 0;
+}
+
+// The XML declaration [p, end) names no encoding, or UTF-8
+bool declaresUtf8(const char* p, const char* end) {
+    const char* at = find(p, end, "encoding");
+    if (!at) {
+        return true;
+    }
+    at += 8;
+    while (at < end && (space(*at) || *at == '=')) {
+        ++at;
+    }
+    if (at == end || (*at != '"' && *at != '\'')) {
+        return false;
+    }
+    const char* close = static_cast<const char*>(std::memchr(at + 1, *at, static_cast<size_t>(end - at - 1)));
+    if (!close) {
+        return false;
+    }
+    std::string encoding(at + 1, close);
+    for (auto& c : encoding) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return encoding == "utf-8" || encoding == "utf8";
+}
+
+struct Name {
+    const char* text;
+    size_t length;
+
+    bool operator==(const Name& other) const {
+        return length == other.length && std::memcmp(text, other.text, length) == 0;
+    }
+    bool operator==(const std::string& other) const {
+        return length == other.size() && std::memcmp(text, other.data(), length) == 0;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<ElementCounter> ElementCounter::compile(const FieldPath& field) {
+    if (field.include_filename || field.is_variable_ref || field.is_attribute ||
+        field.is_anchored || field.components.empty()) {
+        return nullptr;
+    }
+    for (const auto& component : field.components) {
+        if (component.empty() || !nameStart(static_cast<unsigned char>(component[0]))) {
+            return nullptr;
+        }
+    }
+    auto counter = std::unique_ptr<ElementCounter>(new ElementCounter());
+    counter->path_ = field.components;
+    counter->partial_ = field.is_partial_path;
+    return counter;
+}
+
+bool ElementCounter::count(const char* data, size_t size, size_t& result) const {
+    const char* p = data;
+    const char* end = data + size;
+
+    // UTF-16 and UTF-32 are converted by the parser
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && ((bytes[0] == 0xFE && bytes[1] == 0xFF) || (bytes[0] == 0xFF && bytes[1] == 0xFE))) {
+        return false;
+    }
+    if (std::memchr(data, 0, std::min<size_t>(size, 4)) != nullptr) {
+        return false;
+    }
+    if (startsWith(p, end, "\xEF\xBB\xBF")) {
+        p += 3;
+    }
+    const char* documentStart = p;
+
+    // Open elements; pending while a match has not met its first text child
+    struct Open {
+        Name name;
+        bool pending;
+    };
+    std::vector<Open> open;
+    std::vector<Name> firstMatch;
+    bool rootSeen = false;
+    size_t counted = 0;
+
+    // Only a path without a leading dot and a single name is tied to the root
+    const bool rootOnly = !partial_ && path_.size() == 1;
+    const size_t parents = path_.size() - 1;
+    auto matches = [&](const Name& name) {
+        if (!(name == path_.back())) {
+            return false;
+        }
+        if (rootOnly) {
+            return open.empty();
+        }
+        if (open.size() < parents) {
+            return false;
+        }
+        for (size_t i = 0; i < parents; ++i) {
+            if (!(open[open.size() - parents + i].name == path_[i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // A partial path must resolve to one location; at a second one the DOM
+    // path reports the ambiguity
+    auto sameLocation = [&](const Name& name) {
+        if (firstMatch.empty()) {
+            for (const auto& element : open) {
+                firstMatch.push_back(element.name);
+            }
+            firstMatch.push_back(name);
+            return true;
+        }
+        if (firstMatch.size() != open.size() + 1 || !(firstMatch.back() == name)) {
+            return false;
+        }
+        for (size_t i = 0; i < open.size(); ++i) {
+            if (!(firstMatch[i] == open[i].name)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    while (p < end) {
+        if (*p != '<') {
+            const char* next = static_cast<const char*>(std::memchr(p, '<', static_cast<size_t>(end - p)));
+            if (!next) {
+                next = end;
+            }
+            if (open.empty()) {
+                if (!allSpace(p, next)) {
+                    return false;
+                }
+            } else if (open.back().pending && !allSpace(p, next)) {
+                open.back().pending = false;
+                ++counted;
+            }
+            p = next;
+            continue;
+        }
+
+        if (end - p < 2) {
+            return false;
+        }
+        const char kind = p[1];
+
+        if (kind == '/') {
+            if (open.empty()) {
+                return false;
+            }
+            const char* nameEnd = skipName(p + 2, end);
+            Name name{p + 2, static_cast<size_t>(nameEnd - p - 2)};
+            if (!(name == open.back().name)) {
+                return false;
+            }
+            while (nameEnd < end && space(*nameEnd)) {
+                ++nameEnd;
+            }
+            if (nameEnd == end || *nameEnd != '>') {
+                return false;
+            }
+            open.pop_back();
+            p = nameEnd + 1;
+            continue;
+        }
+
+        if (kind == '!') {
+            if (startsWith(p, end, "<!--")) {
+                const char* close = find(p + 4, end, "-->");
+                if (!close) {
+                    return false;
+                }
+                p = close + 3;
+                continue;
+            }
+            if (startsWith(p, end, "<![CDATA[") && !open.empty()) {
+                const char* close = find(p + 9, end, "]]>");
+                if (!close) {
+                    return false;
+                }
+                if (open.back().pending) {
+                    open.back().pending = false;
+                    if (close > p + 9) {
+                        ++counted;
+                    }
+                }
+                p = close + 3;
+                continue;
+            }
+            // DOCTYPE (possibly declaring entities and defaults) and the rest
+            return false;
+        }
+
+        if (kind == '?') {
+            const char* close = find(p + 2, end, "?>");
+            const char* targetEnd = skipName(p + 2, end);
+            if (!close || targetEnd == p + 2 || !nameStart(static_cast<unsigned char>(p[2]))) {
+                return false;
+            }
+            if (targetEnd - p == 5 && (p[2] | 0x20) == 'x' && (p[3] | 0x20) == 'm' && (p[4] | 0x20) == 'l') {
+                if (p != documentStart || !declaresUtf8(targetEnd, close)) {
+                    return false;
+                }
+            }
+            p = close + 2;
+            continue;
+        }
+
+        // Start tag; a document has a single root
+        if (!nameStart(static_cast<unsigned char>(kind)) || (open.empty() && rootSeen)) {
+            return false;
+        }
+        const char* q = skipName(p + 1, end);
+        Name name{p + 1, static_cast<size_t>(q - p - 1)};
+        bool selfClosing = false;
+        for (;;) {
+            const char* s = q;
+            while (s < end && space(*s)) {
+                ++s;
+            }
+            if (s == end) {
+                return false;
+            }
+            if (*s == '>') {
+                q = s + 1;
+                break;
+            }
+            if (*s == '/') {
+                if (s + 1 == end || s[1] != '>') {
+                    return false;
+                }
+                selfClosing = true;
+                q = s + 2;
+                break;
+            }
+            // Attribute: whitespace, name, '=', quoted value
+            if (s == q || !nameStart(static_cast<unsigned char>(*s))) {
+                return false;
+            }
+            s = skipName(s, end);
+            while (s < end && space(*s)) {
+                ++s;
+            }
+            if (s == end || *s != '=') {
+                return false;
+            }
+            ++s;
+            while (s < end && space(*s)) {
+                ++s;
+            }
+            if (s == end || (*s != '"' && *s != '\'')) {
+                return false;
+            }
+            const char* close = static_cast<const char*>(std::memchr(s + 1, *s, static_cast<size_t>(end - s - 1)));
+            if (!close) {
+                return false;
+            }
+            q = close + 1;
+        }
+
+        bool match = matches(name);
+        if (match && partial_ && !sameLocation(name)) {
+            return false;
+        }
+        rootSeen = true;
+        if (!selfClosing) {
+            open.push_back({name, match});
+        }
+        p = q;
+    }
+
+    if (!open.empty() || !rootSeen) {
+        return false;
+    }
+    result = counted;
+    return true;
+}
+
+} // namespace expocli
@@ -0,0 +1,390 @@
+#include "executor/incremental_state.h"
+#include "utils/xml_loader.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <unistd.h>
+
+namespace expocli {
+
+namespace {
+
+constexpr char kStateMagic[8] = {'E', 'X', 'P', 'O', 'I', 'N', 'C', 'R'};
+constexpr uint32_t kStateVersion = 2;
+
+// Fixed-width fields in host byte order, as in the validation cache
+class StateWriter {
+public:
+    explicit StateWriter(std::string& out) : out_(out) {}
+
+    void u32(uint32_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void u64(uint64_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void str(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        out_.append(value);
+    }
+
+private:
+    std::string& out_;
+};
+
+class StateReader {
+public:
+    StateReader(const std::string& in, size_t pos) : in_(in), pos_(pos) {}
+
+    bool ok() const { return ok_; }
+
+    uint32_t u32() { return read<uint32_t>(); }
+    uint64_t u64() { return read<uint64_t>(); }
+    std::string str() {
+        uint32_t length = u32();
+        if (!ok_ || in_.size() - pos_ < length) {
+            ok_ = false;
+            return std::string();
+        }
+        pos_ += length;
+        return in_.substr(pos_ - length, length);
+    }
+
+private:
+    const std::string& in_;
+    size_t pos_;
+    bool ok_ = true;
+
+    template <typename T>
+    T read() {
+        T value = 0;
+        if (!ok_ || in_.size() - pos_ < sizeof(value)) {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, in_.data() + pos_, sizeof(value));
+        pos_ += sizeof(value);
+        return value;
+    }
+};
+
+// Where records end in a stretch of a document, found by following its tags
+// (comments, CDATA sections, processing instructions and the DOCTYPE are
+// stepped over; a construct cut off by the end of the bytes ends the scan)
+struct RecordScan {
+    size_t headerEnd = 0;       // Just past the root start tag (0: not seen)
+    std::string root;
+    size_t lastRecordEnd = 0;   // Just past the last complete child of the root (0: none)
+    bool rootClosed = false;
+};
+
+RecordScan scanRecords(std::string_view data, int depth) {
+    RecordScan scan;
+    size_t i = 0;
+    while ((i = data.find('<', i)) != std::string_view::npos) {
+        std::string_view rest = data.substr(i);
+        size_t end = std::string_view::npos;
+        if (rest.compare(0, 4, "<!--") == 0) {
+            end = rest.find("-->", 4);
+            if (end == std::string_view::npos) {
+                break;
+            }
+            i += end + 3;
+            continue;
+        }
+        if (rest.compare(0, 9, "<![CDATA[") == 0) {
+            end = rest.find("]]>", 9);
+            if (end == std::string_view::npos) {
+                break;
+            }
+            i += end + 3;
+            continue;
+        }
+        if (rest.compare(0, 2, "<?") == 0) {
+            end = rest.find("?>", 2);
+            if (end == std::string_view::npos) {
+                break;
+            }
+            i += end + 2;
+            continue;
+        }
+
+        // Tags end at a '>' outside quoted values (and the DOCTYPE outside
+        // its internal subset)
+        char quote = 0;
+        int brackets = 0;
+        for (size_t j = 1; j < rest.size(); ++j) {
+            char c = rest[j];
+            if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                }
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '[') {
+                ++brackets;
+            } else if (c == ']') {
+                --brackets;
+            } else if (c == '>' && brackets <= 0) {
+                end = j;
+                break;
+            }
+        }
+        if (end == std::string_view::npos || rest.size() < 2) {
+            break;
+        }
+        size_t next = i + end + 1;
+
+        if (rest[1] == '!') {
+            // DOCTYPE
+        } else if (rest[1] == '/') {
+            if (--depth <= 0) {
+                scan.rootClosed = true;
+                break;
+            }
+            if (depth == 1) {
+                scan.lastRecordEnd = next;
+            }
+        } else if (rest[end - 1] == '/') {
+            if (depth == 0) {
+                // An empty root has no records
+                scan.rootClosed = true;
+                break;
+            }
+            if (depth == 1) {
+                scan.lastRecordEnd = next;
+            }
+        } else {
+            if (depth == 0) {
+                size_t nameEnd = rest.find_first_of(" \t\r\n/>", 1);
+                scan.root = std::string(rest.substr(1, nameEnd - 1));
+                scan.headerEnd = next;
+            }
+            ++depth;
+        }
+        i = next;
+    }
+    return scan;
+}
+
+// The last kTailBytes of data
+std::string tailOf(const std::string& data) {
+    size_t keep = std::min(data.size(), IncrementalState::kTailBytes);
+    return data.substr(data.size() - keep);
+}
+
+} // namespace
+
+IncrementalState::IncrementalState(const std::string& path, const std::string& queryText)
+    : path_(path), query_(queryText) {
+    load();
+}
+
+bool IncrementalState::supports(const Query& query) {
+    return query.for_clauses.empty() && query.validate_schema.empty();
+}
+
+void IncrementalState::load() {
+    std::ifstream in(path_, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return;
+    }
+    std::string data(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    if (!in.read(&data[0], static_cast<std::streamsize>(data.size())) ||
+        data.size() < sizeof(kStateMagic) ||
+        std::memcmp(data.data(), kStateMagic, sizeof(kStateMagic)) != 0) {
+        return;
+    }
+
+    StateReader reader(data, sizeof(kStateMagic));
+    if (reader.u32() != kStateVersion || reader.str() != query_ || !reader.ok()) {
+        return;
+    }
+    uint32_t fileCount = reader.u32();
+    std::unordered_map<std::string, FileState> files;
+    for (uint32_t i = 0; i < fileCount && reader.ok(); ++i) {
+        std::string file = reader.str();
+        FileState state;
+        state.header = reader.str();
+        state.root = reader.str();
+        state.offset = reader.u64();
+        state.tail = reader.str();
+        uint32_t rowCount = reader.u32();
+        for (uint32_t r = 0; r < rowCount && reader.ok(); ++r) {
+            ResultRow row;
+            uint32_t fieldCount = reader.u32();
+            for (uint32_t f = 0; f < fieldCount && reader.ok(); ++f) {
+                std::string name = reader.str();
+                row.emplace_back(std::move(name), reader.str());
+            }
+            state.rows.push_back(std::move(row));
+        }
+        files[file] = std::move(state);
+    }
+    // A damaged state is ignored as a whole
+    if (reader.ok()) {
+        files_ = std::move(files);
+    }
+}
+
+bool IncrementalState::readAppended(const std::string& file, const FileState& state, Delta& delta) const {
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    uint64_t size = static_cast<uint64_t>(in.tellg());
+    if (size < state.offset || state.offset < state.tail.size() || state.offset < state.header.size()) {
+        return false;
+    }
+
+    // The same root start tag and the same bytes before the offset
+    std::string header(state.header.size(), '\0');
+    in.seekg(0);
+    if (!in.read(&header[0], static_cast<std::streamsize>(header.size())) || header != state.header) {
+        return false;
+    }
+    uint64_t from = state.offset - state.tail.size();
+    std::string appended(static_cast<size_t>(size - from), '\0');
+    in.seekg(static_cast<std::streamoff>(from));
+    if (!in.read(&appended[0], static_cast<std::streamsize>(appended.size())) ||
+        appended.compare(0, state.tail.size(), state.tail) != 0) {
+        return false;
+    }
+    delta.scanned = header.size() + appended.size();
+
+    std::string_view records(appended);
+    records.remove_prefix(state.tail.size());
+    RecordScan scan = scanRecords(records, 1);
+
+    delta.resumable = true;
+    delta.next.header = state.header;
+    delta.next.root = state.root;
+    delta.next.offset = state.offset + scan.lastRecordEnd;
+    delta.next.tail = state.tail;
+    if (scan.lastRecordEnd > 0) {
+        // The new records inside the root start tag, as a document of their own
+        std::string_view added = records.substr(0, scan.lastRecordEnd);
+        delta.bytes.reserve(state.header.size() + added.size() + state.root.size() + 3);
+        delta.bytes.append(state.header).append(added).append("</").append(state.root).append(">");
+        delta.next.tail = tailOf(std::string(appended, 0, state.tail.size() + scan.lastRecordEnd));
+    }
+    return true;
+}
+
+IncrementalState::Delta IncrementalState::read(const std::string& file) {
+    Delta delta;
+    bool known = false;
+    FileState state;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = files_.find(file);
+        if (it != files_.end()) {
+            known = true;
+            state.header = it->second.header;
+            state.root = it->second.root;
+            state.offset = it->second.offset;
+            state.tail = it->second.tail;
+            delta.rows = it->second.rows;
+        }
+    }
+    if (known) {
+        if (readAppended(file, state, delta)) {
+            ++appended_;
+            bytesRead_ += delta.scanned;
+            return delta;
+        }
+        delta = Delta();
+    }
+
+    // In full; a file still being written is taken up to its last complete record
+    std::string bytes = XmlLoader::readFile(file);
+    delta.scanned = bytes.size();
+    ++full_;
+    bytesRead_ += delta.scanned;
+
+    RecordScan scan = scanRecords(bytes, 0);
+    if (scan.headerEnd == 0) {
+        delta.bytes = std::move(bytes);
+        return delta;
+    }
+    size_t offset = std::max(scan.headerEnd, scan.lastRecordEnd);
+    delta.resumable = true;
+    delta.next.header = bytes.substr(0, scan.headerEnd);
+    delta.next.root = scan.root;
+    delta.next.offset = offset;
+    delta.next.tail = tailOf(bytes.substr(0, offset));
+    if (scan.rootClosed) {
+        delta.bytes = std::move(bytes);
+    } else {
+        bytes.resize(offset);
+        delta.bytes = std::move(bytes);
+        delta.bytes.append("</").append(scan.root).append(">");
+    }
+    return delta;
+}
+
+void IncrementalState::commit(const std::string& file, const Delta& delta, const std::vector<ResultRow>& rows) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!delta.resumable) {
+        files_.erase(file);
+        return;
+    }
+    FileState& state = files_[file];
+    state = delta.next;
+    state.rows = rows;
+}
+
+void IncrementalState::save() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out(kStateMagic, sizeof(kStateMagic));
+    StateWriter writer(out);
+    writer.u32(kStateVersion);
+    writer.str(query_);
+
+    std::vector<const std::pair<const std::string, FileState>*> present;
+    for (const auto& item : files_) {
+        std::error_code ec;
+        if (std::filesystem::exists(item.first, ec)) {
+            present.push_back(&item);
+        }
+    }
+    writer.u32(static_cast<uint32_t>(present.size()));
+    for (const auto* item : present) {
+        const FileState& state = item->second;
+        writer.str(item->first);
+        writer.str(state.header);
+        writer.str(state.root);
+        writer.u64(state.offset);
+        writer.str(state.tail);
+        writer.u32(static_cast<uint32_t>(state.rows.size()));
+        for (const auto& row : state.rows) {
+            writer.u32(static_cast<uint32_t>(row.size()));
+            for (const auto& [name, value] : row) {
+                writer.str(name);
+                writer.str(value);
+            }
+        }
+    }
+
+    // Written to a temporary file first, so an interrupted save leaves the
+    // previous state in place
+    std::filesystem::path target(path_);
+    std::filesystem::path temp = target;
+    temp += ".tmp" + std::to_string(::getpid());
+    std::error_code ec;
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+            stream.close();
+            std::filesystem::remove(temp, ec);
+            throw std::runtime_error("Cannot write incremental state file: " + path_);
+        }
+    }
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        throw std::runtime_error("Cannot write incremental state file: " + path_);
+    }
+}
+
+} // namespace expocli
@@ -0,0 +1,366 @@
+#include "executor/literal_prefilter.h"
+#include "executor/column_batch.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EXPOCLI_PREFILTER_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace expocli {
+
+namespace {
+
+// Literals of the alternatives of one clause, and an AND of clauses
+using Clause = std::vector<std::string>;
+using Requirement = std::vector<Clause>;
+
+// OR distributes over the clauses of both sides; beyond this many the
+// remaining clauses are dropped, which only makes the filter weaker
+constexpr size_t kMaxClauses = 16;
+
+// Bytes that always stand for themselves in a parsed value: printable ASCII
+// other than whitespace (normalised) and the characters the predefined
+// entities spell
+bool plain(unsigned char c) {
+    return c > 0x20 && c < 0x7F && c != '&' && c != '<' && c != '>' && c != '"' && c != '\'';
+}
+
+// The longest run of plain bytes of a literal (empty if there is none)
+std::string fragmentOf(const std::string& literal) {
+    size_t bestStart = 0, bestLength = 0;
+    for (size_t i = 0; i < literal.size();) {
+        if (!plain(static_cast<unsigned char>(literal[i]))) {
+            ++i;
+            continue;
+        }
+        size_t start = i;
+        while (i < literal.size() && plain(static_cast<unsigned char>(literal[i]))) {
+            ++i;
+        }
+        if (i - start > bestLength) {
+            bestStart = start;
+            bestLength = i - start;
+        }
+    }
+    return literal.substr(bestStart, bestLength);
+}
+
+// A clause of the literals one of which a value satisfying the condition
+// contains; false if the condition does not need any
+bool clauseOf(const WhereCondition& condition, const Query& query, Clause& clause) {
+    const FieldPath& field = condition.field;
+    if (field.include_filename ||
+        (field.is_variable_ref && query.isPositionVariable(field.variable_name))) {
+        return false;
+    }
+
+    std::vector<std::string> literals;
+    if (condition.op == ComparisonOp::EQUALS && !condition.is_numeric && !condition.is_temporal) {
+        literals.push_back(condition.value);
+    } else if (condition.op == ComparisonOp::IN) {
+        // IN compares text, numbers included
+        literals = condition.values;
+    } else {
+        return false;
+    }
+
+    for (const auto& literal : literals) {
+        // Empty values never match, so need nothing
+        if (literal.empty()) {
+            continue;
+        }
+        std::string fragment = fragmentOf(literal);
+        if (fragment.empty()) {
+            return false;
+        }
+        if (std::find(clause.begin(), clause.end(), fragment) == clause.end()) {
+            clause.push_back(std::move(fragment));
+        }
+    }
+    return !clause.empty();
+}
+
+Requirement requirementOf(const WhereExpr* expr, const Query& query) {
+    if (const auto* condition = dynamic_cast<const WhereCondition*>(expr)) {
+        Clause clause;
+        if (!clauseOf(*condition, query, clause)) {
+            return {};
+        }
+        return {clause};
+    }
+
+    const auto* logical = dynamic_cast<const WhereLogical*>(expr);
+    if (!logical || !logical->left || !logical->right) {
+        return {};
+    }
+    Requirement left = requirementOf(logical->left.get(), query);
+    Requirement right = requirementOf(logical->right.get(), query);
+
+    if (logical->op == LogicalOp::AND) {
+        left.insert(left.end(), right.begin(), right.end());
+        if (left.size() > kMaxClauses) {
+            left.resize(kMaxClauses);
+        }
+        return left;
+    }
+    if (logical->op != LogicalOp::OR || left.empty() || right.empty()) {
+        return {};
+    }
+
+    // (a AND b) OR (c AND d) = (a OR c) AND (a OR d) AND (b OR c) AND (b OR d)
+    Requirement either;
+    for (const auto& a : left) {
+        for (const auto& b : right) {
+            if (either.size() == kMaxClauses) {
+                return either;
+            }
+            Clause clause = a;
+            for (const auto& literal : b) {
+                if (std::find(clause.begin(), clause.end(), literal) == clause.end()) {
+                    clause.push_back(literal);
+                }
+            }
+            either.push_back(std::move(clause));
+        }
+    }
+    return either;
+}
+
+bool containsScalar(const char* data, size_t size, const std::string& pattern) {
+    std::boyer_moore_horspool_searcher<std::string::const_iterator> searcher(pattern.begin(), pattern.end());
+    return std::search(data, data + size, searcher) != data + size;
+}
+
+#ifdef EXPOCLI_PREFILTER_AVX2
+// Compare the first and last byte of the pattern at 32 positions at once and
+// confirm the candidates (W. Mula's SIMD-friendly substring search)
+__attribute__((target("avx2")))
+bool containsAvx2(const char* data, size_t size, const std::string& pattern) {
+    const size_t length = pattern.size();
+    const char* needle = pattern.data();
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[length - 1]);
+
+    size_t i = 0;
+    for (; i + length - 1 + 32 <= size; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + length - 1));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+        while (mask) {
+            size_t at = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (std::memcmp(data + at + 1, needle + 1, length - 2) == 0) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; i + length <= size; ++i) {
+        if (data[i] == needle[0] && std::memcmp(data + i + 1, needle + 1, length - 1) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif // EXPOCLI_PREFILTER_AVX2
+
+} // namespace
+
+std::unique_ptr<LiteralPrefilter> LiteralPrefilter::compile(const Query& query) {
+    if (!query.where || !query.validate_schema.empty()) {
+        return nullptr;
+    }
+    Requirement requirement = requirementOf(query.where.get(), query);
+    if (requirement.empty()) {
+        return nullptr;
+    }
+
+    auto prefilter = std::unique_ptr<LiteralPrefilter>(new LiteralPrefilter());
+    for (const auto& clause : requirement) {
+        std::vector<uint32_t> ids;
+        for (const auto& literal : clause) {
+            auto it = std::find(prefilter->patterns_.begin(), prefilter->patterns_.end(), literal);
+            ids.push_back(static_cast<uint32_t>(it - prefilter->patterns_.begin()));
+            if (it == prefilter->patterns_.end()) {
+                prefilter->patterns_.push_back(literal);
+            }
+        }
+        prefilter->clauses_.push_back(std::move(ids));
+    }
+    if (prefilter->patterns_.size() > kDirectPatterns) {
+        prefilter->buildAutomaton();
+    }
+    return prefilter;
+}
+
+bool LiteralPrefilter::contains(const char* data, size_t size, const std::string& pattern) {
+    if (pattern.size() <= 1) {
+        return pattern.empty() || std::memchr(data, pattern[0], size) != nullptr;
+    }
+    if (size < pattern.size()) {
+        return false;
+    }
+#ifdef EXPOCLI_PREFILTER_AVX2
+    if (BatchKernels::usingAvx2()) {
+        return containsAvx2(data, size, pattern);
+    }
+#endif
+    return containsScalar(data, size, pattern);
+}
+
+bool LiteralPrefilter::mayMatch(const char* data, size_t size) const {
+    // UTF-16 and UTF-32 (with or without a byte order mark) are converted
+    // before parsing; their bytes say nothing about the literals
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && ((bytes[0] == 0xFE && bytes[1] == 0xFF) || (bytes[0] == 0xFF && bytes[1] == 0xFE))) {
+        return true;
+    }
+    if (std::memchr(data, 0, std::min<size_t>(size, 4)) != nullptr) {
+        return true;
+    }
+
+    if (clausesHold(data, size)) {
+        return true;
+    }
+
+    // A literal might still be spelled with character references or entities
+    return contains(data, size, "&#") || contains(data, size, "<!ENTITY");
+}
+
+bool LiteralPrefilter::clausesHold(const char* data, size_t size) const {
+    if (!automaton_) {
+        for (const auto& clause : clauses_) {
+            bool found = false;
+            for (uint32_t id : clause) {
+                if (contains(data, size, patterns_[id])) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<char> patternSeen(patterns_.size(), 0);
+    std::vector<char> clauseHeld(clauses_.size(), 0);
+    size_t open = clauses_.size();
+
+    const Automaton& automaton = *automaton_;
+    const uint32_t classCount = automaton.classCount;
+    uint32_t state = 0;
+    for (size_t i = 0; i < size; ++i) {
+        // From the start state, most bytes lead straight back to it
+        if (state == 0) {
+            while (i < size && !automaton.starts[static_cast<unsigned char>(data[i])]) {
+                ++i;
+            }
+            if (i == size) {
+                break;
+            }
+        }
+        state = automaton.next[state * classCount + automaton.classOf[static_cast<unsigned char>(data[i])]];
+        if (!automaton.accepting[state]) {
+            continue;
+        }
+        for (uint32_t id : automaton.output[state]) {
+            if (patternSeen[id]) {
+                continue;
+            }
+            patternSeen[id] = 1;
+            for (uint32_t c : automaton.clausesOf[id]) {
+                if (!clauseHeld[c]) {
+                    clauseHeld[c] = 1;
+                    if (--open == 0) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void LiteralPrefilter::buildAutomaton() {
+    automaton_.reset(new Automaton());
+    Automaton& automaton = *automaton_;
+
+    // Bytes that occur in no pattern share class 0
+    for (const auto& pattern : patterns_) {
+        for (unsigned char c : pattern) {
+            if (automaton.classOf[c] == 0) {
+                automaton.classOf[c] = static_cast<uint8_t>(automaton.classCount++);
+            }
+        }
+    }
+    const uint32_t classCount = automaton.classCount;
+    automaton.clausesOf.resize(patterns_.size());
+    for (uint32_t c = 0; c < clauses_.size(); ++c) {
+        for (uint32_t id : clauses_[c]) {
+            automaton.clausesOf[id].push_back(c);
+        }
+    }
+    constexpr uint32_t none = UINT32_MAX;
+
+    // Trie of the patterns
+    automaton.next.assign(classCount, none);
+    automaton.output.emplace_back();
+    for (uint32_t id = 0; id < patterns_.size(); ++id) {
+        uint32_t state = 0;
+        for (unsigned char c : patterns_[id]) {
+            uint32_t& target = automaton.next[state * classCount + automaton.classOf[c]];
+            if (target == none) {
+                target = static_cast<uint32_t>(automaton.output.size());
+                automaton.output.emplace_back();
+                automaton.next.resize(automaton.next.size() + classCount, none);
+            }
+            state = automaton.next[state * classCount + automaton.classOf[c]];
+        }
+        automaton.output[state].push_back(id);
+    }
+
+    // Breadth-first, complete each state's transitions with those of its
+    // failure state and inherit its matches
+    std::vector<uint32_t> failure(automaton.output.size(), 0);
+    std::deque<uint32_t> queue;
+    for (uint32_t k = 0; k < classCount; ++k) {
+        uint32_t& target = automaton.next[k];
+        if (target == none) {
+            target = 0;
+        } else {
+            queue.push_back(target);
+        }
+    }
+    while (!queue.empty()) {
+        uint32_t state = queue.front();
+        queue.pop_front();
+        const auto& inherited = automaton.output[failure[state]];
+        automaton.output[state].insert(automaton.output[state].end(), inherited.begin(), inherited.end());
+        for (uint32_t k = 0; k < classCount; ++k) {
+            uint32_t fallback = automaton.next[failure[state] * classCount + k];
+            uint32_t& target = automaton.next[state * classCount + k];
+            if (target == none) {
+                target = fallback;
+            } else {
+                failure[target] = fallback;
+                queue.push_back(target);
+            }
+        }
+    }
+
+    for (unsigned c = 0; c < 256; ++c) {
+        automaton.starts[c] = automaton.next[automaton.classOf[c]] != 0;
+    }
+    automaton.accepting.resize(automaton.output.size());
+    for (size_t state = 0; state < automaton.output.size(); ++state) {
+        automaton.accepting[state] = !automaton.output[state].empty();
+    }
+}
+
+} // namespace expocli
@@ -0,0 +1,201 @@
+#include "executor/memory_budget.h"
+#include "executor/region_index.h"
+#include "utils/xml_loader.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define EXPOCLI_MALLINFO2 1
+#include <malloc.h>
+#endif
+
+namespace expocli {
+
+namespace {
+
+// Used where the heap cannot be measured, and the bounds of a measurement
+constexpr double kDefaultExpansion = 4.0;
+constexpr double kMinExpansion = 2.0;
+constexpr double kMaxExpansion = 20.0;
+
+std::atomic<uint64_t> limitBytes{0};
+
+std::mutex budgetMutex;
+std::condition_variable budgetChanged;
+uint64_t reservedBytes = 0;
+uint64_t peakBytes = 0;
+uint64_t nextTicket = 0;
+uint64_t serving = 0;
+
+#ifdef EXPOCLI_MALLINFO2
+size_t heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// Records with short text fields and an attribute, like most query corpora
+std::string sampleDocument() {
+    std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<items>\n";
+    for (int i = 0; xml.size() < 256 * 1024; ++i) {
+        std::string n = std::to_string(i);
+        xml += "  <item id=\"" + n + "\">\n    <name>Item " + n + "</name>\n    <category>Category " +
+               std::to_string(i % 17) + "</category>\n    <price>" + n + ".5</price>\n  </item>\n";
+    }
+    xml += "</items>\n";
+    return xml;
+}
+
+double measureExpansion() {
+    std::string xml = sampleDocument();
+    size_t before = heapInUse();
+    {
+        // What processFile holds at once: the bytes, the DOM and its index
+        std::string bytes = xml;
+        auto doc = XmlLoader::load("<sample>", bytes);
+        DocumentIndex index(*doc);
+        index.get();
+        size_t after = heapInUse();
+        if (after > before) {
+            return std::clamp(static_cast<double>(after - before) / static_cast<double>(xml.size()),
+                              kMinExpansion, kMaxExpansion);
+        }
+    }
+    return kDefaultExpansion;
+}
+#endif // EXPOCLI_MALLINFO2
+
+} // namespace
+
+void MemoryBudget::setLimit(uint64_t bytes) {
+    if (bytes > 0) {
+        // Measure now, on the calling thread, rather than during a query
+        expansionFactor();
+    }
+    {
+        std::lock_guard<std::mutex> lock(budgetMutex);
+        limitBytes = bytes;
+        peakBytes = reservedBytes;
+    }
+    budgetChanged.notify_all();
+}
+
+uint64_t MemoryBudget::limit() {
+    return limitBytes;
+}
+
+bool MemoryBudget::parseSize(const std::string& text, uint64_t& bytes) {
+    size_t i = 0;
+    while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) {
+        ++i;
+    }
+    size_t digits = i;
+    uint64_t value = 0;
+    for (; i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])); ++i) {
+        if (value > (UINT64_MAX - 9) / 10) {
+            return false;
+        }
+        value = value * 10 + static_cast<uint64_t>(text[i] - '0');
+    }
+    if (i == digits) {
+        return false;
+    }
+
+    std::string unit;
+    for (; i < text.size(); ++i) {
+        if (!std::isspace(static_cast<unsigned char>(text[i]))) {
+            unit += static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+        }
+    }
+    static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    uint64_t multiplier = 1;
+    for (const char* name : units) {
+        if (unit.empty() || unit == name) {
+            if (value > UINT64_MAX / multiplier) {
+                return false;
+            }
+            bytes = value * multiplier;
+            return true;
+        }
+        multiplier *= 1024;
+    }
+    return false;
+}
+
+double MemoryBudget::expansionFactor() {
+    static std::once_flag once;
+    static double factor = kDefaultExpansion;
+#ifdef EXPOCLI_MALLINFO2
+    std::call_once(once, []() {
+        try {
+            factor = measureExpansion();
+        } catch (const std::exception&) {
+            factor = kDefaultExpansion;
+        }
+    });
+#else
+    (void)once;
+#endif
+    return factor;
+}
+
+uint64_t MemoryBudget::estimate(uint64_t fileBytes) {
+    return static_cast<uint64_t>(static_cast<double>(fileBytes) * expansionFactor());
+}
+
+MemoryBudget::Reservation& MemoryBudget::Reservation::operator=(Reservation&& other) noexcept {
+    if (this != &other) {
+        release();
+        bytes_ = other.bytes_;
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+void MemoryBudget::Reservation::release() {
+    if (bytes_ == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(budgetMutex);
+        reservedBytes -= bytes_;
+    }
+    bytes_ = 0;
+    budgetChanged.notify_all();
+}
+
+MemoryBudget::Reservation MemoryBudget::reserve(uint64_t bytes) {
+    if (limitBytes == 0 || bytes == 0) {
+        return Reservation();
+    }
+
+    std::unique_lock<std::mutex> lock(budgetMutex);
+    uint64_t ticket = nextTicket++;
+    // In turn; admitted once it fits, or alone when it never would
+    budgetChanged.wait(lock, [&]() {
+        uint64_t limit = limitBytes;
+        return ticket == serving &&
+               (limit == 0 || reservedBytes == 0 || reservedBytes + bytes <= limit);
+    });
+    ++serving;
+    reservedBytes += bytes;
+    peakBytes = std::max(peakBytes, reservedBytes);
+    lock.unlock();
+    budgetChanged.notify_all();
+    return Reservation(bytes);
+}
+
+uint64_t MemoryBudget::peak() {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    return peakBytes;
+}
+
+void MemoryBudget::resetPeak() {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    peakBytes = reservedBytes;
+}
+
+} // namespace expocli
@@ -1,5 +1,12 @@
 #include "executor/query_executor.h"
+#include "executor/batch_filter.h"
+#include "executor/element_counter.h"
+#include "executor/memory_budget.h"
+#include "executor/scan_checkpoint.h"
+#include "executor/incremental_state.h"
 #include "utils/xml_loader.h"
+#include "utils/temporal.h"
+#include "validator/xml_validator.h"
 #include <filesystem>
 #include <iostream>
 #include <algorithm>
@@ -7,9 +14,12 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <exception>
 #include <chrono>
 #include <limits>
 #include <set>
+#include <cstdio>
+#include <sstream>
 
 namespace expocli {
 
@@ -32,17 +42,115 @@ static FieldPath extractFieldPathFromWhere(const WhereExpr* expr) {
     return FieldPath();
 }
 
-std::vector<ResultRow> QueryExecutor::execute(const Query& query) {
+// A query that only counts one element path, which files can answer
+// without a DOM (WHERE is not applied to aggregates, so none is allowed)
+static bool isElementCount(const Query& query) {
+    return query.select_fields.size() == 1 &&
+           query.select_fields[0].aggregate == AggregateFunc::COUNT &&
+           !query.select_fields[0].is_attribute &&
+           !query.where && query.for_clauses.empty() && query.group_by_fields.empty() &&
+           query.validate_schema.empty();
+}
+
+// VALIDATE AGAINST found a document invalid: abort the query under FAIL,
+// else mark the document skipped
+static void rejectDocument(const Query& query, const std::string& filepath, const std::string& reason,
+                           bool* invalid) {
+    if (query.invalid_policy == InvalidDocumentPolicy::FAIL) {
+        throw DocumentValidationError(filepath + " is not valid against " + query.validate_schema + ": " + reason);
+    }
+    if (invalid) {
+        *invalid = true;
+    }
+}
+
+// After the scan: fail if a limit was hit, or keep the rows so far (at most
+// MAX_ROWS of them) when partial results were asked for
+static void finishScan(const QueryGuard* guard, std::vector<ResultRow>& rows, ExecutionStats* stats) {
+    if (!guard || !guard->stopped()) {
+        return;
+    }
+    guard->finish();
+    uint64_t maxRows = guard->limits().max_rows;
+    if (maxRows > 0 && rows.size() > maxRows) {
+        rows.resize(maxRows);
+    }
+    if (stats) {
+        stats->limit_reached = guard->reason();
+    }
+}
+
+std::vector<ResultRow> QueryExecutor::execute(const Query& query, ExecutionStats* stats,
+                                              const QueryLimits& limits, ScanCheckpoint* checkpoint,
+                                              IncrementalState* incremental) {
+    auto startTime = std::chrono::high_resolution_clock::now();
     std::vector<ResultRow> allResults;
 
+    // Checked cooperatively while files are scanned
+    std::unique_ptr<QueryGuard> guard;
+    if (limits.any()) {
+        guard = std::make_unique<QueryGuard>(limits);
+    }
+
+    // Record the duration of each stage since the previous mark
+    auto stageStart = startTime;
+    auto markStage = [&](const char* name) {
+        auto now = std::chrono::high_resolution_clock::now();
+        if (stats) {
+            std::chrono::duration<double, std::milli> ms = now - stageStart;
+            stats->stages.push_back({name, ms.count()});
+        }
+        stageStart = now;
+    };
+
+    if (stats) {
+        stats->plan = describePlan(query);
+    }
+
     // Get all XML files from the directory
     std::vector<std::string> xmlFiles = getXmlFiles(query.from_path);
 
+    // Compile the VALIDATE AGAINST schema once; files then share the cached copy
+    if (!query.validate_schema.empty()) {
+        CompiledSchema::load(query.validate_schema);
+    }
+    markStage("discover");
+
+    // Fill in execution statistics (single-threaded path) before returning
+    auto recordStats = [&](const std::vector<ResultRow>& rows) {
+        if (stats) {
+            markStage("postprocess");
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+            stats->total_files = xmlFiles.size();
+            stats->thread_count = 1;
+            stats->used_threading = false;
+            stats->result_rows = rows.size();
+            stats->execution_time_seconds = elapsed.count();
+            stats->finalizeFileCosts();
+        }
+    };
+
     if (xmlFiles.empty()) {
         std::cerr << "Warning: No XML files found in " << query.from_path << std::endl;
+        recordStats(allResults);
         return allResults;
     }
 
+    // Resume from the rows of the files an earlier run completed
+    if (checkpoint) {
+        checkpoint->begin(xmlFiles);
+        allResults = checkpoint->takeRows();
+        if (stats) {
+            stats->resumed_files = checkpoint->resumedFiles();
+        }
+    }
+    // A file is done unless a limit stopped the query while it was read
+    auto recordDone = [&](const std::string& filepath, const std::vector<ResultRow>& rows, uint64_t count) {
+        if (checkpoint && !(guard && guard->stopped())) {
+            checkpoint->complete(filepath, rows, count);
+        }
+    };
+
     // Check if any aggregate functions are used
     bool hasAggregates = false;
     for (const auto& field : query.select_fields) {
@@ -53,10 +161,14 @@ std::vector<ResultRow> QueryExecutor::execute(const Query& query) {
     }
 
     // Process each file - for aggregates, we need to build a modified query
-    if (hasAggregates) {
+    // (aggregates over FOR bindings, and their GROUP BY, go through the
+    // path below: each file gives partial aggregates, merged after the scan)
+    if (hasAggregates && query.for_clauses.empty()) {
         // For aggregate queries, build a temporary query to extract fields
         Query tempQuery;
         tempQuery.from_path = query.from_path;
+        tempQuery.validate_schema = query.validate_schema;
+        tempQuery.invalid_policy = query.invalid_policy;
         tempQuery.where = nullptr;  // We'll handle WHERE separately for now
         tempQuery.distinct = false;
         tempQuery.limit = -1;
@@ -104,15 +216,80 @@ std::vector<ResultRow> QueryExecutor::execute(const Query& query) {
             }
         }
 
+        // COUNT of an element path is taken from the raw bytes; files the
+        // scanner cannot follow go through the DOM as before
+        std::unique_ptr<ElementCounter> counter;
+        // (an incremental scan parses only the new records instead)
+        if (isElementCount(query) && !incremental) {
+            counter = ElementCounter::compile(tempQuery.select_fields[0]);
+        }
+        size_t counted = checkpoint ? checkpoint->counted() : 0;
+        auto countFile = [&](const std::string& filepath) {
+            auto start = std::chrono::high_resolution_clock::now();
+            uint64_t fileBytes = 0;
+            if (guard || MemoryBudget::limit() > 0) {
+                std::error_code ec;
+                fileBytes = std::filesystem::file_size(filepath, ec);
+                if (ec) {
+                    fileBytes = 0;
+                }
+            }
+            if (guard && !guard->checkpoint()) {
+                return true;
+            }
+            // Only the bytes are held, however large the file
+            MemoryBudget::Reservation reservation = MemoryBudget::reserve(fileBytes);
+            std::string bytes = XmlLoader::readFile(filepath);
+            size_t fileCount = 0;
+            if (!counter->count(bytes.data(), bytes.size(), fileCount)) {
+                return false;
+            }
+            // Charged once the count stands: a file the counter gives up on
+            // is charged by the DOM path instead
+            if (guard && !guard->scan(fileBytes)) {
+                return true;
+            }
+            counted += fileCount;
+            recordDone(filepath, {}, fileCount);
+            if (stats && stats->collectFileCosts()) {
+                FileCost cost;
+                std::chrono::duration<double, std::milli> ms = std::chrono::high_resolution_clock::now() - start;
+                cost.path = filepath;
+                cost.bytes = bytes.size();
+                cost.eval_ms = ms.count();
+                cost.rows = fileCount;
+                stats->recordFileCost(cost);
+            }
+            return true;
+        };
+
         // Process files to extract field values
         for (const auto& filepath : xmlFiles) {
+            if (guard && guard->stopped()) {
+                break;
+            }
+            if (checkpoint && checkpoint->completed(filepath)) {
+                continue;
+            }
             try {
-                auto fileResults = processFile(filepath, tempQuery);
+                if (counter && countFile(filepath)) {
+                    continue;
+                }
+                auto fileResults = processFileTracked(filepath, tempQuery, stats, nullptr, nullptr, guard.get(),
+                                                      incremental);
+                recordDone(filepath, fileResults, 0);
                 allResults.insert(allResults.end(), fileResults.begin(), fileResults.end());
+            } catch (const DocumentValidationError&) {
+                throw;
             } catch (const std::exception& e) {
                 std::cerr << "Error processing file " << filepath << ": " << e.what() << std::endl;
             }
         }
+        markStage("scan");
+        finishScan(guard.get(), allResults, stats);
+        if (checkpoint && !(guard && guard->stopped())) {
+            checkpoint->finish();
+        }
 
         // Now compute aggregates
         ResultRow aggregateRow;
@@ -147,21 +324,48 @@ std::vector<ResultRow> QueryExecutor::execute(const Query& query) {
             }
 
             std::string aggregateValue = computeAggregate(field, allResults);
+            if (counter) {
+                aggregateValue = std::to_string(counted + std::stoull(aggregateValue));
+            }
             aggregateRow.push_back({fieldName, aggregateValue});
         }
 
-        return {aggregateRow};
+        std::vector<ResultRow> aggregateResults = {aggregateRow};
+        recordStats(aggregateResults);
+        return aggregateResults;
     }
 
-    // Non-aggregate query - process normally
+    // Non-aggregate query - process normally, skipping files that cannot
+    // contain the literals the WHERE clause needs
+    auto prefilter = LiteralPrefilter::compile(query);
     for (const auto& filepath : xmlFiles) {
+        if (guard && guard->stopped()) {
+            break;
+        }
+        if (checkpoint && checkpoint->completed(filepath)) {
+            continue;
+        }
         try {
-            auto fileResults = processFile(filepath, query);
+            auto fileResults = processFileTracked(filepath, query, stats, nullptr, prefilter.get(), guard.get(),
+                                                  incremental);
+            recordDone(filepath, fileResults, 0);
             allResults.insert(allResults.end(), fileResults.begin(), fileResults.end());
+        } catch (const DocumentValidationError&) {
+            throw;
         } catch (const std::exception& e) {
             std::cerr << "Error processing file " << filepath << ": " << e.what() << std::endl;
         }
     }
+    markStage("scan");
+    finishScan(guard.get(), allResults, stats);
+    if (checkpoint && !(guard && guard->stopped())) {
+        checkpoint->finish();
+    }
+
+    // Files gave partial aggregates of their FOR bindings: merge them
+    if (query.has_aggregates && !query.for_clauses.empty()) {
+        allResults = mergeForAggregates(query, allResults);
+    }
 
     // Apply DISTINCT if specified
     if (query.distinct && !allResults.empty()) {
@@ -194,34 +398,7 @@ std::vector<ResultRow> QueryExecutor::execute(const Query& query) {
 
         std::sort(allResults.begin(), allResults.end(),
             [&orderField, descending](const ResultRow& a, const ResultRow& b) {
-                // Find the field in both rows
-                std::string aValue, bValue;
-
-                for (const auto& [field, value] : a) {
-                    if (field == orderField) {
-                        aValue = value;
-                        break;
-                    }
-                }
-
-                for (const auto& [field, value] : b) {
-                    if (field == orderField) {
-                        bValue = value;
-                        break;
-                    }
-                }
-
-                // Try numeric comparison first
-                try {
-                    double aNum = std::stod(aValue);
-                    double bNum = std::stod(bValue);
-                    // For descending, we want larger values first (a > b means a before b)
-                    // For ascending, we want smaller values first (a < b means a before b)
-                    return descending ? (aNum > bNum) : (aNum < bNum);
-                } catch (...) {
-                    // Fall back to string comparison
-                    return descending ? (aValue > bValue) : (aValue < bValue);
-                }
+                return compareRows(a, b, orderField, descending);
             }
         );
     }
@@ -261,6 +438,7 @@ std::vector<ResultRow> QueryExecutor::execute(const Query& query) {
         allResults.resize(query.limit);
     }
 
+    recordStats(allResults);
     return allResults;
 }
 
@@ -298,7 +476,9 @@ std::vector<ResultRow> QueryExecutor::processFileWithForClauses(
     const std::string& filepath,
     const Query& query,
     const pugi::xml_document& doc,
-    const std::string& filename
+    const DocumentIndex& documentIndex,
+    const std::string& filename,
+    QueryGuard* guard
 ) {
     std::vector<ResultRow> results;
 
@@ -312,246 +492,207 @@ std::vector<ResultRow> QueryExecutor::processFileWithForClauses(
     // Position context: maps position variable name -> current position
     std::map<std::string, size_t> positionContext;
 
+    // Bindings and fields are range lookups in the document's index
+    const RegionIndex& index = documentIndex.get();
+
     // Start nested iteration from document root
-    processNestedForClauses(doc.document_element(), query, varContext, positionContext, 0, filename, results);
+    processNestedForClauses(doc.document_element(), query, index, varContext, positionContext, 0, filename, results,
+                            guard);
 
-    // If query has aggregations, apply aggregation logic
+    // With aggregates, the file contributes partial aggregates per group,
+    // merged with the other files' by mergeForAggregates
     if (query.has_aggregates && !results.empty()) {
-        std::vector<ResultRow> aggregatedResults;
+        return partialForAggregates(query, results);
+    }
 
-        // For now, assume no GROUP BY - aggregate all results into a single row
-        // TODO: Add GROUP BY support
-        if (query.group_by_fields.empty()) {
-            ResultRow aggregatedRow;
+    return results;
+}
 
-            // Process each SELECT field
-            for (const auto& field : query.select_fields) {
-                if (field.aggregate != AggregateFunc::NONE) {
-                    std::string fieldName = field.alias.empty() ?
-                        (std::string(field.aggregate == AggregateFunc::COUNT ? "COUNT" :
-                                    field.aggregate == AggregateFunc::SUM ? "SUM" :
-                                    field.aggregate == AggregateFunc::AVG ? "AVG" :
-                                    field.aggregate == AggregateFunc::MIN ? "MIN" : "MAX") +
-                         "(" + field.aggregate_arg + ")") : field.alias;
-
-                    // Find this field in the results and aggregate
-                    std::vector<std::string> values;
-                    for (const auto& row : results) {
-                        for (const auto& [name, val] : row) {
-                            if (name == fieldName || name.find(field.aggregate_arg) != std::string::npos) {
-                                values.push_back(val);
-                                break;
-                            }
-                        }
-                    }
+namespace {
 
-                    // Apply aggregation function
-                    std::string aggregatedValue;
-                    switch (field.aggregate) {
-                        case AggregateFunc::COUNT:
-                            aggregatedValue = std::to_string(values.size());
-                            break;
-                        case AggregateFunc::SUM: {
-                            double sum = 0;
-                            for (const auto& v : values) {
-                                try {
-                                    sum += std::stod(v);
-                                } catch (...) {
-                                    // Skip non-numeric values
-                                }
-                            }
-                            aggregatedValue = std::to_string(sum);
-                            break;
-                        }
-                        case AggregateFunc::AVG: {
-                            double sum = 0;
-                            size_t count = 0;
-                            for (const auto& v : values) {
-                                try {
-                                    sum += std::stod(v);
-                                    count++;
-                                } catch (...) {
-                                    // Skip non-numeric values
-                                }
-                            }
-                            aggregatedValue = count > 0 ? std::to_string(sum / count) : "0";
-                            break;
-                        }
-                        case AggregateFunc::MIN: {
-                            double minVal = std::numeric_limits<double>::max();
-                            for (const auto& v : values) {
-                                try {
-                                    double val = std::stod(v);
-                                    if (val < minVal) minVal = val;
-                                } catch (...) {
-                                    // Skip non-numeric values
-                                }
-                            }
-                            aggregatedValue = minVal == std::numeric_limits<double>::max() ? "0" : std::to_string(minVal);
-                            break;
-                        }
-                        case AggregateFunc::MAX: {
-                            double maxVal = std::numeric_limits<double>::lowest();
-                            for (const auto& v : values) {
-                                try {
-                                    double val = std::stod(v);
-                                    if (val > maxVal) maxVal = val;
-                                } catch (...) {
-                                    // Skip non-numeric values
-                                }
-                            }
-                            aggregatedValue = maxVal == std::numeric_limits<double>::lowest() ? "0" : std::to_string(maxVal);
-                            break;
-                        }
-                        default:
-                            aggregatedValue = "0";
-                    }
+// Column name of an aggregate over FOR bindings
+std::string forAggregateName(const FieldPath& field) {
+    if (!field.alias.empty()) {
+        return field.alias;
+    }
+    std::string function = field.aggregate == AggregateFunc::COUNT ? "COUNT" :
+                           field.aggregate == AggregateFunc::SUM ? "SUM" :
+                           field.aggregate == AggregateFunc::AVG ? "AVG" :
+                           field.aggregate == AggregateFunc::MIN ? "MIN" : "MAX";
+    return function + "(" + field.aggregate_arg + ")";
+}
+
+// One aggregate over some of the bindings of a group. Partials of the same
+// group from several files merge into the aggregate over all of them.
+struct AggregatePartial {
+    size_t count = 0;       // Values (COUNT)
+    size_t numeric = 0;     // Values that are numbers (SUM, AVG, MIN, MAX)
+    double sum = 0;
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+
+    void add(const std::string& value) {
+        ++count;
+        try {
+            double number = std::stod(value);
+            ++numeric;
+            sum += number;
+            min = std::min(min, number);
+            max = std::max(max, number);
+        } catch (...) {
+            // Skip non-numeric values
+        }
+    }
+
+    void merge(const AggregatePartial& other) {
+        count += other.count;
+        numeric += other.numeric;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    // As a field value of a partial row (kept in checkpoints as such)
+    std::string encode() const {
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), "%zu %zu %.17g %.17g %.17g", count, numeric, sum, min, max);
+        return buffer;
+    }
+
+    static AggregatePartial decode(const std::string& text) {
+        AggregatePartial partial;
+        std::istringstream in(text);
+        in >> partial.count >> partial.numeric >> partial.sum >> partial.min >> partial.max;
+        return partial;
+    }
 
-                    aggregatedRow.push_back({fieldName, aggregatedValue});
+    std::string result(AggregateFunc function) const {
+        switch (function) {
+            case AggregateFunc::COUNT: return std::to_string(count);
+            case AggregateFunc::SUM:   return std::to_string(sum);
+            case AggregateFunc::AVG:   return numeric > 0 ? std::to_string(sum / numeric) : "0";
+            case AggregateFunc::MIN:   return numeric > 0 ? std::to_string(min) : "0";
+            case AggregateFunc::MAX:   return numeric > 0 ? std::to_string(max) : "0";
+            default:                   return "0";
+        }
+    }
+};
+
+} // namespace
+
+std::vector<ResultRow> QueryExecutor::partialForAggregates(const Query& query, const std::vector<ResultRow>& bindings) {
+    // Group key (GROUP BY values joined) -> the values and one partial per aggregate
+    std::map<std::string, std::pair<std::vector<std::string>, std::vector<AggregatePartial>>> groups;
+    size_t aggregateCount = std::count_if(query.select_fields.begin(), query.select_fields.end(),
+        [](const FieldPath& f) { return f.aggregate != AggregateFunc::NONE; });
+
+    for (const auto& row : bindings) {
+        // Build group key from GROUP BY fields
+        std::string groupKey;
+        std::vector<std::string> groupValues;
+        for (const auto& groupField : query.group_by_fields) {
+            std::string groupByFieldName = "__GROUP_BY__" + groupField;
+            std::string groupValue;
+            for (const auto& [name, val] : row) {
+                if (name == groupByFieldName) {
+                    groupValue = val;
+                    break;
                 }
             }
+            if (!groupValues.empty()) groupKey += "|||";
+            groupKey += groupValue;
+            groupValues.push_back(groupValue);
+        }
+        auto& group = groups[groupKey];
+        if (group.second.empty()) {
+            group.first = std::move(groupValues);
+            group.second.resize(aggregateCount);
+        }
 
-            // Apply HAVING filter if present (for global aggregation)
-            if (!query.having || evaluateHavingCondition(aggregatedRow, query.having.get())) {
-                aggregatedResults.push_back(aggregatedRow);
+        size_t aggregateIndex = 0;
+        for (const auto& field : query.select_fields) {
+            if (field.aggregate == AggregateFunc::NONE) {
+                continue;
             }
-            return aggregatedResults;
-        } else {
-            // Handle GROUP BY aggregations
-            // Group results by GROUP BY field values
-            std::map<std::string, std::vector<ResultRow>> groups;
-
-            for (const auto& row : results) {
-                // Build group key from GROUP BY fields
-                std::string groupKey;
-                for (const auto& groupField : query.group_by_fields) {
-                    std::string groupByFieldName = "__GROUP_BY__" + groupField;
-                    for (const auto& [name, val] : row) {
-                        if (name == groupByFieldName) {
-                            if (!groupKey.empty()) groupKey += "|||";
-                            groupKey += val;
-                            break;
-                        }
-                    }
+            std::string fieldName = forAggregateName(field);
+            for (const auto& [name, val] : row) {
+                // Match field name, excluding __GROUP_BY__ fields
+                if (name.find("__GROUP_BY__") != 0 &&
+                    (name == fieldName || name.find(field.aggregate_arg) != std::string::npos)) {
+                    group.second[aggregateIndex].add(val);
+                    break;
                 }
-                groups[groupKey].push_back(row);
             }
+            ++aggregateIndex;
+        }
+    }
 
-            // For each group, compute aggregations
-            for (const auto& [groupKey, groupRows] : groups) {
-                ResultRow aggregatedRow;
-
-                // First, add the GROUP BY field values to the result
-                size_t groupFieldIndex = 0;
-                std::string remainingKey = groupKey;
-                for (const auto& groupField : query.group_by_fields) {
-                    // Extract value from group key
-                    std::string groupValue;
-                    size_t pos = remainingKey.find("|||");
-                    if (pos != std::string::npos) {
-                        groupValue = remainingKey.substr(0, pos);
-                        remainingKey = remainingKey.substr(pos + 3);
-                    } else {
-                        groupValue = remainingKey;
-                    }
-
-                    // Add to result row (use the field name directly, not the __GROUP_BY__ prefix)
-                    aggregatedRow.push_back({groupField, groupValue});
-                    groupFieldIndex++;
-                }
-
-                // Process each SELECT field
-                for (const auto& field : query.select_fields) {
-                    if (field.aggregate != AggregateFunc::NONE) {
-                        std::string fieldName = field.alias.empty() ?
-                            (std::string(field.aggregate == AggregateFunc::COUNT ? "COUNT" :
-                                        field.aggregate == AggregateFunc::SUM ? "SUM" :
-                                        field.aggregate == AggregateFunc::AVG ? "AVG" :
-                                        field.aggregate == AggregateFunc::MIN ? "MIN" : "MAX") +
-                             "(" + field.aggregate_arg + ")") : field.alias;
-
-                        // Collect values from this group
-                        std::vector<std::string> values;
-                        for (const auto& row : groupRows) {
-                            for (const auto& [name, val] : row) {
-                                // Match field name, excluding __GROUP_BY__ fields
-                                if (name.find("__GROUP_BY__") != 0 &&
-                                    (name == fieldName || name.find(field.aggregate_arg) != std::string::npos)) {
-                                    values.push_back(val);
-                                    break;
-                                }
-                            }
-                        }
-
-                        // Apply aggregation function
-                        std::string aggregatedValue;
-                        switch (field.aggregate) {
-                            case AggregateFunc::COUNT:
-                                aggregatedValue = std::to_string(values.size());
-                                break;
-                            case AggregateFunc::SUM: {
-                                double sum = 0;
-                                for (const auto& v : values) {
-                                    try {
-                                        sum += std::stod(v);
-                                    } catch (...) {}
-                                }
-                                aggregatedValue = std::to_string(sum);
-                                break;
-                            }
-                            case AggregateFunc::AVG: {
-                                double sum = 0;
-                                size_t count = 0;
-                                for (const auto& v : values) {
-                                    try {
-                                        sum += std::stod(v);
-                                        count++;
-                                    } catch (...) {}
-                                }
-                                aggregatedValue = count > 0 ? std::to_string(sum / count) : "0";
-                                break;
-                            }
-                            case AggregateFunc::MIN: {
-                                double minVal = std::numeric_limits<double>::max();
-                                for (const auto& v : values) {
-                                    try {
-                                        double val = std::stod(v);
-                                        if (val < minVal) minVal = val;
-                                    } catch (...) {}
-                                }
-                                aggregatedValue = minVal == std::numeric_limits<double>::max() ? "0" : std::to_string(minVal);
-                                break;
-                            }
-                            case AggregateFunc::MAX: {
-                                double maxVal = std::numeric_limits<double>::lowest();
-                                for (const auto& v : values) {
-                                    try {
-                                        double val = std::stod(v);
-                                        if (val > maxVal) maxVal = val;
-                                    } catch (...) {}
-                                }
-                                aggregatedValue = maxVal == std::numeric_limits<double>::lowest() ? "0" : std::to_string(maxVal);
-                                break;
-                            }
-                            default:
-                                aggregatedValue = "0";
-                        }
+    // One row per group: its GROUP BY values, then the encoded partials
+    std::vector<ResultRow> partials;
+    for (const auto& [groupKey, group] : groups) {
+        ResultRow row;
+        for (size_t i = 0; i < query.group_by_fields.size(); ++i) {
+            row.push_back({"__GROUP_BY__" + query.group_by_fields[i], group.first[i]});
+        }
+        size_t aggregateIndex = 0;
+        for (const auto& field : query.select_fields) {
+            if (field.aggregate != AggregateFunc::NONE) {
+                row.push_back({forAggregateName(field), group.second[aggregateIndex++].encode()});
+            }
+        }
+        partials.push_back(std::move(row));
+    }
+    return partials;
+}
 
-                        aggregatedRow.push_back({fieldName, aggregatedValue});
-                    }
-                }
+std::vector<ResultRow> QueryExecutor::mergeForAggregates(const Query& query, const std::vector<ResultRow>& partials) {
+    // Group key -> the GROUP BY values and the merged partials
+    std::map<std::string, std::pair<ResultRow, std::vector<AggregatePartial>>> groups;
+    size_t groupCount = query.group_by_fields.size();
+    for (const auto& row : partials) {
+        std::string groupKey;
+        for (size_t i = 0; i < groupCount && i < row.size(); ++i) {
+            if (i > 0) groupKey += "|||";
+            groupKey += row[i].second;
+        }
+        auto& group = groups[groupKey];
+        bool first = group.second.empty();
+        if (first) {
+            // Add to result row (use the field name directly, not the __GROUP_BY__ prefix)
+            for (size_t i = 0; i < groupCount && i < row.size(); ++i) {
+                group.first.push_back({query.group_by_fields[i], row[i].second});
+            }
+        }
+        for (size_t i = groupCount; i < row.size(); ++i) {
+            AggregatePartial partial = AggregatePartial::decode(row[i].second);
+            if (first) {
+                group.second.push_back(partial);
+            } else if (i - groupCount < group.second.size()) {
+                group.second[i - groupCount].merge(partial);
+            }
+        }
+    }
 
-                // Apply HAVING filter if present
-                if (!query.having || evaluateHavingCondition(aggregatedRow, query.having.get())) {
-                    aggregatedResults.push_back(aggregatedRow);
-                }
+    std::vector<ResultRow> aggregatedResults;
+    for (auto& [groupKey, group] : groups) {
+        ResultRow aggregatedRow = std::move(group.first);
+        size_t aggregateIndex = 0;
+        for (const auto& field : query.select_fields) {
+            if (field.aggregate == AggregateFunc::NONE) {
+                continue;
             }
+            std::string value = aggregateIndex < group.second.size() ?
+                group.second[aggregateIndex].result(field.aggregate) : "0";
+            aggregatedRow.push_back({forAggregateName(field), value});
+            ++aggregateIndex;
+        }
 
-            return aggregatedResults;
+        // Apply HAVING filter if present
+        if (!query.having || evaluateHavingCondition(aggregatedRow, query.having.get())) {
+            aggregatedResults.push_back(aggregatedRow);
         }
     }
-
-    return results;
+    return aggregatedResults;
 }
 
 // Helper function to evaluate HAVING condition on an aggregated result row
@@ -648,11 +789,13 @@ static bool evaluateHavingCondition(const ResultRow& row, const WhereExpr* expr)
 void QueryExecutor::processNestedForClauses(
     const pugi::xml_node& currentContext,
     const Query& query,
+    const RegionIndex& index,
     std::map<std::string, pugi::xml_node>& varContext,
     std::map<std::string, size_t>& positionContext,
     size_t forClauseIndex,
     const std::string& filename,
-    std::vector<ResultRow>& results
+    std::vector<ResultRow>& results,
+    QueryGuard* guard
 ) {
     // Base case: all FOR clauses processed, now extract SELECT fields
     if (forClauseIndex >= query.for_clauses.size()) {
@@ -694,7 +837,7 @@ void QueryExecutor::processNestedForClauses(
                     groupPath.variable_name = groupPath.components[0];
                 }
 
-                std::string groupValue = resolveFieldWithContext(groupPath, varContext, positionContext, currentContext, query);
+                std::string groupValue = resolveFieldWithContext(groupPath, index, varContext, positionContext, currentContext, query);
                 row.push_back({"__GROUP_BY__" + groupField, groupValue});
             }
         }
@@ -772,7 +915,7 @@ void QueryExecutor::processNestedForClauses(
                                 // Not a variable - resolve as field path from current context
                                 FieldPath argPath;
                                 argPath.components = argComponents;
-                                value = resolveFieldWithContext(argPath, varContext, positionContext, currentContext, query);
+                                value = resolveFieldWithContext(argPath, index, varContext, positionContext, currentContext, query);
                             }
                         }
                         break;
@@ -787,7 +930,7 @@ void QueryExecutor::processNestedForClauses(
                 fieldName = field.components.back();
 
                 // Resolve field using variable context and position context
-                value = resolveFieldWithContext(field, varContext, positionContext, currentContext, query);
+                value = resolveFieldWithContext(field, index, varContext, positionContext, currentContext, query);
             } else {
                 fieldName = "unknown";
                 value = "";
@@ -796,6 +939,10 @@ void QueryExecutor::processNestedForClauses(
             row.push_back({fieldName, value});
         }
 
+        // A row past a limit is dropped; the loops above stop at their next poll
+        if (guard && !guard->addRow(row)) {
+            return;
+        }
         results.push_back(row);
         return;
     }
@@ -823,20 +970,11 @@ void QueryExecutor::processNestedForClauses(
             );
 
             if (subPath.size() == 1) {
-                // Simple child search
-                std::function<void(const pugi::xml_node&)> findElements =
-                    [&](const pugi::xml_node& node) {
-                        if (node.type() == pugi::node_element && node.name() == subPath[0]) {
-                            iterationNodes.push_back(node);
-                        }
-                        for (pugi::xml_node child : node.children()) {
-                            findElements(child);
-                        }
-                    };
-                findElements(parentNode);
+                // Simple descendant search
+                index.elementsNamed(parentNode, subPath[0], iterationNodes);
             } else if (!subPath.empty()) {
                 // Multi-component path from parent node
-                XmlNavigator::findNodesByPartialPath(parentNode, subPath, iterationNodes);
+                index.elementsByPartialPath(parentNode, subPath, iterationNodes);
             }
         } else {
             // Not a variable reference - search from document root
@@ -856,60 +994,15 @@ void QueryExecutor::processNestedForClauses(
                         iterationNodes.push_back(docRoot);
                     }
                 } else {
-                    // Leading dot: partial path - recursive search
-                    std::function<void(const pugi::xml_node&)> findElements =
-                        [&](const pugi::xml_node& node) {
-                            if (node.type() == pugi::node_element && node.name() == elementName) {
-                                iterationNodes.push_back(node);
-                            }
-                            for (pugi::xml_node child : node.children()) {
-                                findElements(child);
-                            }
-                        };
-                    findElements(docRoot);
+                    // Leading dot: partial path - any element of that name
+                    index.elementsNamed(docRoot, elementName, iterationNodes);
                 }
+            } else if (forClause.path.is_partial_path) {
+                // Multi-component partial path (.department.employee): suffix matching
+                index.elementsByPartialPath(docRoot, forClause.path.components, iterationNodes);
             } else {
-                // Multi-component path
-                // For partial paths (.department.employee), use suffix matching
-                // For non-partial paths (company.department.employee), use full path matching
-                XmlNavigator::findNodesByPartialPath(docRoot, forClause.path.components, iterationNodes);
-
-                // If not a partial path, filter to only exact full path matches
-                if (!forClause.path.is_partial_path) {
-                    // Build expected full path
-                    std::string expectedPath;
-                    for (size_t i = 0; i < forClause.path.components.size(); ++i) {
-                        if (i > 0) expectedPath += ".";
-                        expectedPath += forClause.path.components[i];
-                    }
-
-                    // Filter nodes to only those matching the exact full path from root
-                    std::vector<pugi::xml_node> filteredNodes;
-                    for (const auto& node : iterationNodes) {
-                        // Build actual full path of this node
-                        std::vector<std::string> nodePath;
-                        pugi::xml_node n = node;
-                        while (n && n.type() == pugi::node_element) {
-                            nodePath.insert(nodePath.begin(), std::string(n.name()));
-                            n = n.parent();
-                        }
-
-                        // Check if it matches the expected path exactly
-                        if (nodePath.size() >= forClause.path.components.size()) {
-                            bool matches = true;
-                            for (size_t i = 0; i < forClause.path.components.size(); ++i) {
-                                if (nodePath[i] != forClause.path.components[i]) {
-                                    matches = false;
-                                    break;
-                                }
-                            }
-                            if (matches) {
-                                filteredNodes.push_back(node);
-                            }
-                        }
-                    }
-                    iterationNodes = filteredNodes;
-                }
+                // Full path (company.department.employee): exact path from the root
+                index.elementsByAbsolutePath(forClause.path.components, iterationNodes);
             }
         }
     }
@@ -917,6 +1010,10 @@ void QueryExecutor::processNestedForClauses(
     // Iterate over found nodes and recursively process next FOR clause
     size_t position = 1;  // XQuery positions start at 1
     for (const auto& node : iterationNodes) {
+        if (guard && !guard->poll()) {
+            return;
+        }
+
         // Bind this node to the variable
         varContext[forClause.variable] = node;
 
@@ -926,7 +1023,8 @@ void QueryExecutor::processNestedForClauses(
         }
 
         // Recursively process next FOR clause
-        processNestedForClauses(node, query, varContext, positionContext, forClauseIndex + 1, filename, results);
+        processNestedForClauses(node, query, index, varContext, positionContext, forClauseIndex + 1, filename, results,
+                                guard);
 
         // Unbind variable (cleanup for next iteration)
         varContext.erase(forClause.variable);
@@ -941,6 +1039,7 @@ void QueryExecutor::processNestedForClauses(
 // Resolve field value using variable context
 std::string QueryExecutor::resolveFieldWithContext(
     const FieldPath& field,
+    const RegionIndex& index,
     const std::map<std::string, pugi::xml_node>& varContext,
     const std::map<std::string, size_t>& positionContext,
     const pugi::xml_node& fallbackContext,
@@ -974,14 +1073,14 @@ std::string QueryExecutor::resolveFieldWithContext(
                 value = contextNode.child_value();
             } else if (subPath.size() == 1) {
                 // Simple child lookup
-                pugi::xml_node childNode = XmlNavigator::findFirstElementByName(contextNode, subPath[0]);
+                pugi::xml_node childNode = index.firstNamed(contextNode, subPath[0]);
                 if (childNode) {
                     value = childNode.child_value();
                 }
             } else {
                 // Multi-component path from variable node
                 std::vector<pugi::xml_node> fieldNodes;
-                XmlNavigator::findNodesByPartialPath(contextNode, subPath, fieldNodes);
+                index.elementsByPartialPath(contextNode, subPath, fieldNodes);
                 if (!fieldNodes.empty()) {
                     value = fieldNodes[0].child_value();
                 }
@@ -990,13 +1089,13 @@ std::string QueryExecutor::resolveFieldWithContext(
     } else {
         // Normal field (not a variable reference) - use fallback context
         if (field.components.size() == 1) {
-            pugi::xml_node foundNode = XmlNavigator::findFirstElementByName(fallbackContext, field.components[0]);
+            pugi::xml_node foundNode = index.firstNamed(fallbackContext, field.components[0]);
             if (foundNode) {
                 value = foundNode.child_value();
             }
         } else {
             std::vector<pugi::xml_node> fieldNodes;
-            XmlNavigator::findNodesByPartialPath(fallbackContext, field.components, fieldNodes);
+            index.elementsByPartialPath(fallbackContext, field.components, fieldNodes);
             if (!fieldNodes.empty()) {
                 value = fieldNodes[0].child_value();
             }
@@ -1095,22 +1194,211 @@ bool QueryExecutor::evaluateWhereWithContext(
     return true;
 }
 
+std::vector<ResultRow> QueryExecutor::processFileTracked(
+    const std::string& filepath,
+    const Query& query,
+    ExecutionStats* stats,
+    std::mutex* statsMutex,
+    const LiteralPrefilter* prefilter,
+    QueryGuard* guard,
+    IncrementalState* incremental
+) {
+    // Rows bound by FOR clauses are counted as they are produced
+    auto countRows = [&](const std::vector<ResultRow>& results) {
+        if (guard && query.for_clauses.empty()) {
+            guard->addRows(results);
+        }
+    };
+
+    if (!stats) {
+        auto results = processFile(filepath, query, nullptr, nullptr, prefilter, guard, incremental);
+        countRows(results);
+        return results;
+    }
+
+    bool invalid = false;
+    auto countInvalid = [&]() {
+        if (!invalid) return;
+        if (statsMutex) {
+            std::lock_guard<std::mutex> lock(*statsMutex);
+            stats->invalid_files++;
+        } else {
+            stats->invalid_files++;
+        }
+    };
+
+    if (!stats->collectFileCosts()) {
+        auto results = processFile(filepath, query, nullptr, &invalid, prefilter, guard, incremental);
+        countInvalid();
+        countRows(results);
+        return results;
+    }
+
+    FileCost cost;
+    auto start = std::chrono::high_resolution_clock::now();
+    auto results = processFile(filepath, query, &cost, &invalid, prefilter, guard, incremental);
+    std::chrono::duration<double, std::milli> total = std::chrono::high_resolution_clock::now() - start;
+    countInvalid();
+    countRows(results);
+
+    cost.eval_ms = std::max(0.0, total.count() - cost.parse_ms);
+    cost.rows = results.size();
+
+    if (statsMutex) {
+        std::lock_guard<std::mutex> lock(*statsMutex);
+        stats->recordFileCost(cost);
+    } else {
+        stats->recordFileCost(cost);
+    }
+    return results;
+}
+
 std::vector<ResultRow> QueryExecutor::processFile(
     const std::string& filepath,
-    const Query& query
+    const Query& query,
+    FileCost* cost,
+    bool* invalid,
+    const LiteralPrefilter* prefilter,
+    QueryGuard* guard,
+    IncrementalState* incremental
+) {
+    if (incremental) {
+        return processAppended(filepath, query, cost, invalid, prefilter, guard, *incremental);
+    }
+    std::vector<ResultRow> results;
+
+    // Limits and the memory budget both go by the size of the file
+    uint64_t fileBytes = 0;
+    if (guard || MemoryBudget::limit() > 0) {
+        std::error_code ec;
+        fileBytes = std::filesystem::file_size(filepath, ec);
+        if (ec) {
+            fileBytes = 0;
+        }
+    }
+    if (guard && (!guard->checkpoint() || !guard->scan(fileBytes))) {
+        return results;
+    }
+
+    // Held until the document and its index are freed (declared before them)
+    MemoryBudget::Reservation reservation;
+    if (MemoryBudget::limit() > 0) {
+        reservation = MemoryBudget::reserve(MemoryBudget::estimate(fileBytes));
+    }
+
+    // Load the XML document, unless its bytes show the WHERE clause cannot hold
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    std::unique_ptr<pugi::xml_document> doc;
+    if (prefilter) {
+        std::string bytes = XmlLoader::readFile(filepath);
+        if (prefilter->mayMatch(bytes.data(), bytes.size())) {
+            doc = XmlLoader::load(filepath, bytes);
+        }
+    } else if (!query.validate_schema.empty()) {
+        // A document that is not well-formed fails validation like any other
+        try {
+            doc = XmlLoader::load(filepath);
+        } catch (const std::runtime_error& e) {
+            std::string message = e.what();
+            size_t detail = message.find("\nError: ");
+            rejectDocument(query, filepath,
+                           detail == std::string::npos ? message : message.substr(detail + 8), invalid);
+        }
+    } else {
+        doc = XmlLoader::load(filepath);
+    }
+    if (cost) {
+        std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - loadStart;
+        std::error_code ec;
+        cost->path = filepath;
+        cost->bytes = std::filesystem::file_size(filepath, ec);
+        cost->parse_ms = loadTime.count();
+    }
+    if (!doc) {
+        return results;
+    }
+    return processDocument(filepath, query, *doc, invalid, guard);
+}
+
+std::vector<ResultRow> QueryExecutor::processAppended(
+    const std::string& filepath,
+    const Query& query,
+    FileCost* cost,
+    bool* invalid,
+    const LiteralPrefilter* prefilter,
+    QueryGuard* guard,
+    IncrementalState& incremental
+) {
+    std::vector<ResultRow> results;
+    if (guard && !guard->checkpoint()) {
+        return results;
+    }
+
+    // Limits and the memory budget go by the bytes actually read
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    IncrementalState::Delta delta = incremental.read(filepath);
+    if (guard && !guard->scan(delta.scanned)) {
+        return results;
+    }
+    MemoryBudget::Reservation reservation;
+    if (MemoryBudget::limit() > 0) {
+        reservation = MemoryBudget::reserve(MemoryBudget::estimate(delta.bytes.size()));
+    }
+
+    std::unique_ptr<pugi::xml_document> doc;
+    if (!delta.bytes.empty() && (!prefilter || prefilter->mayMatch(delta.bytes.data(), delta.bytes.size()))) {
+        doc = XmlLoader::load(filepath, delta.bytes);
+    }
+    if (cost) {
+        std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - loadStart;
+        cost->path = filepath;
+        cost->bytes = delta.scanned;
+        cost->parse_ms = loadTime.count();
+    }
+
+    results = std::move(delta.rows);
+    if (doc) {
+        auto added = processDocument(filepath, query, *doc, invalid, guard);
+        results.insert(results.end(), std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+    }
+    if (!(guard && guard->stopped())) {
+        incremental.commit(filepath, delta, results);
+    }
+    return results;
+}
+
+std::vector<ResultRow> QueryExecutor::processDocument(
+    const std::string& filepath,
+    const Query& query,
+    const pugi::xml_document& doc,
+    bool* invalid,
+    QueryGuard* guard
 ) {
     std::vector<ResultRow> results;
 
-    // Load the XML document
-    auto doc = XmlLoader::load(filepath);
+    // VALIDATE AGAINST: check the document just parsed, before evaluating the query
+    if (!query.validate_schema.empty()) {
+        auto schema = CompiledSchema::load(query.validate_schema);
+        XmlValidator validator;
+        ValidationResult validation = validator.validateDocument(doc, *schema);
+        if (!validation.isValid) {
+            const auto& error = validation.errors.front();
+            rejectDocument(query, filepath, error.message + (error.path.empty() ? "" : " at " + error.path),
+                           invalid);
+            return results;
+        }
+    }
 
     // Get filename for FILE_NAME field
     std::string filename = std::filesystem::path(filepath).filename().string();
 
+    // Built on the first name-driven lookup and shared by every field below
+    DocumentIndex index(doc);
+
     // Check if query has FOR clauses
     if (!query.for_clauses.empty()) {
         // Process query with FOR clause context binding
-        results = processFileWithForClauses(filepath, query, *doc, filename);
+        results = processFileWithForClauses(filepath, query, doc, index, filename, guard);
         return results;
     }
 
@@ -1120,7 +1408,7 @@ std::vector<ResultRow> QueryExecutor::processFile(
         std::vector<std::vector<XmlResult>> fieldResults;
 
         for (const auto& field : query.select_fields) {
-            auto values = XmlNavigator::extractValues(*doc, filename, field);
+            auto values = XmlNavigator::extractValues(doc, filename, field, &index);
             fieldResults.push_back(values);
         }
 
@@ -1174,6 +1462,26 @@ std::vector<ResultRow> QueryExecutor::processFile(
         // Extract field from the first condition in the WHERE expression tree
         FieldPath whereField = extractFieldPathFromWhere(query.where.get());
 
+        // Numeric conditions run as kernels over batches of candidates
+        // (see BatchFilter); anything else is evaluated node by node
+        std::unique_ptr<BatchFilter> batchFilter = BatchFilter::compile(query.where.get());
+        auto filterCandidates = [&](const std::vector<pugi::xml_node>& candidates, size_t parentDepth,
+                                    const std::function<void(const pugi::xml_node&)>& emit) {
+            if (batchFilter) {
+                std::vector<uint32_t> selection;
+                batchFilter->filter(candidates, parentDepth, selection);
+                for (uint32_t i : selection) {
+                    emit(candidates[i]);
+                }
+                return;
+            }
+            for (const auto& node : candidates) {
+                if (XmlNavigator::evaluateWhereExpr(node, query.where.get(), parentDepth)) {
+                    emit(node);
+                }
+            }
+        };
+
         if (whereField.components.size() < 2) {
             // Shorthand path: find all nodes that contain the WHERE attribute
             // and evaluate the condition on parent nodes that have the attribute as a child
@@ -1185,122 +1493,33 @@ std::vector<ResultRow> QueryExecutor::processFile(
                               condition->op == ComparisonOp::IS_NOT_NULL);
             }
 
-            std::function<void(const pugi::xml_node&)> searchTree =
-                [&](const pugi::xml_node& node) {
-                    if (!node) return;
-
-                    // For IS NULL/IS NOT NULL, check all nodes
-                    // For other operators, only check nodes that have the attribute
-                    bool shouldEvaluate = false;
-
-                    if (isNullCheck) {
-                        // For IS NULL/IS NOT NULL, evaluate on nodes that have at least one SELECT field
-                        // This ensures we're checking the right "level" of nodes
-                        if (node.type() == pugi::node_element && node != *doc) {
-                            // Check if this node has at least one of the SELECT fields as a child or attribute
-                            for (const auto& selectField : query.select_fields) {
-                                if (!selectField.include_filename) {
-                                    if (selectField.is_attribute) {
-                                        // For attributes, just check if this is an element node
-                                        shouldEvaluate = true;
-                                        break;
-                                    } else if (selectField.components.size() == 1) {
-                                        pugi::xml_node foundNode = XmlNavigator::findFirstElementByName(node, selectField.components[0]);
-                                        if (foundNode && foundNode.parent() == node) {
-                                            shouldEvaluate = true;
-                                            break;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    } else {
-                        // Check if this node has the WHERE field
-                        if (whereField.is_attribute) {
-                            // For attributes, check if this node is an element node
-                            // The actual attribute value will be checked in evaluateWhereExpr
-                            shouldEvaluate = (node.type() == pugi::node_element && node != *doc);
-                        } else if (!whereField.components.empty()) {
-                            // Check if this node has the WHERE field as a direct child
-                            pugi::xml_node whereAttrNode = XmlNavigator::findFirstElementByName(node, whereField.components[0]);
-                            shouldEvaluate = (whereAttrNode && whereAttrNode.parent() == node);
-                        }
-                    }
-
-                    if (shouldEvaluate) {
-                        // Evaluate WHERE condition on this node
-                        if (XmlNavigator::evaluateWhereExpr(node, query.where.get(), 0)) {
-                            ResultRow row;
-
-                            for (const auto& field : query.select_fields) {
-                                std::string fieldName;
-                                std::string value;
-
-                                if (field.include_filename) {
-                                    fieldName = "FILE_NAME";
-                                    value = filename;
-                                } else if (field.is_attribute) {
-                                    fieldName = "@" + field.attribute_name;
-                                    // Extract attribute from current node
-                                    pugi::xml_attribute attr = node.attribute(field.attribute_name.c_str());
-                                    if (attr) {
-                                        value = attr.value();
-                                    }
-                                } else if (!field.components.empty()) {
-                                    fieldName = field.components.back();
-
-                                    // Use shorthand search from this node
-                                    if (field.components.size() == 1) {
-                                        pugi::xml_node foundNode = XmlNavigator::findFirstElementByName(node, field.components[0]);
-                                        if (foundNode) {
-                                            value = foundNode.child_value();
-                                        }
-                                    } else {
-                                        // Use partial path matching from this node
-                                        std::vector<pugi::xml_node> fieldNodes;
-                                        XmlNavigator::findNodesByPartialPath(node, field.components, fieldNodes);
-
-                                        if (!fieldNodes.empty()) {
-                                            value = fieldNodes[0].child_value();
-                                        }
-                                    }
-                                } else {
-                                    fieldName = "unknown";
-                                    value = "";
-                                }
-
-                                row.push_back({fieldName, value});
-                            }
-
-                            results.push_back(row);
-                        }
+            // Elements the condition is evaluated on: those whose first
+            // element named after the field (depth-first, as
+            // findFirstElementByName) is a direct child. The element of that
+            // name just before such a child in document order then lies
+            // outside the parent, so one pass over the pre-order numbers of
+            // the index finds them all, however deep the document.
+            auto markCandidates = [&](const RegionIndex& regions, const std::string& name,
+                                      std::vector<char>& marked) {
+                uint32_t id = regions.findName(name);
+                if (id == RegionIndex::npos) {
+                    return;
+                }
+                uint32_t previous = RegionIndex::npos;
+                for (uint32_t pre = 0; pre < regions.size(); ++pre) {
+                    if (regions.nameId(pre) != id) {
+                        continue;
                     }
-
-                    // Recursively search children
-                    for (pugi::xml_node child : node.children()) {
-                        searchTree(child);
+                    uint32_t parent = regions.parent(pre);
+                    if (parent != RegionIndex::npos && (previous == RegionIndex::npos || previous < parent)) {
+                        marked[parent] = 1;
                     }
-                };
-
-            searchTree(*doc);
-            return results;
-        }
-
-        // Navigate to parent nodes that contain the WHERE field
-        // Use partial path matching to find all nodes matching the parent path suffix
-        std::vector<std::string> parentPath(
-            whereField.components.begin(),
-            whereField.components.end() - 1
-        );
-
-        std::vector<pugi::xml_node> candidateNodes;
-        XmlNavigator::findNodesByPartialPath(*doc, parentPath, candidateNodes);
+                    previous = pre;
+                }
+            };
 
-        // Filter nodes based on WHERE expression
-        // Pass parentPath.size() so evaluation uses relative path navigation
-        for (const auto& node : candidateNodes) {
-            if (XmlNavigator::evaluateWhereExpr(node, query.where.get(), parentPath.size())) {
-                // Extract select fields from this node
+            // Row of a matching element
+            auto emitRow = [&](const pugi::xml_node& node) {
                 ResultRow row;
 
                 for (const auto& field : query.select_fields) {
@@ -1320,20 +1539,20 @@ std::vector<ResultRow> QueryExecutor::processFile(
                     } else if (!field.components.empty()) {
                         fieldName = field.components.back();
 
-                        // Shorthand: use first element search
-                        if (field.components.size() == 1) {
-                            pugi::xml_node foundNode = XmlNavigator::findFirstElementByName(node, field.components[0]);
+                        // Use shorthand search from this node
+                        if (field.is_anchored) {
+                            value = XmlNavigator::getAnchoredValue(node, field.components);
+                        } else if (field.components.size() == 1) {
+                            pugi::xml_node foundNode = index.get().firstNamed(node, field.components[0]);
                             if (foundNode) {
                                 value = foundNode.child_value();
                             }
                         } else {
-                            // Use partial path matching relative to current node
-                            // First, try to find the field using partial path from this node
+                            // Use partial path matching from this node
                             std::vector<pugi::xml_node> fieldNodes;
                             XmlNavigator::findNodesByPartialPath(node, field.components, fieldNodes);
 
                             if (!fieldNodes.empty()) {
-                                // Use the first match
                                 value = fieldNodes[0].child_value();
                             }
                         }
@@ -1346,8 +1565,125 @@ std::vector<ResultRow> QueryExecutor::processFile(
                 }
 
                 results.push_back(row);
+            };
+
+            // A single comparison on an attribute only needs the elements
+            // carrying it (an empty value fails every operator but IS NULL
+            // and IS NOT NULL), which the document index lists in document
+            // order
+            bool attributeCandidates = !isNullCheck && whereField.is_attribute &&
+                dynamic_cast<const WhereCondition*>(query.where.get());
+            std::vector<pugi::xml_node> candidates;
+            if (attributeCandidates) {
+                index.get().elementsWithAttribute(whereField.attribute_name, candidates);
+                filterCandidates(candidates, 0, emitRow);
+                return results;
+            }
+
+            const RegionIndex& regions = index.get();
+            bool allElements = false;
+            std::vector<char> marked(regions.size(), 0);
+            if (isNullCheck) {
+                // For IS NULL/IS NOT NULL, evaluate on nodes that have at least one SELECT field
+                // This ensures we're checking the right "level" of nodes
+                for (const auto& selectField : query.select_fields) {
+                    if (selectField.include_filename) {
+                        continue;
+                    }
+                    if (selectField.is_attribute) {
+                        // For attributes, any element is a candidate
+                        allElements = true;
+                        break;
+                    }
+                    if (selectField.components.size() == 1) {
+                        markCandidates(regions, selectField.components[0], marked);
+                    }
+                }
+            } else if (whereField.is_attribute) {
+                // For attributes, any element is a candidate
+                // The actual attribute value will be checked in evaluateWhereExpr
+                allElements = true;
+            } else if (!whereField.components.empty()) {
+                markCandidates(regions, whereField.components[0], marked);
+            }
+            for (uint32_t pre = 0; pre < regions.size(); ++pre) {
+                if (allElements || marked[pre]) {
+                    candidates.push_back(regions.node(pre));
+                }
             }
+            filterCandidates(candidates, 0, emitRow);
+            return results;
         }
+
+        // Navigate to parent nodes that contain the WHERE field
+        // Use partial path matching to find all nodes matching the parent path suffix
+        std::vector<std::string> parentPath(
+            whereField.components.begin(),
+            whereField.components.end() - 1
+        );
+
+        // An anchored path (resolved against the schema) is a plain descent
+        std::vector<pugi::xml_node> candidateNodes;
+        if (whereField.is_anchored) {
+            XmlNavigator::findNodes(doc, parentPath, 0, candidateNodes);
+        } else {
+            XmlNavigator::findNodesByPartialPath(doc, parentPath, candidateNodes);
+        }
+
+        // Extract select fields from a matching node
+        auto emitRow = [&](const pugi::xml_node& node) {
+            ResultRow row;
+
+            for (const auto& field : query.select_fields) {
+                std::string fieldName;
+                std::string value;
+
+                if (field.include_filename) {
+                    fieldName = "FILE_NAME";
+                    value = filename;
+                } else if (field.is_attribute) {
+                    fieldName = "@" + field.attribute_name;
+                    // Extract attribute from current node
+                    pugi::xml_attribute attr = node.attribute(field.attribute_name.c_str());
+                    if (attr) {
+                        value = attr.value();
+                    }
+                } else if (!field.components.empty()) {
+                    fieldName = field.components.back();
+
+                    // Shorthand: use first element search
+                    if (field.is_anchored) {
+                        value = XmlNavigator::getAnchoredValue(node, field.components);
+                    } else if (field.components.size() == 1) {
+                        pugi::xml_node foundNode = XmlNavigator::findFirstElementByName(node, field.components[0]);
+                        if (foundNode) {
+                            value = foundNode.child_value();
+                        }
+                    } else {
+                        // Use partial path matching relative to current node
+                        // First, try to find the field using partial path from this node
+                        std::vector<pugi::xml_node> fieldNodes;
+                        XmlNavigator::findNodesByPartialPath(node, field.components, fieldNodes);
+
+                        if (!fieldNodes.empty()) {
+                            // Use the first match
+                            value = fieldNodes[0].child_value();
+                        }
+                    }
+                } else {
+                    fieldName = "unknown";
+                    value = "";
+                }
+
+                row.push_back({fieldName, value});
+            }
+
+            results.push_back(row);
+        };
+
+        // Filter nodes based on WHERE expression
+        // Pass parentPath.size() so evaluation uses relative path navigation
+        filterCandidates(candidateNodes, parentPath.size(), emitRow);
     }
 
     return results;
@@ -1452,10 +1788,16 @@ std::vector<ResultRow> QueryExecutor::executeMultithreaded(
     const std::vector<std::string>& xmlFiles,
     const Query& query,
     size_t threadCount,
-    std::atomic<size_t>* completedCounter
+    std::atomic<size_t>* completedCounter,
+    ExecutionStats* stats,
+    const LiteralPrefilter* prefilter,
+    QueryGuard* guard,
+    ScanCheckpoint* checkpoint,
+    IncrementalState* incremental
 ) {
     std::vector<ResultRow> allResults;
     std::mutex resultsMutex;
+    std::mutex statsMutex;
 
     // Create thread pool
     std::vector<std::thread> threads;
@@ -1465,14 +1807,29 @@ std::vector<ResultRow> QueryExecutor::executeMultithreaded(
     std::atomic<size_t> localCompleted{0};
     std::atomic<size_t>* completed = completedCounter ? completedCounter : &localCompleted;
 
+    // First VALIDATE AGAINST ... FAIL error; stops all workers and is rethrown
+    std::exception_ptr validationFailure;
+    std::atomic<bool> aborted{false};
+
     // Launch worker threads
     for (size_t threadId = 0; threadId < threadCount; ++threadId) {
         threads.emplace_back([&, threadId]() {
             // Each thread processes every Nth file (strided access for load balancing)
-            for (size_t fileIdx = threadId; fileIdx < xmlFiles.size(); fileIdx += threadCount) {
+            for (size_t fileIdx = threadId; fileIdx < xmlFiles.size() && !aborted; fileIdx += threadCount) {
+                if (guard && guard->stopped()) {
+                    break;
+                }
+                if (checkpoint && checkpoint->completed(xmlFiles[fileIdx])) {
+                    (*completed)++;
+                    continue;
+                }
                 try {
                     // Process this file
-                    auto fileResults = processFile(xmlFiles[fileIdx], query);
+                    auto fileResults = processFileTracked(xmlFiles[fileIdx], query, stats, &statsMutex, prefilter, guard,
+                                                          incremental);
+                    if (checkpoint && !(guard && guard->stopped())) {
+                        checkpoint->complete(xmlFiles[fileIdx], fileResults);
+                    }
 
                     // Accumulate results (thread-safe)
                     {
@@ -1485,6 +1842,12 @@ std::vector<ResultRow> QueryExecutor::executeMultithreaded(
                     // Increment completed counter
                     (*completed)++;
 
+                } catch (const DocumentValidationError&) {
+                    std::lock_guard<std::mutex> lock(resultsMutex);
+                    if (!validationFailure) {
+                        validationFailure = std::current_exception();
+                    }
+                    aborted = true;
                 } catch (const std::exception& e) {
                     std::cerr << "Error processing file " << xmlFiles[fileIdx]
                               << ": " << e.what() << std::endl;
@@ -1499,19 +1862,53 @@ std::vector<ResultRow> QueryExecutor::executeMultithreaded(
         thread.join();
     }
 
+    if (validationFailure) {
+        std::rethrow_exception(validationFailure);
+    }
+
     return allResults;
 }
 
 std::vector<ResultRow> QueryExecutor::executeWithProgress(
     const Query& query,
     ProgressCallback progressCallback,
-    ExecutionStats* stats
+    ExecutionStats* stats,
+    const QueryLimits& limits,
+    ScanCheckpoint* checkpoint,
+    IncrementalState* incremental
 ) {
     auto startTime = std::chrono::high_resolution_clock::now();
 
+    // Checked cooperatively while files are scanned
+    std::unique_ptr<QueryGuard> guard;
+    if (limits.any()) {
+        guard = std::make_unique<QueryGuard>(limits);
+    }
+
+    // Record the duration of each stage since the previous mark
+    auto stageStart = startTime;
+    auto markStage = [&](const char* name) {
+        auto now = std::chrono::high_resolution_clock::now();
+        if (stats) {
+            std::chrono::duration<double, std::milli> ms = now - stageStart;
+            stats->stages.push_back({name, ms.count()});
+        }
+        stageStart = now;
+    };
+
+    if (stats) {
+        stats->plan = describePlan(query);
+    }
+
     // Get all XML files
     std::vector<std::string> xmlFiles = getXmlFiles(query.from_path);
 
+    // Compile the VALIDATE AGAINST schema once; files then share the cached copy
+    if (!query.validate_schema.empty()) {
+        CompiledSchema::load(query.validate_schema);
+    }
+    markStage("discover");
+
     if (xmlFiles.empty()) {
         std::cerr << "Warning: No XML files found in " << query.from_path << std::endl;
         return std::vector<ResultRow>();
@@ -1529,6 +1926,16 @@ std::vector<ResultRow> QueryExecutor::executeWithProgress(
     }
 
     std::vector<ResultRow> allResults;
+    auto prefilter = LiteralPrefilter::compile(query);
+
+    // Resume from the rows of the files an earlier run completed
+    if (checkpoint) {
+        checkpoint->begin(xmlFiles);
+        allResults = checkpoint->takeRows();
+        if (stats) {
+            stats->resumed_files = checkpoint->resumedFiles();
+        }
+    }
 
     if (useThreading) {
         // Multi-threaded execution with progress tracking
@@ -1546,7 +1953,16 @@ std::vector<ResultRow> QueryExecutor::executeWithProgress(
         });
 
         // Execute query with multi-threading
-        allResults = executeMultithreaded(xmlFiles, query, threadCount, &completed);
+        try {
+            auto scanned = executeMultithreaded(xmlFiles, query, threadCount, &completed, stats, prefilter.get(),
+                                                guard.get(), checkpoint, incremental);
+            allResults.insert(allResults.end(), std::make_move_iterator(scanned.begin()),
+                              std::make_move_iterator(scanned.end()));
+        } catch (...) {
+            done = true;
+            progressThread.join();
+            throw;
+        }
 
         // Stop progress thread
         done = true;
@@ -1560,54 +1976,50 @@ std::vector<ResultRow> QueryExecutor::executeWithProgress(
     } else {
         // Single-threaded execution (for small file counts)
         for (size_t i = 0; i < xmlFiles.size(); ++i) {
+            if (guard && guard->stopped()) {
+                break;
+            }
+            if (checkpoint && checkpoint->completed(xmlFiles[i])) {
+                continue;
+            }
             try {
-                auto fileResults = processFile(xmlFiles[i], query);
+                auto fileResults = processFileTracked(xmlFiles[i], query, stats, nullptr, prefilter.get(), guard.get(),
+                                                      incremental);
+                if (checkpoint && !(guard && guard->stopped())) {
+                    checkpoint->complete(xmlFiles[i], fileResults);
+                }
                 allResults.insert(allResults.end(), fileResults.begin(), fileResults.end());
 
                 if (progressCallback) {
                     progressCallback(i + 1, fileCount, 1);
                 }
+            } catch (const DocumentValidationError&) {
+                throw;
             } catch (const std::exception& e) {
                 std::cerr << "Error processing file " << xmlFiles[i] << ": " << e.what() << std::endl;
             }
         }
     }
+    markStage("scan");
+    finishScan(guard.get(), allResults, stats);
+    if (checkpoint && !(guard && guard->stopped())) {
+        checkpoint->finish();
+    }
+
+    // Files gave partial aggregates of their FOR bindings: merge them
+    if (query.has_aggregates && !query.for_clauses.empty()) {
+        allResults = mergeForAggregates(query, allResults);
+    }
 
     // Apply ORDER BY if specified
     if (!query.order_by_fields.empty()) {
         const auto& orderByField = query.order_by_fields[0];
         const std::string& orderField = orderByField.field_name;
-        bool ascending = (orderByField.direction == SortDirection::ASC);
+        bool descending = (orderByField.direction == SortDirection::DESC);
 
         std::sort(allResults.begin(), allResults.end(),
-            [&orderField, ascending](const ResultRow& a, const ResultRow& b) {
-                std::string aValue, bValue;
-
-                for (const auto& [field, value] : a) {
-                    if (field == orderField) {
-                        aValue = value;
-                        break;
-                    }
-                }
-
-                for (const auto& [field, value] : b) {
-                    if (field == orderField) {
-                        bValue = value;
-                        break;
-                    }
-                }
-
-                // Try numeric comparison first
-                bool result;
-                try {
-                    double aNum = std::stod(aValue);
-                    double bNum = std::stod(bValue);
-                    result = aNum < bNum;
-                } catch (...) {
-                    result = aValue < bValue;
-                }
-
-                return ascending ? result : !result;
+            [&orderField, descending](const ResultRow& a, const ResultRow& b) {
+                return compareRows(a, b, orderField, descending);
             }
         );
     }
@@ -1617,16 +2029,151 @@ std::vector<ResultRow> QueryExecutor::executeWithProgress(
         allResults.resize(query.limit);
     }
 
+    markStage("postprocess");
+
     auto endTime = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = endTime - startTime;
 
     if (stats) {
         stats->execution_time_seconds = elapsed.count();
+        stats->result_rows = allResults.size();
+        stats->finalizeFileCosts();
     }
 
     return allResults;
 }
 
+void ExecutionStats::recordFileCost(const FileCost& cost) {
+    total_parse_ms += cost.parse_ms;
+    total_eval_ms += cost.eval_ms;
+
+    // Min-heap on total cost: the cheapest kept file is evicted first
+    auto cheaper = [](const FileCost& a, const FileCost& b) {
+        return (a.parse_ms + a.eval_ms) > (b.parse_ms + b.eval_ms);
+    };
+
+    if (top_files.size() < top_files_limit) {
+        top_files.push_back(cost);
+        std::push_heap(top_files.begin(), top_files.end(), cheaper);
+    } else if (!top_files.empty() &&
+               cost.parse_ms + cost.eval_ms > top_files.front().parse_ms + top_files.front().eval_ms) {
+        std::pop_heap(top_files.begin(), top_files.end(), cheaper);
+        top_files.back() = cost;
+        std::push_heap(top_files.begin(), top_files.end(), cheaper);
+    }
+}
+
+void ExecutionStats::finalizeFileCosts() {
+    std::sort(top_files.begin(), top_files.end(), [](const FileCost& a, const FileCost& b) {
+        return (a.parse_ms + a.eval_ms) > (b.parse_ms + b.eval_ms);
+    });
+}
+
+std::string QueryExecutor::describePlan(const Query& query) {
+    std::string plan;
+
+    bool hasAggregates = std::any_of(query.select_fields.begin(), query.select_fields.end(),
+        [](const FieldPath& f) { return f.aggregate != AggregateFunc::NONE; });
+
+    if (isElementCount(query)) {
+        plan = "element count over raw bytes";
+    } else if (!query.for_clauses.empty()) {
+        plan = "FOR binding scan (" + std::to_string(query.for_clauses.size()) + " clause" +
+               (query.for_clauses.size() > 1 ? "s" : "") + ")";
+        if (!query.group_by_fields.empty()) {
+            plan += " + GROUP BY";
+        }
+        if (hasAggregates) {
+            plan += " + aggregates merged across files";
+        }
+    } else if (hasAggregates) {
+        plan = "aggregate extraction";
+        if (query.where) {
+            plan += " (WHERE not applied)";
+        }
+    } else if (!query.where) {
+        plan = "path extraction";
+    } else if (extractFieldPathFromWhere(query.where.get()).components.size() < 2) {
+        plan = "shorthand WHERE element scan";
+    } else if (extractFieldPathFromWhere(query.where.get()).is_anchored) {
+        plan = "anchored descent + WHERE";
+    } else {
+        plan = "partial path node scan + WHERE";
+    }
+
+    if (!hasAggregates && LiteralPrefilter::compile(query)) {
+        plan += " + literal prefilter";
+    }
+
+    if (!query.planning_schema.empty()) {
+        plan += " (paths resolved by " + query.planning_schema + ")";
+    }
+
+    if (!query.validate_schema.empty()) {
+        plan = "validate (" + std::string(query.invalid_policy == InvalidDocumentPolicy::FAIL
+                                          ? "fail" : "skip invalid") + ") + " + plan;
+    }
+
+    if (query.distinct) {
+        plan += " -> DISTINCT";
+    }
+    if (!query.order_by_fields.empty()) {
+        plan += " -> ORDER BY " + query.order_by_fields[0].field_name +
+                (query.order_by_fields[0].direction == SortDirection::DESC ? " DESC" : "");
+    }
+    if (query.offset >= 0) {
+        plan += " -> OFFSET " + std::to_string(query.offset);
+    }
+    if (query.limit >= 0) {
+        plan += " -> LIMIT " + std::to_string(query.limit);
+    }
+    return plan;
+}
+
+bool QueryExecutor::compareRows(
+    const ResultRow& a,
+    const ResultRow& b,
+    const std::string& orderField,
+    bool descending
+) {
+    // Find the field in both rows
+    std::string aValue, bValue;
+
+    for (const auto& [field, value] : a) {
+        if (field == orderField) {
+            aValue = value;
+            break;
+        }
+    }
+
+    for (const auto& [field, value] : b) {
+        if (field == orderField) {
+            bValue = value;
+            break;
+        }
+    }
+
+    // ISO-8601 dates and date-times sort chronologically (std::stod would
+    // stop at the year)
+    int64_t aInstant = 0;
+    int64_t bInstant = 0;
+    if (Temporal::parse(aValue, aInstant) && Temporal::parse(bValue, bInstant)) {
+        return descending ? (aInstant > bInstant) : (aInstant < bInstant);
+    }
+
+    // Try numeric comparison first
+    try {
+        double aNum = std::stod(aValue);
+        double bNum = std::stod(bValue);
+        // For descending, we want larger values first (a > b means a before b)
+        // For ascending, we want smaller values first (a < b means a before b)
+        return descending ? (aNum > bNum) : (aNum < bNum);
+    } catch (...) {
+        // Fall back to string comparison
+        return descending ? (aValue > bValue) : (aValue < bValue);
+    }
+}
+
 std::string QueryExecutor::computeAggregate(const FieldPath& field, const std::vector<ResultRow>& allResults) {
     // Build the field name we're looking for
     std::string targetField;
@@ -1648,67 +2195,51 @@ std::string QueryExecutor::computeAggregate(const FieldPath& field, const std::v
         return "";
     }
 
-    // Collect all values for this field
-    std::vector<double> numericValues;
+    // Gather the values into column batches; the kernels fold each full
+    // batch into the summary. Non-numeric values only count for COUNT.
+    ColumnBatch batch;
+    BatchSummary summary;
     size_t count = 0;
+    bool numeric = field.aggregate != AggregateFunc::COUNT;
 
     for (const auto& row : allResults) {
         for (const auto& [fieldName, fieldValue] : row) {
             if (fieldName == targetField && !fieldValue.empty()) {
-                try {
-                    double numValue = std::stod(fieldValue);
-                    numericValues.push_back(numValue);
-                    count++;
-                } catch (...) {
-                    // Not a number, skip for SUM/AVG/MIN/MAX but count for COUNT
-                    if (field.aggregate == AggregateFunc::COUNT) {
-                        count++;
+                count++;
+                if (numeric) {
+                    batch.append(fieldValue);
+                    if (batch.full()) {
+                        BatchKernels::accumulate(batch, nullptr, summary);
+                        batch.clear();
                     }
                 }
                 break; // Found the field in this row
             }
         }
     }
+    if (batch.size > 0) {
+        BatchKernels::accumulate(batch, nullptr, summary);
+    }
 
     switch (field.aggregate) {
         case AggregateFunc::COUNT:
             return std::to_string(count);
 
-        case AggregateFunc::SUM: {
-            if (numericValues.empty()) return "0";
-            double sum = 0;
-            for (double v : numericValues) {
-                sum += v;
-            }
-            return std::to_string(sum);
-        }
+        case AggregateFunc::SUM:
+            if (summary.count == 0) return "0";
+            return std::to_string(summary.sum);
 
-        case AggregateFunc::AVG: {
-            if (numericValues.empty()) return "0";
-            double sum = 0;
-            for (double v : numericValues) {
-                sum += v;
-            }
-            return std::to_string(sum / numericValues.size());
-        }
+        case AggregateFunc::AVG:
+            if (summary.count == 0) return "0";
+            return std::to_string(summary.sum / summary.count);
 
-        case AggregateFunc::MIN: {
-            if (numericValues.empty()) return "";
-            double minVal = numericValues[0];
-            for (double v : numericValues) {
-                if (v < minVal) minVal = v;
-            }
-            return std::to_string(minVal);
-        }
+        case AggregateFunc::MIN:
+            if (summary.count == 0) return "";
+            return std::to_string(summary.min);
 
-        case AggregateFunc::MAX: {
-            if (numericValues.empty()) return "";
-            double maxVal = numericValues[0];
-            for (double v : numericValues) {
-                if (v > maxVal) maxVal = v;
-            }
-            return std::to_string(maxVal);
-        }
+        case AggregateFunc::MAX:
+            if (summary.count == 0) return "";
+            return std::to_string(summary.max);
 
         default:
             return "";
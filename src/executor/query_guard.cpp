@@ -0,0 +1,239 @@
+#include "executor/query_guard.h"
+#include "executor/memory_budget.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <time.h>
+
+namespace expocli {
+
+namespace {
+
+// Bytes a result row holds: its strings and their slots
+uint64_t rowBytes(const std::vector<std::pair<std::string, std::string>>& row) {
+    uint64_t bytes = sizeof(row) + row.size() * sizeof(row[0]);
+    for (const auto& [name, value] : row) {
+        bytes += name.size() + value.size();
+    }
+    return bytes;
+}
+
+template <typename Value>
+std::string describe(const char* what, Value value, const char* unit) {
+    std::ostringstream oss;
+    oss << "Query stopped: " << what << " limit of " << value << unit << " reached";
+    return oss.str();
+}
+
+std::string upper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+    return text;
+}
+
+// A non-negative number in full
+bool parseSeconds(const std::string& text, double& seconds) {
+    char* end = nullptr;
+    seconds = std::strtod(text.c_str(), &end);
+    return !text.empty() && end == text.c_str() + text.size() && seconds >= 0;
+}
+
+std::string secondsOrOff(double seconds) {
+    std::ostringstream oss;
+    oss << seconds << " s";
+    return seconds > 0 ? oss.str() : "OFF";
+}
+
+std::string sizeOrOff(uint64_t bytes) {
+    return bytes > 0 ? std::to_string(bytes) + " bytes" : "OFF";
+}
+
+// CPU time of the calling thread
+uint64_t threadCpuNanos() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+std::atomic<uint64_t> nextGuardId{1};
+
+// A thread's last CPU reading and the query it was taken for
+struct CpuReading {
+    uint64_t guard = 0;
+    uint64_t nanos = 0;
+};
+thread_local CpuReading lastReading;
+
+} // namespace
+
+bool QueryLimits::isSetting(const std::string& name) {
+    static const char* names[] = {"TIMEOUT", "MAX_CPU_SECONDS", "MAX_BYTES_SCANNED",
+                                  "MAX_ROWS", "MAX_RESULT_MEMORY", "ON_LIMIT"};
+    return std::find(std::begin(names), std::end(names), name) != std::end(names);
+}
+
+bool QueryLimits::set(const std::string& name, const std::string& value, std::string& error) {
+    std::string text = upper(value);
+    if (name == "ON_LIMIT") {
+        if (text != "FAIL" && text != "PARTIAL") {
+            error = "ON_LIMIT must be FAIL or PARTIAL";
+            return false;
+        }
+        partial = text == "PARTIAL";
+        return true;
+    }
+
+    bool off = text == "OFF";
+    if (name == "TIMEOUT" || name == "MAX_CPU_SECONDS") {
+        double seconds = 0.0;
+        if (!off && !parseSeconds(value, seconds)) {
+            error = name + " requires a number of seconds or OFF";
+            return false;
+        }
+        (name == "TIMEOUT" ? timeout_seconds : cpu_seconds) = seconds;
+        return true;
+    }
+    if (name == "MAX_ROWS") {
+        uint64_t rows = 0;
+        if (!off && (value.empty() || !std::all_of(value.begin(), value.end(), ::isdigit))) {
+            error = "MAX_ROWS requires a number of rows or OFF";
+            return false;
+        }
+        if (!off) {
+            rows = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        max_rows = rows;
+        return true;
+    }
+    if (name == "MAX_BYTES_SCANNED" || name == "MAX_RESULT_MEMORY") {
+        uint64_t bytes = 0;
+        if (!off && !MemoryBudget::parseSize(value, bytes)) {
+            error = name + " requires a size such as 10GB, or OFF";
+            return false;
+        }
+        (name == "MAX_BYTES_SCANNED" ? max_bytes_scanned : max_result_bytes) = bytes;
+        return true;
+    }
+    error = "Unknown limit: " + name;
+    return false;
+}
+
+std::string QueryLimits::describe() const {
+    std::ostringstream oss;
+    oss << "TIMEOUT: " << secondsOrOff(timeout_seconds) << "\n"
+        << "MAX_CPU_SECONDS: " << secondsOrOff(cpu_seconds) << "\n"
+        << "MAX_BYTES_SCANNED: " << sizeOrOff(max_bytes_scanned) << "\n"
+        << "MAX_ROWS: " << (max_rows > 0 ? std::to_string(max_rows) : "OFF") << "\n"
+        << "MAX_RESULT_MEMORY: " << sizeOrOff(max_result_bytes) << "\n"
+        << "ON_LIMIT: " << (partial ? "PARTIAL" : "FAIL") << "\n";
+    return oss.str();
+}
+
+QueryGuard::QueryGuard(const QueryLimits& limits)
+    : limits_(limits),
+      start_(std::chrono::steady_clock::now()),
+      id_(nextGuardId.fetch_add(1, std::memory_order_relaxed)) {
+    // The query's own thread counts from here
+    lastReading = {id_, threadCpuNanos()};
+}
+
+void QueryGuard::stop(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(reasonMutex_);
+    if (!stopped_.load(std::memory_order_relaxed)) {
+        reason_ = reason;
+        stopped_.store(true, std::memory_order_relaxed);
+    }
+}
+
+uint64_t QueryGuard::addThreadCpu() {
+    uint64_t now = threadCpuNanos();
+    if (lastReading.guard != id_) {
+        // First check of this thread for the query
+        lastReading = {id_, now};
+        return cpuNanos_.load(std::memory_order_relaxed);
+    }
+    uint64_t delta = now - lastReading.nanos;
+    lastReading.nanos = now;
+    return cpuNanos_.fetch_add(delta, std::memory_order_relaxed) + delta;
+}
+
+bool QueryGuard::checkpoint() {
+    if (stopped()) {
+        return false;
+    }
+    if (limits_.timeout_seconds > 0) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+        if (elapsed.count() >= limits_.timeout_seconds) {
+            stop(describe("TIMEOUT", limits_.timeout_seconds, " s"));
+            return false;
+        }
+    }
+    if (limits_.cpu_seconds > 0) {
+        double cpu = static_cast<double>(addThreadCpu()) / 1e9;
+        if (cpu >= limits_.cpu_seconds) {
+            stop(describe("MAX_CPU_SECONDS", limits_.cpu_seconds, " s"));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool QueryGuard::scan(uint64_t fileBytes) {
+    if (limits_.max_bytes_scanned == 0) {
+        return !stopped();
+    }
+    uint64_t total = bytesScanned_.fetch_add(fileBytes, std::memory_order_relaxed) + fileBytes;
+    if (total > limits_.max_bytes_scanned) {
+        stop(describe("MAX_BYTES_SCANNED", limits_.max_bytes_scanned, " bytes"));
+        return false;
+    }
+    return !stopped();
+}
+
+bool QueryGuard::addRow(const std::vector<std::pair<std::string, std::string>>& row) {
+    if (limits_.max_rows > 0 &&
+        rows_.fetch_add(1, std::memory_order_relaxed) + 1 > limits_.max_rows) {
+        stop(describe("MAX_ROWS", limits_.max_rows, " rows"));
+        return false;
+    }
+    if (limits_.max_result_bytes > 0) {
+        uint64_t bytes = rowBytes(row);
+        if (resultBytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes > limits_.max_result_bytes) {
+            stop(describe("MAX_RESULT_MEMORY", limits_.max_result_bytes, " bytes"));
+            return false;
+        }
+    }
+    return poll();
+}
+
+bool QueryGuard::addRows(const std::vector<std::vector<std::pair<std::string, std::string>>>& rows) {
+    if (limits_.max_rows > 0 &&
+        rows_.fetch_add(rows.size(), std::memory_order_relaxed) + rows.size() > limits_.max_rows) {
+        stop(describe("MAX_ROWS", limits_.max_rows, " rows"));
+        return false;
+    }
+    if (limits_.max_result_bytes > 0) {
+        uint64_t bytes = 0;
+        for (const auto& row : rows) {
+            bytes += rowBytes(row);
+        }
+        if (resultBytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes > limits_.max_result_bytes) {
+            stop(describe("MAX_RESULT_MEMORY", limits_.max_result_bytes, " bytes"));
+            return false;
+        }
+    }
+    return !stopped();
+}
+
+std::string QueryGuard::reason() const {
+    std::lock_guard<std::mutex> lock(reasonMutex_);
+    return reason_;
+}
+
+void QueryGuard::finish() const {
+    if (stopped() && !limits_.partial) {
+        throw QueryLimitExceeded(reason());
+    }
+}
+
+} // namespace expocli
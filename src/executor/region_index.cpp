@@ -0,0 +1,198 @@
+#include "executor/region_index.h"
+#include <algorithm>
+
+namespace expocli {
+
+RegionIndex::RegionIndex(const pugi::xml_document& doc) {
+    // Iterative walk: documents can be far deeper than the call stack allows
+    std::vector<uint32_t> open;
+    uint32_t postCounter = 0;
+    std::string key;
+
+    auto close = [&]() {
+        uint32_t pre = open.back();
+        open.pop_back();
+        post_[pre] = postCounter++;
+        end_[pre] = static_cast<uint32_t>(nodes_.size());
+    };
+
+    pugi::xml_node current = doc.first_child();
+    while (current) {
+        if (current.type() == pugi::node_element) {
+            uint32_t pre = static_cast<uint32_t>(nodes_.size());
+            key.assign(current.name());
+            auto name = nameIds_.find(key);
+            if (name == nameIds_.end()) {
+                name = nameIds_.emplace(key, static_cast<uint32_t>(nameIds_.size())).first;
+                postings_.emplace_back();
+            }
+            postings_[name->second].push_back(pre);
+
+            nodes_.push_back(current);
+            names_.push_back(name->second);
+            post_.push_back(npos);
+            level_.push_back(static_cast<uint32_t>(open.size()));
+            parent_.push_back(open.empty() ? npos : open.back());
+            end_.push_back(npos);
+            preByNode_.emplace_back(current.internal_object(), pre);
+            for (pugi::xml_attribute attr : current.attributes()) {
+                key.assign(attr.name());
+                attributePostings_[key].push_back(pre);
+            }
+            open.push_back(pre);
+
+            if (current.first_child()) {
+                current = current.first_child();
+                continue;
+            }
+        }
+
+        // Leave finished nodes until one has a next sibling
+        while (current) {
+            if (current.type() == pugi::node_element) {
+                close();
+            }
+            if (current.next_sibling()) {
+                current = current.next_sibling();
+                break;
+            }
+            current = current.parent();
+            if (current.type() == pugi::node_document) {
+                current = pugi::xml_node();
+            }
+        }
+    }
+}
+
+uint32_t RegionIndex::pre(const pugi::xml_node& node) const {
+    if (!preSorted_) {
+        std::sort(preByNode_.begin(), preByNode_.end());
+        preSorted_ = true;
+    }
+    const void* object = node.internal_object();
+    auto it = std::lower_bound(preByNode_.begin(), preByNode_.end(), std::make_pair(object, uint32_t(0)));
+    return it != preByNode_.end() && it->first == object ? it->second : npos;
+}
+
+uint32_t RegionIndex::findName(const std::string& name) const {
+    auto it = nameIds_.find(name);
+    return it == nameIds_.end() ? npos : it->second;
+}
+
+bool RegionIndex::region(const pugi::xml_node& node, uint32_t& first, uint32_t& last) const {
+    if (node.type() == pugi::node_document) {
+        first = 0;
+        last = static_cast<uint32_t>(nodes_.size());
+        return true;
+    }
+    first = pre(node);
+    if (first == npos) {
+        return false;
+    }
+    last = end_[first];
+    return true;
+}
+
+void RegionIndex::elementsNamed(const pugi::xml_node& node, const std::string& name,
+                                std::vector<pugi::xml_node>& results) const {
+    uint32_t first, last;
+    uint32_t id = findName(name);
+    if (id == npos || !region(node, first, last)) {
+        return;
+    }
+    const auto& list = postings_[id];
+    for (auto it = std::lower_bound(list.begin(), list.end(), first);
+         it != list.end() && *it < last; ++it) {
+        results.push_back(nodes_[*it]);
+    }
+}
+
+pugi::xml_node RegionIndex::firstNamed(const pugi::xml_node& node, const std::string& name) const {
+    uint32_t first, last;
+    uint32_t id = findName(name);
+    if (id == npos || !region(node, first, last)) {
+        return pugi::xml_node();
+    }
+    const auto& list = postings_[id];
+    auto it = std::lower_bound(list.begin(), list.end(), first);
+    return it != list.end() && *it < last ? nodes_[*it] : pugi::xml_node();
+}
+
+bool RegionIndex::resolve(const std::vector<std::string>& path, std::vector<uint32_t>& ids) const {
+    ids.clear();
+    for (const auto& component : path) {
+        uint32_t id = findName(component);
+        if (id == npos) {
+            return false;
+        }
+        ids.push_back(id);
+    }
+    return !ids.empty();
+}
+
+bool RegionIndex::endsWith(uint32_t pre, const std::vector<uint32_t>& ids) const {
+    for (size_t i = ids.size(); i-- > 0;) {
+        if (pre == npos || names_[pre] != ids[i]) {
+            return false;
+        }
+        pre = parent_[pre];
+    }
+    return true;
+}
+
+void RegionIndex::elementsByPartialPath(const pugi::xml_node& node, const std::vector<std::string>& path,
+                                        std::vector<pugi::xml_node>& results) const {
+    uint32_t first, last;
+    std::vector<uint32_t> ids;
+    if (!resolve(path, ids) || !region(node, first, last)) {
+        return;
+    }
+    const auto& list = postings_[ids.back()];
+    for (auto it = std::lower_bound(list.begin(), list.end(), first);
+         it != list.end() && *it < last; ++it) {
+        if (endsWith(*it, ids)) {
+            results.push_back(nodes_[*it]);
+        }
+    }
+}
+
+void RegionIndex::elementsByAbsolutePath(const std::vector<std::string>& path,
+                                         std::vector<pugi::xml_node>& results) const {
+    std::vector<uint32_t> ids;
+    if (!resolve(path, ids)) {
+        return;
+    }
+    for (uint32_t pre : postings_[ids.back()]) {
+        if (level_[pre] + 1 == ids.size() && endsWith(pre, ids)) {
+            results.push_back(nodes_[pre]);
+        }
+    }
+}
+
+void RegionIndex::elementsWithAttribute(const std::string& name,
+                                        std::vector<pugi::xml_node>& results) const {
+    auto it = attributePostings_.find(name);
+    if (it == attributePostings_.end()) {
+        return;
+    }
+    for (uint32_t pre : it->second) {
+        results.push_back(nodes_[pre]);
+    }
+}
+
+std::string RegionIndex::pathOf(uint32_t pre) const {
+    std::vector<uint32_t> chain;
+    for (; pre != npos; pre = parent_[pre]) {
+        chain.push_back(pre);
+    }
+    std::string path;
+    for (size_t i = chain.size(); i-- > 0;) {
+        if (!path.empty()) {
+            path += '.';
+        }
+        path += nodes_[chain[i]].name();
+    }
+    return path;
+}
+
+} // namespace expocli
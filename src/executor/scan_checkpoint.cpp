@@ -0,0 +1,227 @@
+#include "executor/scan_checkpoint.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace expocli {
+
+namespace {
+
+constexpr char kCheckpointMagic[8] = {'E', 'X', 'P', 'O', 'C', 'K', 'P', 'T'};
+constexpr uint32_t kCheckpointVersion = 1;
+
+// Fixed-width fields in host byte order, as in the validation cache
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::string& out) : out_(out) {}
+
+    void u32(uint32_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void u64(uint64_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void str(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        out_.append(value);
+    }
+
+private:
+    std::string& out_;
+};
+
+class CheckpointReader {
+public:
+    CheckpointReader(const std::string& in, size_t pos) : in_(in), pos_(pos) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == in_.size(); }
+    size_t position() const { return pos_; }
+
+    uint32_t u32() { return read<uint32_t>(); }
+    uint64_t u64() { return read<uint64_t>(); }
+    std::string str() {
+        uint32_t length = u32();
+        if (!take(length)) {
+            return std::string();
+        }
+        return in_.substr(pos_ - length, length);
+    }
+
+private:
+    const std::string& in_;
+    size_t pos_;
+    bool ok_ = true;
+
+    bool take(size_t length) {
+        if (!ok_ || in_.size() - pos_ < length) {
+            ok_ = false;
+            return false;
+        }
+        pos_ += length;
+        return true;
+    }
+
+    template <typename T>
+    T read() {
+        T value = 0;
+        if (take(sizeof(value))) {
+            std::memcpy(&value, in_.data() + pos_ - sizeof(value), sizeof(value));
+        }
+        return value;
+    }
+};
+
+uint64_t mix(uint64_t h, uint64_t value) {
+    h = (h ^ value) * 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 31);
+}
+
+// Paths, sizes and modification times of the files, in any order
+uint64_t fingerprintOf(std::vector<std::string> files) {
+    std::sort(files.begin(), files.end());
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    for (const auto& file : files) {
+        for (unsigned char c : file) {
+            h = mix(h, c);
+        }
+        std::error_code ec;
+        uint64_t size = std::filesystem::file_size(file, ec);
+        h = mix(h, ec ? 0 : size);
+        auto mtime = std::filesystem::last_write_time(file, ec);
+        h = mix(h, ec ? 0 : static_cast<uint64_t>(mtime.time_since_epoch().count()));
+    }
+    return h;
+}
+
+} // namespace
+
+ScanCheckpoint::ScanCheckpoint(const std::string& path, const std::string& queryText)
+    : path_(path), query_(queryText) {}
+
+ScanCheckpoint::~ScanCheckpoint() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush();
+}
+
+void ScanCheckpoint::begin(const std::vector<std::string>& files) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fingerprint_ = fingerprintOf(files);
+    completed_.clear();
+    rows_.clear();
+    counted_ = 0;
+
+    size_t valid = load();
+    resumed_ = completed_.size();
+    if (valid > 0) {
+        // Drop a record cut short, then carry on after the last whole one
+        std::error_code ec;
+        std::filesystem::resize_file(path_, valid, ec);
+        out_.open(path_, std::ios::binary | std::ios::app);
+    } else {
+        std::string header(kCheckpointMagic, sizeof(kCheckpointMagic));
+        CheckpointWriter writer(header);
+        writer.u32(kCheckpointVersion);
+        writer.str(query_);
+        writer.u64(fingerprint_);
+        out_.open(path_, std::ios::binary | std::ios::trunc);
+        out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out_.flush();
+    }
+    if (!out_) {
+        throw std::runtime_error("Cannot write checkpoint file: " + path_);
+    }
+    lastFlush_ = std::chrono::steady_clock::now();
+}
+
+size_t ScanCheckpoint::load() {
+    std::ifstream in(path_, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return 0;
+    }
+    std::string data(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    if (!in.read(&data[0], static_cast<std::streamsize>(data.size())) ||
+        data.size() < sizeof(kCheckpointMagic) ||
+        std::memcmp(data.data(), kCheckpointMagic, sizeof(kCheckpointMagic)) != 0) {
+        return 0;
+    }
+
+    CheckpointReader reader(data, sizeof(kCheckpointMagic));
+    if (reader.u32() != kCheckpointVersion || reader.str() != query_ ||
+        reader.u64() != fingerprint_ || !reader.ok()) {
+        return 0;
+    }
+
+    // Whole records only; a crash can leave the last one incomplete
+    size_t valid = reader.position();
+    while (!reader.atEnd()) {
+        std::string file = reader.str();
+        uint64_t counted = reader.u64();
+        uint32_t rowCount = reader.u32();
+        std::vector<ResultRow> rows;
+        for (uint32_t i = 0; i < rowCount && reader.ok(); ++i) {
+            ResultRow row;
+            uint32_t fieldCount = reader.u32();
+            for (uint32_t j = 0; j < fieldCount && reader.ok(); ++j) {
+                std::string name = reader.str();
+                row.emplace_back(std::move(name), reader.str());
+            }
+            rows.push_back(std::move(row));
+        }
+        if (!reader.ok()) {
+            break;
+        }
+        completed_.insert(std::move(file));
+        counted_ += counted;
+        rows_.insert(rows_.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+        valid = reader.position();
+    }
+    return valid;
+}
+
+bool ScanCheckpoint::completed(const std::string& file) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completed_.count(file) > 0;
+}
+
+std::vector<ResultRow> ScanCheckpoint::takeRows() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(rows_);
+}
+
+void ScanCheckpoint::complete(const std::string& file, const std::vector<ResultRow>& rows, uint64_t counted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CheckpointWriter writer(pending_);
+    writer.str(file);
+    writer.u64(counted);
+    writer.u32(static_cast<uint32_t>(rows.size()));
+    for (const auto& row : rows) {
+        writer.u32(static_cast<uint32_t>(row.size()));
+        for (const auto& [name, value] : row) {
+            writer.str(name);
+            writer.str(value);
+        }
+    }
+    if (std::chrono::steady_clock::now() - lastFlush_ >= kFlushInterval) {
+        flush();
+    }
+}
+
+void ScanCheckpoint::flush() {
+    if (out_.is_open() && !pending_.empty()) {
+        out_.write(pending_.data(), static_cast<std::streamsize>(pending_.size()));
+        out_.flush();
+        pending_.clear();
+    }
+    lastFlush_ = std::chrono::steady_clock::now();
+}
+
+void ScanCheckpoint::finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    if (out_.is_open()) {
+        out_.close();
+    }
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+}
+
+} // namespace expocli
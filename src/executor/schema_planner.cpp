@@ -0,0 +1,261 @@
+#include "executor/schema_planner.h"
+#include "utils/temporal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace expocli {
+
+namespace {
+
+// Element paths beyond this are not enumerated; the query then runs unplanned
+constexpr size_t kMaxSchemaPaths = 100000;
+
+struct SchemaPath {
+    std::vector<uint32_t> names;  // Interned names, root first
+    XsdType type;
+};
+
+// Every element path a conforming document can contain
+class SchemaPathIndex {
+public:
+    explicit SchemaPathIndex(const CompiledSchema& schema) : schema_(schema) {
+        std::vector<uint32_t> names;
+        std::vector<uint32_t> contentTypes;
+        addPaths(schema.root(), names, contentTypes);
+    }
+
+    // False if the schema is recursive or too large to enumerate
+    bool complete() const { return complete_; }
+
+    // Paths ending with the given components
+    std::vector<const SchemaPath*> match(const std::vector<std::string>& components) const {
+        std::vector<const SchemaPath*> matches;
+        auto it = byLastName_.find(components.back());
+        if (it == byLastName_.end()) {
+            return matches;
+        }
+        for (size_t index : it->second) {
+            const SchemaPath& path = paths_[index];
+            if (path.names.size() < components.size()) {
+                continue;
+            }
+            size_t offset = path.names.size() - components.size();
+            bool same = true;
+            for (size_t i = 0; i < components.size() && same; ++i) {
+                same = schema_.name(path.names[offset + i]) == components[i];
+            }
+            if (same) {
+                matches.push_back(&path);
+            }
+        }
+        return matches;
+    }
+
+    // Declared types of an attribute name (empty if no element declares it)
+    const std::vector<XsdType>& attributeTypes(const std::string& name) const {
+        static const std::vector<XsdType> none;
+        auto it = attributes_.find(name);
+        return it == attributes_.end() ? none : it->second;
+    }
+
+    std::vector<std::string> components(const SchemaPath& path) const {
+        std::vector<std::string> result;
+        for (uint32_t name : path.names) {
+            result.push_back(schema_.name(name));
+        }
+        return result;
+    }
+
+private:
+    void addPaths(const CompiledElement& element, std::vector<uint32_t>& names,
+                  std::vector<uint32_t>& contentTypes) {
+        if (!complete_) {
+            return;
+        }
+        for (uint32_t active : contentTypes) {
+            if (active == element.contentType) {
+                complete_ = false;  // Recursive content model: paths are unbounded
+                return;
+            }
+        }
+        if (paths_.size() >= kMaxSchemaPaths) {
+            complete_ = false;
+            return;
+        }
+
+        names.push_back(element.name);
+        byLastName_[schema_.name(element.name)].push_back(paths_.size());
+        paths_.push_back({names, element.type});
+
+        const CompiledContentType& type = schema_.contentType(element.contentType);
+        for (uint32_t i = 0; i < type.attributeCount; ++i) {
+            const CompiledAttribute& attr = schema_.attribute(type.firstAttribute + i);
+            auto& types = attributes_[schema_.name(attr.name)];
+            if (std::find(types.begin(), types.end(), attr.type) == types.end()) {
+                types.push_back(attr.type);
+            }
+        }
+
+        contentTypes.push_back(element.contentType);
+        for (uint32_t i = 0; i < type.childCount; ++i) {
+            addPaths(schema_.element(type.firstChild + i), names, contentTypes);
+        }
+        contentTypes.pop_back();
+        names.pop_back();
+    }
+
+    const CompiledSchema& schema_;
+    std::vector<SchemaPath> paths_;
+    std::unordered_map<std::string, std::vector<size_t>> byLastName_;
+    std::map<std::string, std::vector<XsdType>> attributes_;
+    bool complete_ = true;
+};
+
+std::string describeField(const FieldPath& field) {
+    if (field.is_attribute) {
+        return "@" + field.attribute_name;
+    }
+    std::string text = field.is_partial_path ? "." : "";
+    for (size_t i = 0; i < field.components.size(); ++i) {
+        text += (i > 0 ? "." : "") + field.components[i];
+    }
+    return text;
+}
+
+bool isNumberLiteral(const std::string& value) {
+    if (value.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    std::strtod(value.c_str(), &end);
+    return errno == 0 && end == value.c_str() + value.size();
+}
+
+class Planner {
+public:
+    Planner(const SchemaPathIndex& index, const std::string& schemaName)
+        : index_(index), schemaName_(schemaName) {}
+
+    // Anchors the field if it has a single possible path; returns the declared
+    // types of everything it can match
+    std::vector<XsdType> resolve(FieldPath& field) {
+        if (field.include_filename || field.is_variable_ref ||
+            field.aggregate != AggregateFunc::NONE) {
+            return {};
+        }
+
+        if (field.is_attribute) {
+            const auto& types = index_.attributeTypes(field.attribute_name);
+            if (types.empty()) {
+                throw std::runtime_error("Attribute '" + describeField(field) +
+                                         "' is not declared in schema " + schemaName_);
+            }
+            return types;
+        }
+        if (field.components.empty()) {
+            return {};
+        }
+
+        auto matches = index_.match(field.components);
+        if (matches.empty()) {
+            throw std::runtime_error("Path '" + describeField(field) +
+                                     "' cannot match any element of schema " + schemaName_);
+        }
+
+        // A bare single name keeps its own meaning (the root in SELECT, any
+        // element in WHERE); dotted and multi-component paths are suffixes
+        bool suffixPath = field.is_partial_path || field.components.size() > 1;
+        if (suffixPath && matches.size() == 1) {
+            field.components = index_.components(*matches.front());
+            field.is_partial_path = false;
+            field.is_anchored = true;
+        }
+
+        std::vector<XsdType> types;
+        for (const SchemaPath* path : matches) {
+            if (std::find(types.begin(), types.end(), path->type) == types.end()) {
+                types.push_back(path->type);
+            }
+        }
+        return types;
+    }
+
+    void resolveWhere(WhereExpr* expr) {
+        if (auto* logical = dynamic_cast<WhereLogical*>(expr)) {
+            resolveWhere(logical->left.get());
+            resolveWhere(logical->right.get());
+            return;
+        }
+        auto* condition = dynamic_cast<WhereCondition*>(expr);
+        if (!condition) {
+            return;
+        }
+
+        std::vector<XsdType> types = resolve(condition->field);
+        if (types.size() != 1) {
+            return;  // Unknown or mixed types: keep the literal's comparison
+        }
+        switch (condition->op) {
+            case ComparisonOp::EQUALS:
+            case ComparisonOp::NOT_EQUALS:
+            case ComparisonOp::LESS_THAN:
+            case ComparisonOp::GREATER_THAN:
+            case ComparisonOp::LESS_EQUAL:
+            case ComparisonOp::GREATER_EQUAL:
+                break;
+            default:
+                return;
+        }
+
+        switch (types.front()) {
+            case XsdType::INTEGER:
+            case XsdType::DECIMAL:
+                if (isNumberLiteral(condition->value)) {
+                    condition->is_numeric = true;
+                }
+                break;
+            case XsdType::DATE:
+            case XsdType::DATETIME:
+                if (Temporal::parse(condition->value, condition->temporal_value)) {
+                    condition->is_numeric = false;
+                    condition->is_temporal = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    const SchemaPathIndex& index_;
+    const std::string& schemaName_;
+};
+
+} // namespace
+
+void SchemaPlanner::plan(Query& query, const CompiledSchema& schema, const std::string& schemaName) {
+    if (!schema.hasRoot() || !query.for_clauses.empty()) {
+        return;
+    }
+
+    SchemaPathIndex index(schema);
+    if (!index.complete()) {
+        return;
+    }
+
+    Planner planner(index, schemaName);
+    for (auto& field : query.select_fields) {
+        planner.resolve(field);
+    }
+    if (query.where) {
+        planner.resolveWhere(query.where.get());
+    }
+    query.planning_schema = schemaName;
+}
+
+} // namespace expocli
@@ -1,4 +1,6 @@
 #include "executor/xml_navigator.h"
+#include "utils/temporal.h"
+#include <cstring>
 #include <stdexcept>
 #include <typeinfo>
 #include <functional>
@@ -10,7 +12,8 @@ namespace expocli {
 std::vector<XmlResult> XmlNavigator::extractValues(
     const pugi::xml_document& doc,
     const std::string& filename,
-    const FieldPath& field
+    const FieldPath& field,
+    const DocumentIndex* index
 ) {
     std::vector<XmlResult> results;
 
@@ -20,29 +23,62 @@ std::vector<XmlResult> XmlNavigator::extractValues(
         return results;
     }
 
-    // Handle attribute extraction (@attribute)
-    if (field.is_attribute) {
-        // Search for all nodes in the document and extract the attribute
-        std::function<void(const pugi::xml_node&)> findAllWithAttribute =
-            [&](const pugi::xml_node& node) {
-                if (!node) return;
-
-                // Check if this node has the requested attribute
-                pugi::xml_attribute attr = node.attribute(field.attribute_name.c_str());
-                if (attr) {
-                    std::string value = attr.value();
-                    if (!value.empty()) {
-                        results.push_back({filename, value});
-                    }
-                }
+    // Built on first use when the caller keeps no index
+    DocumentIndex localIndex(doc);
+    const DocumentIndex& documentIndex = index ? *index : localIndex;
 
-                // Recursively search all children
-                for (pugi::xml_node child : node.children()) {
-                    findAllWithAttribute(child);
-                }
-            };
+    // Nodes in document order; values of empty nodes are skipped
+    auto appendValues = [&](const std::vector<pugi::xml_node>& nodes) {
+        for (const auto& node : nodes) {
+            std::string value = node.child_value();
+            if (!value.empty()) {
+                results.push_back({filename, value});
+            }
+        }
+    };
 
-        findAllWithAttribute(doc);
+    // Partial paths must resolve to a single location. Paths are compared
+    // name by name up the parent chain; strings are only built for the error.
+    auto samePath = [](pugi::xml_node a, pugi::xml_node b) {
+        while (a && b && a != b) {
+            if (std::strcmp(a.name(), b.name()) != 0) {
+                return false;
+            }
+            a = a.parent();
+            b = b.parent();
+        }
+        return a == b;
+    };
+    auto checkAmbiguity = [&](const std::vector<pugi::xml_node>& nodes, const std::string& partialPath) {
+        bool ambiguous = false;
+        for (size_t i = 1; i < nodes.size() && !ambiguous; ++i) {
+            ambiguous = !samePath(nodes.front(), nodes[i]);
+        }
+        if (ambiguous) {
+            const RegionIndex& regions = documentIndex.get();
+            std::set<std::string> fullPaths;
+            for (const auto& node : nodes) {
+                fullPaths.insert(regions.pathOf(regions.pre(node)));
+            }
+            std::string pathList;
+            for (const auto& path : fullPaths) {
+                if (!pathList.empty()) pathList += "\n  - ";
+                pathList += path;
+            }
+            throw std::runtime_error("Ambiguous path '." + partialPath + "': found at multiple locations:\n  - " + pathList + "\nUse full path to disambiguate.");
+        }
+    };
+
+    // Handle attribute extraction (@attribute): every element carrying it
+    if (field.is_attribute) {
+        std::vector<pugi::xml_node> nodes;
+        documentIndex.get().elementsWithAttribute(field.attribute_name, nodes);
+        for (const auto& node : nodes) {
+            std::string value = node.attribute(field.attribute_name.c_str()).value();
+            if (!value.empty()) {
+                results.push_back({filename, value});
+            }
+        }
         return results;
     }
 
@@ -50,6 +86,15 @@ std::vector<XmlResult> XmlNavigator::extractValues(
         return results;
     }
 
+    // Anchored path (resolved against the schema): plain descent from the root,
+    // the schema already ruled out other locations
+    if (field.is_anchored) {
+        std::vector<pugi::xml_node> nodes;
+        findNodes(doc, field.components, 0, nodes);
+        appendValues(nodes);
+        return results;
+    }
+
     // Single component path resolution
     if (field.components.size() == 1) {
         const std::string& targetName = field.components[0];
@@ -63,111 +108,33 @@ std::vector<XmlResult> XmlNavigator::extractValues(
                     results.push_back({filename, value});
                 }
             }
-            return results;
-        } else {
-            // Leading dot: partial path - search recursively with ambiguity check
-            std::set<std::string> fullPaths;
-            std::function<void(const pugi::xml_node&, const std::string&)> findAllByName =
-                [&](const pugi::xml_node& node, const std::string& currentPath) {
-                    if (!node) return;
-
-                    // Build current path
-                    std::string nodePath = currentPath;
-                    if (node.type() == pugi::node_element) {
-                        if (!nodePath.empty()) nodePath += ".";
-                        nodePath += node.name();
-
-                        // Check if this element matches the target name
-                        if (std::string(node.name()) == targetName) {
-                            fullPaths.insert(nodePath);
-                            std::string value = node.child_value();
-                            if (!value.empty()) {
-                                results.push_back({filename, value});
-                            }
-                        }
-                    }
-
-                    // Recursively search all children
-                    for (pugi::xml_node child : node.children()) {
-                        findAllByName(child, nodePath);
-                    }
-                };
-
-            findAllByName(doc, "");
-
-            // Check for ambiguity: if multiple different paths found, error
-            if (fullPaths.size() > 1) {
-                std::string pathList;
-                for (const auto& path : fullPaths) {
-                    if (!pathList.empty()) pathList += "\n  - ";
-                    pathList += path;
-                }
-                throw std::runtime_error("Ambiguous path '." + targetName + "': found at multiple locations:\n  - " + pathList + "\nUse full path to disambiguate.");
-            }
-
             return results;
         }
+
+        // Leading dot: every element of that name, which must all share one path
+        std::vector<pugi::xml_node> nodes;
+        documentIndex.get().elementsNamed(doc, targetName, nodes);
+        checkAmbiguity(nodes, targetName);
+        appendValues(nodes);
+        return results;
     }
 
     // Multi-component path: use partial path matching (suffix matching)
     // This allows ".book.price" to match any path ending with those components
     std::vector<pugi::xml_node> nodes;
-    findNodesByPartialPath(doc, field.components, nodes);
+    documentIndex.get().elementsByPartialPath(doc, field.components, nodes);
 
     // For partial paths, check for ambiguity
     if (field.is_partial_path && !nodes.empty()) {
-        // Helper to build full path from node to root
-        auto getNodePath = [](pugi::xml_node n) -> std::vector<std::string> {
-            std::vector<std::string> nodePath;
-            while (n && n.type() == pugi::node_element) {
-                nodePath.insert(nodePath.begin(), std::string(n.name()));
-                n = n.parent();
-            }
-            return nodePath;
-        };
-
-        // Collect all unique full paths
-        std::set<std::string> fullPaths;
-        for (const auto& node : nodes) {
-            if (node) {
-                std::vector<std::string> nodePath = getNodePath(node);
-                std::string pathStr;
-                for (size_t i = 0; i < nodePath.size(); ++i) {
-                    if (i > 0) pathStr += ".";
-                    pathStr += nodePath[i];
-                }
-                fullPaths.insert(pathStr);
-            }
-        }
-
-        // Check for ambiguity: if multiple different paths found, error
-        if (fullPaths.size() > 1) {
-            std::string pathList;
-            for (const auto& path : fullPaths) {
-                if (!pathList.empty()) pathList += "\n  - ";
-                pathList += path;
-            }
-
-            std::string partialPathStr;
-            for (size_t i = 0; i < field.components.size(); ++i) {
-                if (i > 0) partialPathStr += ".";
-                partialPathStr += field.components[i];
-            }
-
-            throw std::runtime_error("Ambiguous path '." + partialPathStr + "': found at multiple locations:\n  - " + pathList + "\nUse full path to disambiguate.");
-        }
-    }
-
-    // Extract values from found nodes
-    for (const auto& node : nodes) {
-        if (node) {
-            std::string value = node.child_value();
-            if (!value.empty()) {
-                results.push_back({filename, value});
-            }
+        std::string partialPathStr;
+        for (size_t i = 0; i < field.components.size(); ++i) {
+            if (i > 0) partialPathStr += ".";
+            partialPathStr += field.components[i];
         }
+        checkAmbiguity(nodes, partialPathStr);
     }
 
+    appendValues(nodes);
     return results;
 }
 
@@ -245,6 +212,9 @@ bool XmlNavigator::evaluateCondition(
         return false;
     }
 
+    if (condition.is_temporal) {
+        return compareTemporal(nodeValue, condition);
+    }
     return compareValues(nodeValue, condition.value, condition.op, condition.is_numeric);
 }
 
@@ -291,6 +261,9 @@ bool XmlNavigator::evaluateCondition(
         return false;
     }
 
+    if (condition.is_temporal) {
+        return compareTemporal(nodeValue, condition);
+    }
     return compareValues(nodeValue, condition.value, condition.op, condition.is_numeric);
 }
 
@@ -400,6 +373,10 @@ std::string XmlNavigator::getNodeValue(
         return "";
     }
 
+    if (field.is_anchored) {
+        return getAnchoredValue(node, field.components);
+    }
+
     // Shorthand: if only one component, search from current node downward
     if (field.components.size() == 1) {
         pugi::xml_node foundNode = findFirstElementByName(node, field.components[0]);
@@ -424,27 +401,32 @@ std::string XmlNavigator::getNodeValueRelative(
     const pugi::xml_node& node,
     const FieldPath& field,
     size_t offset
+) {
+    return nodeValueRelative(node, field, offset);
+}
+
+const char* XmlNavigator::nodeValueRelative(
+    const pugi::xml_node& node,
+    const FieldPath& field,
+    size_t offset
 ) {
     // Handle attribute extraction
     if (field.is_attribute) {
-        pugi::xml_attribute attr = node.attribute(field.attribute_name.c_str());
-        if (attr) {
-            return attr.value();
-        }
-        return "";
+        return node.attribute(field.attribute_name.c_str()).value();
     }
 
     if (field.components.empty() || offset >= field.components.size()) {
         return "";
     }
 
+    // Anchored paths locate themselves relative to the node's own position
+    if (field.is_anchored) {
+        return anchoredValue(node, field.components);
+    }
+
     // Shorthand: if only one component (after offset), search from current node
     if (field.components.size() == 1 && offset == 0) {
-        pugi::xml_node foundNode = findFirstElementByName(node, field.components[0]);
-        if (foundNode) {
-            return foundNode.child_value();
-        }
-        return "";
+        return findFirstElementByName(node, field.components[0]).child_value();
     }
 
     // Navigate using only the components after 'offset'
@@ -524,6 +506,82 @@ bool XmlNavigator::compareValues(
     return false;
 }
 
+bool XmlNavigator::compareTemporal(
+    const std::string& nodeValue,
+    const WhereCondition& condition
+) {
+    int64_t nodeInstant = 0;
+    if (!Temporal::parse(nodeValue, nodeInstant)) {
+        return compareValues(nodeValue, condition.value, condition.op, false);
+    }
+
+    const int64_t target = condition.temporal_value;
+    switch (condition.op) {
+        case ComparisonOp::EQUALS:
+            return nodeInstant == target;
+        case ComparisonOp::NOT_EQUALS:
+            return nodeInstant != target;
+        case ComparisonOp::LESS_THAN:
+            return nodeInstant < target;
+        case ComparisonOp::GREATER_THAN:
+            return nodeInstant > target;
+        case ComparisonOp::LESS_EQUAL:
+            return nodeInstant <= target;
+        case ComparisonOp::GREATER_EQUAL:
+            return nodeInstant >= target;
+        default:
+            return false;
+    }
+}
+
+std::string XmlNavigator::getAnchoredValue(
+    const pugi::xml_node& node,
+    const std::vector<std::string>& path
+) {
+    return anchoredValue(node, path);
+}
+
+const char* XmlNavigator::anchoredValue(
+    const pugi::xml_node& node,
+    const std::vector<std::string>& path
+) {
+    // The node's own path must be a prefix of the anchored path
+    std::vector<const char*> ancestors;
+    for (pugi::xml_node n = node; n && n.type() == pugi::node_element; n = n.parent()) {
+        ancestors.push_back(n.name());
+    }
+    if (ancestors.size() > path.size()) {
+        return "";
+    }
+    for (size_t i = 0; i < ancestors.size(); ++i) {
+        if (path[i] != ancestors[ancestors.size() - 1 - i]) {
+            return "";
+        }
+    }
+
+    if (ancestors.size() == path.size()) {
+        return node.child_value();
+    }
+    return findFirstNode(node, path, ancestors.size()).child_value();
+}
+
+pugi::xml_node XmlNavigator::findFirstNode(
+    const pugi::xml_node& node,
+    const std::vector<std::string>& path,
+    size_t depth
+) {
+    for (pugi::xml_node child : node.children(path[depth].c_str())) {
+        if (depth == path.size() - 1) {
+            return child;
+        }
+        pugi::xml_node found = findFirstNode(child, path, depth + 1);
+        if (found) {
+            return found;
+        }
+    }
+    return pugi::xml_node();
+}
+
 pugi::xml_node XmlNavigator::findFirstElementByName(
     const pugi::xml_node& node,
     const std::string& name
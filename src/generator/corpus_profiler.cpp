@@ -0,0 +1,516 @@
+#include "generator/corpus_profiler.h"
+#include "utils/temporal.h"
+#include "utils/xml_loader.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+namespace expocli {
+
+namespace {
+
+// Distinct values are counted with a k-minimum-values sketch of this size:
+// exact below it, within a few percent above
+constexpr size_t kSketchSize = 1024;
+
+// Values whose frequencies are counted exactly, to measure skew
+constexpr size_t kMaxTrackedValues = 4096;
+
+// Running sums of a numeric sample (mergeable between threads)
+struct Moments {
+    uint64_t n = 0;
+    double sum = 0.0;
+    double sumSq = 0.0;
+    double sumCube = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    bool positive = true;
+    double sumLog = 0.0;
+    double sumLogSq = 0.0;
+
+    void add(double x, uint64_t weight = 1) {
+        double w = static_cast<double>(weight);
+        n += weight;
+        sum += w * x;
+        sumSq += w * x * x;
+        sumCube += w * x * x * x;
+        min = std::min(min, x);
+        max = std::max(max, x);
+        if (x > 0.0) {
+            double l = std::log(x);
+            sumLog += w * l;
+            sumLogSq += w * l * l;
+        } else {
+            positive = false;
+        }
+    }
+
+    void merge(const Moments& other) {
+        n += other.n;
+        sum += other.sum;
+        sumSq += other.sumSq;
+        sumCube += other.sumCube;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        positive = positive && other.positive;
+        sumLog += other.sumLog;
+        sumLogSq += other.sumLogSq;
+    }
+
+    // Constant, uniform, lognormal (right-skewed positive data) or normal
+    Distribution fit() const {
+        if (n == 0) {
+            return Distribution();
+        }
+        if (max - min < 1e-9) {
+            return Distribution::constant(min);
+        }
+        double count = static_cast<double>(n);
+        double mean = sum / count;
+        double variance = std::max(0.0, sumSq / count - mean * mean);
+        double sd = std::sqrt(variance);
+        double skewness = sd > 0.0
+            ? (sumCube / count - 3.0 * mean * variance - mean * mean * mean) / (sd * sd * sd)
+            : 0.0;
+
+        if (positive && skewness > 1.0) {
+            double meanLog = sumLog / count;
+            double sdLog = std::sqrt(std::max(0.0, sumLogSq / count - meanLog * meanLog));
+            return Distribution::lognormal(std::exp(meanLog), sdLog);
+        }
+        double uniformSd = (max - min) / std::sqrt(12.0);
+        if (std::abs(sd - uniformSd) < 0.1 * uniformSd && std::abs(skewness) < 0.3) {
+            return Distribution::uniform(min, max);
+        }
+        return Distribution::normal(mean, sd);
+    }
+};
+
+uint64_t hashValue(const std::string& value) {
+    uint64_t h = 14695981039346656037ull;
+    for (char c : value) {
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+bool isInteger(const std::string& text) {
+    size_t i = (text[0] == '-' || text[0] == '+') ? 1 : 0;
+    if (i == text.size()) {
+        return false;
+    }
+    for (; i < text.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(text[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isDecimal(const std::string& text) {
+    size_t i = (text[0] == '-' || text[0] == '+') ? 1 : 0;
+    bool digits = false;
+    bool point = false;
+    for (; i < text.size(); ++i) {
+        if (std::isdigit(static_cast<unsigned char>(text[i]))) {
+            digits = true;
+        } else if (text[i] == '.' && !point) {
+            point = true;
+        } else {
+            return false;
+        }
+    }
+    return digits;
+}
+
+// Values seen at one path
+struct ValueStats {
+    uint64_t count = 0;
+    bool integer = true;
+    bool decimal = true;
+    bool boolean = true;
+    bool date = true;
+    bool dateTime = true;
+    Moments numbers;
+    Moments lengths;
+    std::set<uint64_t> sketch;          // Smallest value hashes
+    std::unordered_map<std::string, uint64_t> frequencies;
+    bool frequenciesComplete = true;
+
+    void add(const char* raw) {
+        size_t length = std::strlen(raw);
+        size_t start = 0;
+        while (start < length && std::isspace(static_cast<unsigned char>(raw[start]))) ++start;
+        while (length > start && std::isspace(static_cast<unsigned char>(raw[length - 1]))) --length;
+        if (start == length) {
+            return;
+        }
+        std::string value(raw + start, length - start);
+        ++count;
+
+        integer = integer && isInteger(value);
+        decimal = decimal && isDecimal(value);
+        boolean = boolean && (value == "true" || value == "false");
+        int64_t micros = 0;
+        date = date && Temporal::parseDate(value.data(), value.size(), micros);
+        dateTime = dateTime && Temporal::parseDateTime(value.data(), value.size(), micros);
+        if (decimal) {
+            numbers.add(std::strtod(value.c_str(), nullptr));
+        }
+        lengths.add(static_cast<double>(value.size()));
+
+        addHash(hashValue(value));
+        if (frequenciesComplete) {
+            auto it = frequencies.find(value);
+            if (it != frequencies.end()) {
+                ++it->second;
+            } else if (frequencies.size() < kMaxTrackedValues) {
+                frequencies.emplace(std::move(value), 1);
+            } else {
+                frequenciesComplete = false;
+                frequencies.clear();
+            }
+        }
+    }
+
+    void addHash(uint64_t hash) {
+        if (sketch.size() < kSketchSize) {
+            sketch.insert(hash);
+        } else if (hash < *sketch.rbegin() && sketch.insert(hash).second) {
+            sketch.erase(std::prev(sketch.end()));
+        }
+    }
+
+    void merge(const ValueStats& other) {
+        count += other.count;
+        integer = integer && other.integer;
+        decimal = decimal && other.decimal;
+        boolean = boolean && other.boolean;
+        date = date && other.date;
+        dateTime = dateTime && other.dateTime;
+        if (decimal) {
+            numbers.merge(other.numbers);
+        }
+        lengths.merge(other.lengths);
+        for (uint64_t hash : other.sketch) {
+            addHash(hash);
+        }
+        frequenciesComplete = frequenciesComplete && other.frequenciesComplete;
+        if (frequenciesComplete) {
+            for (const auto& entry : other.frequencies) {
+                frequencies[entry.first] += entry.second;
+            }
+            if (frequencies.size() > kMaxTrackedValues) {
+                frequenciesComplete = false;
+            }
+        }
+        if (!frequenciesComplete) {
+            frequencies.clear();
+        }
+    }
+
+    uint64_t distinct() const {
+        if (sketch.size() < kSketchSize) {
+            return sketch.size();
+        }
+        double fraction = static_cast<double>(*sketch.rbegin()) / 18446744073709551616.0;
+        return static_cast<uint64_t>((kSketchSize - 1) / fraction);
+    }
+
+    XsdType type() const {
+        if (count == 0) return XsdType::STRING;
+        if (integer) return XsdType::INTEGER;
+        if (decimal) return XsdType::DECIMAL;
+        if (boolean) return XsdType::BOOLEAN;
+        if (dateTime) return XsdType::DATETIME;
+        if (date) return XsdType::DATE;
+        return XsdType::STRING;
+    }
+
+    // Zipf exponent of the value frequencies (0 if close to uniform or unknown)
+    double skew() const {
+        if (!frequenciesComplete || frequencies.size() < 3) {
+            return 0.0;
+        }
+        std::vector<uint64_t> counts;
+        for (const auto& entry : frequencies) {
+            counts.push_back(entry.second);
+        }
+        std::sort(counts.rbegin(), counts.rend());
+
+        // Least-squares slope of log(frequency) over log(rank)
+        double n = static_cast<double>(counts.size());
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (size_t r = 0; r < counts.size(); ++r) {
+            double x = std::log(static_cast<double>(r + 1));
+            double y = std::log(static_cast<double>(counts[r]));
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+        double exponent = -slope;
+        return exponent < 0.3 ? 0.0 : std::min(exponent, 4.0);
+    }
+};
+
+// One element or attribute path
+struct PathStats {
+    bool attribute = false;
+    bool complex = false;
+    uint64_t instances = 0;
+    std::vector<std::string> children;      // Child paths in document order
+    std::map<uint64_t, uint64_t> occurrences; // Occurrences per parent -> parents (>= 1)
+    ValueStats values;
+
+    // Insert a child path after the one at `after` unless already listed;
+    // returns its position
+    size_t placeChild(const std::string& path, size_t after) {
+        auto it = std::find(children.begin(), children.end(), path);
+        if (it != children.end()) {
+            return static_cast<size_t>(it - children.begin());
+        }
+        size_t position = std::min(after, children.size());
+        children.insert(children.begin() + position, path);
+        return position;
+    }
+};
+
+class CorpusStats {
+public:
+    void addFile(const pugi::xml_document& doc, uint64_t bytes) {
+        pugi::xml_node root = doc.document_element();
+        if (!root) {
+            return;
+        }
+        ++roots_[root.name()];
+        fileSizes_.add(static_cast<double>(bytes));
+        visit(root, root.name());
+    }
+
+    void merge(const CorpusStats& other) {
+        for (const auto& entry : other.roots_) {
+            roots_[entry.first] += entry.second;
+        }
+        fileSizes_.merge(other.fileSizes_);
+        for (const auto& entry : other.paths_) {
+            PathStats& stats = paths_[entry.first];
+            const PathStats& theirs = entry.second;
+            stats.attribute = theirs.attribute;
+            stats.complex = stats.complex || theirs.complex;
+            stats.instances += theirs.instances;
+            size_t after = 0;
+            for (const auto& child : theirs.children) {
+                after = stats.placeChild(child, after) + 1;
+            }
+            for (const auto& occurrence : theirs.occurrences) {
+                stats.occurrences[occurrence.first] += occurrence.second;
+            }
+            stats.values.merge(theirs.values);
+        }
+    }
+
+    size_t pathCount() const { return paths_.size(); }
+
+    GenerationProfile toProfile() const {
+        GenerationProfile profile;
+        if (roots_.empty()) {
+            return profile;
+        }
+        if (fileSizes_.n > 1 && fileSizes_.max > fileSizes_.min) {
+            double count = static_cast<double>(fileSizes_.n);
+            double meanLog = fileSizes_.sumLog / count;
+            double sdLog = std::sqrt(std::max(0.0, fileSizes_.sumLogSq / count - meanLog * meanLog));
+            profile.setFileSize(Distribution::lognormal(std::exp(meanLog), sdLog));
+        } else if (fileSizes_.n > 0) {
+            profile.setFileSize(Distribution::constant(fileSizes_.max));
+        }
+
+        // Documents with another root element are not described
+        auto root = std::max_element(roots_.begin(), roots_.end(),
+                                     [](const auto& a, const auto& b) { return a.second < b.second; });
+        emit(profile, root->first, nullptr);
+        return profile;
+    }
+
+private:
+    void visit(const pugi::xml_node& node, const std::string& path) {
+        PathStats& stats = paths_[path];
+        ++stats.instances;
+
+        size_t after = 0;
+        for (const auto& attr : node.attributes()) {
+            std::string attrPath = path + ".@" + attr.name();
+            after = stats.placeChild(attrPath, after) + 1;
+            PathStats& attrStats = paths_[attrPath];
+            attrStats.attribute = true;
+            ++attrStats.instances;
+            ++attrStats.occurrences[1];
+            attrStats.values.add(attr.value());
+        }
+
+        // Occurrences of each child name under this instance, in order
+        std::vector<std::pair<std::string, uint64_t>> counts;
+        for (const auto& child : node.children()) {
+            if (child.type() != pugi::node_element) {
+                continue;
+            }
+            std::string childPath = path + "." + child.name();
+            after = stats.placeChild(childPath, after) + 1;
+            auto it = std::find_if(counts.begin(), counts.end(),
+                                   [&](const auto& entry) { return entry.first == childPath; });
+            if (it == counts.end()) {
+                counts.emplace_back(childPath, 1);
+            } else {
+                ++it->second;
+            }
+            visit(child, childPath);
+        }
+
+        if (counts.empty()) {
+            stats.values.add(node.text().get());
+        } else {
+            stats.complex = true;
+            for (const auto& entry : counts) {
+                ++paths_[entry.first].occurrences[entry.second];
+            }
+        }
+    }
+
+    void emit(GenerationProfile& profile, const std::string& path, const PathStats* parent) const {
+        const PathStats& stats = paths_.at(path);
+        PathProfile rule;
+        rule.path = path;
+        rule.hasType = true;
+        rule.type = stats.complex ? XsdType::COMPLEX : stats.values.type();
+
+        if (parent) {
+            uint64_t present = 0;
+            uint64_t maxCount = 0;
+            uint64_t minCount = std::numeric_limits<uint64_t>::max();
+            Moments repeats;
+            for (const auto& occurrence : stats.occurrences) {
+                present += occurrence.second;
+                maxCount = std::max(maxCount, occurrence.first);
+                minCount = std::min(minCount, occurrence.first);
+                repeats.add(static_cast<double>(occurrence.first), occurrence.second);
+            }
+            uint64_t absent = parent->instances > present ? parent->instances - present : 0;
+            if (absent > 0) {
+                rule.nullRate = static_cast<double>(absent) / static_cast<double>(parent->instances);
+            }
+            if (!stats.attribute) {
+                rule.hasOccurs = true;
+                rule.minOccurs = absent > 0 ? 0 : static_cast<int>(std::min<uint64_t>(minCount, 1000));
+                rule.maxOccurs = maxCount > 1 ? -1 : 1;
+                if (maxCount > 1) {
+                    rule.repeat = repeats.fit();
+                }
+            }
+        }
+
+        if (!stats.complex) {
+            const ValueStats& values = stats.values;
+            if (rule.type == XsdType::INTEGER || rule.type == XsdType::DECIMAL) {
+                rule.value = values.numbers.fit();
+            } else if (rule.type == XsdType::STRING) {
+                rule.length = values.lengths.fit();
+            }
+            uint64_t distinct = values.distinct();
+            if (rule.type != XsdType::BOOLEAN && distinct > 0 && distinct * 2 <= values.count) {
+                rule.cardinality = distinct;
+                rule.skew = values.skew();
+            }
+        }
+        profile.addRule(rule);
+
+        for (const auto& child : stats.children) {
+            emit(profile, child, &stats);
+        }
+    }
+
+    std::unordered_map<std::string, PathStats> paths_;
+    std::map<std::string, uint64_t> roots_;
+    Moments fileSizes_;
+};
+
+} // anonymous namespace
+
+GenerationProfile CorpusProfiler::profile(
+    const std::vector<std::string>& files,
+    CorpusSummary* summary,
+    size_t threadCount
+) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) {
+            threadCount = 4;
+        }
+    }
+    threadCount = std::max<size_t>(1, std::min(threadCount, files.size()));
+
+    // Each worker profiles its own files; the statistics are merged at the end
+    std::vector<CorpusStats> partial(threadCount);
+    std::atomic<size_t> nextIndex{0};
+    std::atomic<size_t> profiled{0};
+    std::atomic<size_t> skipped{0};
+    std::atomic<uint64_t> bytes{0};
+
+    auto worker = [&](CorpusStats& stats) {
+        while (true) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= files.size()) {
+                break;
+            }
+            try {
+                auto doc = XmlLoader::load(files[index]);
+                uint64_t size = std::filesystem::file_size(files[index]);
+                stats.addFile(*doc, size);
+                bytes += size;
+                ++profiled;
+            } catch (const std::exception&) {
+                ++skipped;
+            }
+        }
+    };
+
+    if (threadCount == 1) {
+        worker(partial[0]);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (size_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back(worker, std::ref(partial[t]));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    CorpusStats& merged = partial[0];
+    for (size_t t = 1; t < partial.size(); ++t) {
+        merged.merge(partial[t]);
+    }
+
+    if (summary) {
+        summary->files = profiled;
+        summary->skipped = skipped;
+        summary->bytes = bytes;
+        summary->paths = merged.pathCount();
+    }
+    return merged.toProfile();
+}
+
+} // namespace expocli
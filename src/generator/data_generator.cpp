@@ -1,4 +1,6 @@
 #include "generator/data_generator.h"
+#include <algorithm>
+#include <cstdio>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
@@ -16,10 +18,55 @@ const std::vector<std::string> DataGenerator::sample_names_ = {
     "Premium", "Standard", "Basic", "Pro", "Plus", "Ultra", "Max", "Lite"
 };
 
+// 2025-01-01T00:00:00Z: reference date of seeded generators
+constexpr std::time_t kSeededReferenceTime = 1735689600;
+
 DataGenerator::DataGenerator()
     : rng_(std::random_device{}()),
-      char_dist_(97, 122)  // lowercase a-z
+      char_dist_(97, 122),  // lowercase a-z
+      reference_time_(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()))
+{
+}
+
+DataGenerator::DataGenerator(uint64_t seed)
+    : char_dist_(97, 122),
+      reference_time_(kSeededReferenceTime),
+      utc_(true)
 {
+    reseed(seed);
+}
+
+void DataGenerator::reseed(uint64_t seed) {
+    // Both halves of the seed feed the engine, so distinct 64-bit document
+    // seeds give distinct streams
+    std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    rng_.seed(sequence);
+    char_dist_.reset();
+}
+
+int DataGenerator::randomInt(int min, int max) {
+    std::uniform_int_distribution<int> dist(min, max);
+    return dist(rng_);
+}
+
+std::tm DataGenerator::calendarTime(int daysAgo) const {
+    std::time_t past = reference_time_ - static_cast<std::time_t>(daysAgo) * 24 * 3600;
+
+    std::tm tm;
+    #ifdef _WIN32
+        if (utc_) {
+            gmtime_s(&tm, &past);
+        } else {
+            localtime_s(&tm, &past);
+        }
+    #else
+        if (utc_) {
+            gmtime_r(&past, &tm);
+        } else {
+            localtime_r(&past, &tm);
+        }
+    #endif
+    return tm;
 }
 
 std::string DataGenerator::generateValue(XsdType type) {
@@ -41,6 +88,31 @@ std::string DataGenerator::generateValue(XsdType type) {
     }
 }
 
+std::string DataGenerator::generateValue(XsdType type, const PathProfile& profile) {
+    switch (type) {
+        case XsdType::INTEGER:
+            if (!profile.value.empty()) {
+                return std::to_string(profile.value.sampleInteger(rng_));
+            }
+            break;
+        case XsdType::DECIMAL:
+            if (!profile.value.empty()) {
+                char text[32];
+                int length = std::snprintf(text, sizeof(text), "%.2f", profile.value.sample(rng_));
+                return std::string(text, length > 0 ? static_cast<size_t>(length) : 0);
+            }
+            break;
+        case XsdType::STRING:
+            if (!profile.length.empty()) {
+                return generateWord(static_cast<int>(std::max<int64_t>(1, profile.length.sampleInteger(rng_))));
+            }
+            break;
+        default:
+            break;
+    }
+    return generateValue(type);
+}
+
 std::string DataGenerator::generateString(int minLength, int maxLength) {
     // Mix of using sample data and random strings
     std::uniform_int_distribution<int> choice_dist(0, 2);
@@ -57,22 +129,24 @@ std::string DataGenerator::generateString(int minLength, int maxLength) {
     } else {
         // Generate random string
         std::uniform_int_distribution<int> len_dist(minLength, maxLength);
-        int length = len_dist(rng_);
-
-        std::string result;
-        result.reserve(length);
+        return generateWord(len_dist(rng_));
+    }
+}
 
-        for (int i = 0; i < length; ++i) {
-            result += static_cast<char>(char_dist_(rng_));
-        }
+std::string DataGenerator::generateWord(int length) {
+    std::string result;
+    result.reserve(length > 0 ? length : 0);
 
-        // Capitalize first letter
-        if (!result.empty()) {
-            result[0] = static_cast<char>(std::toupper(result[0]));
-        }
+    for (int i = 0; i < length; ++i) {
+        result += static_cast<char>(char_dist_(rng_));
+    }
 
-        return result;
+    // Capitalize first letter
+    if (!result.empty()) {
+        result[0] = static_cast<char>(std::toupper(result[0]));
     }
+
+    return result;
 }
 
 std::string DataGenerator::generateInteger(int min, int max) {
@@ -82,9 +156,9 @@ std::string DataGenerator::generateInteger(int min, int max) {
 
 std::string DataGenerator::generateDecimal(double min, double max) {
     std::uniform_real_distribution<double> dist(min, max);
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2) << dist(rng_);
-    return oss.str();
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.2f", dist(rng_));
+    return std::string(text, length > 0 ? static_cast<size_t>(length) : 0);
 }
 
 std::string DataGenerator::generateBoolean() {
@@ -94,20 +168,8 @@ std::string DataGenerator::generateBoolean() {
 
 std::string DataGenerator::generateDate() {
     // Generate a random date in the past 5 years
-    auto now = std::chrono::system_clock::now();
-
     std::uniform_int_distribution<int> days_dist(0, 365 * 5);
-    int days_ago = days_dist(rng_);
-
-    auto past = now - std::chrono::hours(24 * days_ago);
-    auto past_time_t = std::chrono::system_clock::to_time_t(past);
-
-    std::tm tm;
-    #ifdef _WIN32
-        localtime_s(&tm, &past_time_t);
-    #else
-        localtime_r(&past_time_t, &tm);
-    #endif
+    std::tm tm = calendarTime(days_dist(rng_));
 
     std::ostringstream oss;
     oss << std::setfill('0')
@@ -120,20 +182,8 @@ std::string DataGenerator::generateDate() {
 
 std::string DataGenerator::generateDateTime() {
     // Similar to date but with time component
-    auto now = std::chrono::system_clock::now();
-
     std::uniform_int_distribution<int> days_dist(0, 365 * 5);
-    int days_ago = days_dist(rng_);
-
-    auto past = now - std::chrono::hours(24 * days_ago);
-    auto past_time_t = std::chrono::system_clock::to_time_t(past);
-
-    std::tm tm;
-    #ifdef _WIN32
-        localtime_s(&tm, &past_time_t);
-    #else
-        localtime_r(&past_time_t, &tm);
-    #endif
+    std::tm tm = calendarTime(days_dist(rng_));
 
     std::ostringstream oss;
     oss << std::setfill('0')
@@ -0,0 +1,529 @@
+#include "generator/generation_profile.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace expocli {
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(start, end - start + 1);
+}
+
+std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+}
+
+// Number with an optional size unit (B, KB, MB, GB, TB; powers of 1024)
+double parseNumber(const std::string& text) {
+    std::string value = trim(text);
+    char* end = nullptr;
+    double number = std::strtod(value.c_str(), &end);
+    if (end == value.c_str()) {
+        throw std::runtime_error("expected a number, got '" + value + "'");
+    }
+
+    std::string unit = lower(trim(end));
+    static const char* units[] = {"b", "kb", "mb", "gb", "tb"};
+    double multiplier = 1.0;
+    for (const char* name : units) {
+        if (unit == name) {
+            return number * multiplier;
+        }
+        multiplier *= 1024.0;
+    }
+    if (!unit.empty()) {
+        throw std::runtime_error("unknown unit in '" + value + "'");
+    }
+    return number;
+}
+
+std::string formatNumber(double value) {
+    std::ostringstream oss;
+    oss.precision(10);
+    oss << value;
+    return oss.str();
+}
+
+// log1p(x) / x and expm1(x) / x, accurate near 0
+double helper1(double x) {
+    return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+double helper2(double x) {
+    return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+
+const char* typeName(XsdType type) {
+    switch (type) {
+        case XsdType::INTEGER: return "integer";
+        case XsdType::DECIMAL: return "decimal";
+        case XsdType::BOOLEAN: return "boolean";
+        case XsdType::DATE: return "date";
+        case XsdType::DATETIME: return "datetime";
+        case XsdType::COMPLEX: return "complex";
+        case XsdType::STRING: break;
+    }
+    return "string";
+}
+
+XsdType parseType(const std::string& name) {
+    static const XsdType types[] = {XsdType::STRING, XsdType::INTEGER, XsdType::DECIMAL,
+                                    XsdType::BOOLEAN, XsdType::DATE, XsdType::DATETIME,
+                                    XsdType::COMPLEX};
+    for (XsdType type : types) {
+        if (lower(name) == typeName(type)) {
+            return type;
+        }
+    }
+    throw std::runtime_error("unknown type '" + name + "'");
+}
+
+std::vector<std::string> splitPath(const std::string& path) {
+    std::vector<std::string> components;
+    std::string current;
+    for (char c : path) {
+        if (c == '.' || c == '/') {
+            if (!current.empty()) {
+                components.push_back(current);
+            }
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) {
+        components.push_back(current);
+    }
+    return components;
+}
+
+} // anonymous namespace
+
+Distribution Distribution::constant(double value) {
+    Distribution d;
+    d.kind_ = Kind::CONSTANT;
+    d.a_ = value;
+    return d;
+}
+
+Distribution Distribution::uniform(double min, double max) {
+    Distribution d;
+    d.kind_ = Kind::UNIFORM;
+    d.a_ = std::min(min, max);
+    d.b_ = std::max(min, max);
+    return d;
+}
+
+Distribution Distribution::normal(double mean, double stddev) {
+    Distribution d;
+    d.kind_ = Kind::NORMAL;
+    d.a_ = mean;
+    d.b_ = std::abs(stddev);
+    return d;
+}
+
+Distribution Distribution::lognormal(double median, double sigma) {
+    Distribution d;
+    d.kind_ = Kind::LOGNORMAL;
+    d.a_ = median;
+    d.b_ = std::abs(sigma);
+    return d;
+}
+
+Distribution Distribution::zipf(uint64_t n, double exponent) {
+    if (n == 0 || !(exponent > 0.0)) {
+        throw std::runtime_error("zipf needs n >= 1 and an exponent > 0");
+    }
+    Distribution d;
+    d.kind_ = Kind::ZIPF;
+    d.a_ = static_cast<double>(n);
+    d.b_ = exponent;
+    d.h_integral_x1_ = d.zipfHIntegral(1.5) - 1.0;
+    d.h_integral_n_ = d.zipfHIntegral(d.a_ + 0.5);
+    d.s_ = 2.0 - d.zipfHIntegralInverse(d.zipfHIntegral(2.5) - d.zipfH(2.0));
+    return d;
+}
+
+Distribution Distribution::parse(const std::string& input) {
+    std::string text = trim(input);
+    size_t open = text.find('(');
+    if (open == std::string::npos) {
+        return constant(parseNumber(text));
+    }
+    if (text.back() != ')') {
+        throw std::runtime_error("missing ')' in '" + text + "'");
+    }
+
+    std::string name = lower(trim(text.substr(0, open)));
+    std::vector<double> args;
+    std::stringstream list(text.substr(open + 1, text.size() - open - 2));
+    std::string arg;
+    while (std::getline(list, arg, ',')) {
+        args.push_back(parseNumber(arg));
+    }
+    if (args.size() != 2) {
+        throw std::runtime_error(name + "() takes two arguments");
+    }
+
+    Distribution d;
+    if (name == "uniform") {
+        return uniform(args[0], args[1]);
+    } else if (name == "normal") {
+        d.kind_ = Kind::NORMAL;
+    } else if (name == "zipf") {
+        if (args[0] < 1.0) {
+            throw std::runtime_error("zipf needs n >= 1");
+        }
+        return zipf(static_cast<uint64_t>(args[0]), args[1]);
+    } else if (name == "lognormal") {
+        if (!(args[0] > 0.0)) {
+            throw std::runtime_error("lognormal needs a median > 0");
+        }
+        d.kind_ = Kind::LOGNORMAL;
+    } else if (name == "pareto") {
+        if (!(args[0] > 0.0) || !(args[1] > 0.0)) {
+            throw std::runtime_error("pareto needs min > 0 and alpha > 0");
+        }
+        d.kind_ = Kind::PARETO;
+    } else {
+        throw std::runtime_error("unknown distribution '" + name + "'");
+    }
+    if (args[1] < 0.0) {
+        throw std::runtime_error(name + "() spread must not be negative");
+    }
+    d.a_ = args[0];
+    d.b_ = args[1];
+    return d;
+}
+
+double Distribution::sample(std::mt19937& rng) const {
+    switch (kind_) {
+        case Kind::CONSTANT:
+            return a_;
+        case Kind::UNIFORM:
+            return std::uniform_real_distribution<double>(a_, b_)(rng);
+        case Kind::NORMAL:
+            return std::normal_distribution<double>(a_, b_)(rng);
+        case Kind::LOGNORMAL:
+            return a_ * std::exp(std::normal_distribution<double>(0.0, b_)(rng));
+        case Kind::PARETO: {
+            double u = 1.0 - std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+            return a_ / std::pow(u, 1.0 / b_);
+        }
+        case Kind::ZIPF: {
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            while (true) {
+                double u = h_integral_n_ + unit(rng) * (h_integral_x1_ - h_integral_n_);
+                double x = zipfHIntegralInverse(u);
+                double k = std::floor(x + 0.5);
+                k = std::min(std::max(k, 1.0), a_);
+                if (k - x <= s_ || u >= zipfHIntegral(k + 0.5) - zipfH(k)) {
+                    return k;
+                }
+            }
+        }
+        case Kind::NONE:
+            break;
+    }
+    return 0.0;
+}
+
+int64_t Distribution::sampleInteger(std::mt19937& rng) const {
+    if (kind_ == Kind::UNIFORM) {
+        auto low = static_cast<int64_t>(std::ceil(a_));
+        auto high = static_cast<int64_t>(std::floor(b_));
+        if (low >= high) {
+            return low;
+        }
+        return std::uniform_int_distribution<int64_t>(low, high)(rng);
+    }
+    return static_cast<int64_t>(std::llround(sample(rng)));
+}
+
+std::string Distribution::toString() const {
+    switch (kind_) {
+        case Kind::CONSTANT: return formatNumber(a_);
+        case Kind::UNIFORM: return "uniform(" + formatNumber(a_) + ", " + formatNumber(b_) + ")";
+        case Kind::NORMAL: return "normal(" + formatNumber(a_) + ", " + formatNumber(b_) + ")";
+        case Kind::ZIPF: return "zipf(" + formatNumber(a_) + ", " + formatNumber(b_) + ")";
+        case Kind::LOGNORMAL: return "lognormal(" + formatNumber(a_) + ", " + formatNumber(b_) + ")";
+        case Kind::PARETO: return "pareto(" + formatNumber(a_) + ", " + formatNumber(b_) + ")";
+        case Kind::NONE: break;
+    }
+    return "";
+}
+
+double Distribution::zipfH(double x) const {
+    return std::exp(-b_ * std::log(x));
+}
+
+double Distribution::zipfHIntegral(double x) const {
+    double logX = std::log(x);
+    return helper2((1.0 - b_) * logX) * logX;
+}
+
+double Distribution::zipfHIntegralInverse(double x) const {
+    double t = x * (1.0 - b_);
+    if (t < -1.0) {
+        t = -1.0;  // Rounding guard: the exact value is always >= -1
+    }
+    return std::exp(helper1(t) * x);
+}
+
+GenerationProfile GenerationProfile::load(const std::string& file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open profile: " + file);
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    return parse(text.str(), file);
+}
+
+GenerationProfile GenerationProfile::parse(const std::string& text, const std::string& source) {
+    GenerationProfile profile;
+    std::istringstream in(text);
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        // Spaces inside parentheses belong to the distribution
+        std::vector<std::string> words;
+        std::string current;
+        int depth = 0;
+        for (char c : line) {
+            depth += (c == '(') - (c == ')');
+            if (std::isspace(static_cast<unsigned char>(c)) && depth == 0) {
+                if (!current.empty()) {
+                    words.push_back(current);
+                }
+                current.clear();
+            } else if (!std::isspace(static_cast<unsigned char>(c))) {
+                current += c;
+            }
+        }
+        if (!current.empty()) {
+            words.push_back(current);
+        }
+        if (words.empty()) {
+            continue;
+        }
+
+        try {
+            if (words[0] == "FILE_SIZE") {
+                if (words.size() != 2) {
+                    throw std::runtime_error("FILE_SIZE takes one distribution");
+                }
+                profile.file_size_ = Distribution::parse(words[1]);
+                continue;
+            }
+
+            PathProfile rule;
+            rule.path = words[0];
+            if (splitPath(rule.path).empty()) {
+                throw std::runtime_error("missing path");
+            }
+            for (size_t i = 1; i < words.size(); ++i) {
+                size_t equals = words[i].find('=');
+                if (equals == std::string::npos) {
+                    throw std::runtime_error("expected key=value, got '" + words[i] + "'");
+                }
+                std::string key = lower(words[i].substr(0, equals));
+                std::string value = words[i].substr(equals + 1);
+
+                if (key == "type") {
+                    rule.type = parseType(value);
+                    rule.hasType = true;
+                } else if (key == "occurs") {
+                    size_t dots = value.find("..");
+                    if (dots == std::string::npos) {
+                        throw std::runtime_error("occurs takes <min>..<max|*>");
+                    }
+                    std::string maxText = value.substr(dots + 2);
+                    rule.minOccurs = static_cast<int>(parseNumber(value.substr(0, dots)));
+                    rule.maxOccurs = maxText == "*" ? -1 : static_cast<int>(parseNumber(maxText));
+                    if (rule.minOccurs < 0 || (rule.maxOccurs != -1 && rule.maxOccurs < std::max(rule.minOccurs, 1))) {
+                        throw std::runtime_error("invalid occurs range '" + value + "'");
+                    }
+                    rule.hasOccurs = true;
+                } else if (key == "value") {
+                    rule.value = Distribution::parse(value);
+                } else if (key == "length") {
+                    rule.length = Distribution::parse(value);
+                } else if (key == "repeat") {
+                    rule.repeat = Distribution::parse(value);
+                } else if (key == "cardinality") {
+                    double cardinality = parseNumber(value);
+                    if (cardinality < 1.0) {
+                        throw std::runtime_error("cardinality must be at least 1");
+                    }
+                    rule.cardinality = static_cast<uint64_t>(cardinality);
+                } else if (key == "skew") {
+                    rule.skew = parseNumber(value);
+                    if (rule.skew < 0.0) {
+                        throw std::runtime_error("skew must not be negative");
+                    }
+                } else if (key == "null") {
+                    rule.nullRate = parseNumber(value);
+                    if (rule.nullRate < 0.0 || rule.nullRate > 1.0) {
+                        throw std::runtime_error("null rate must be between 0 and 1");
+                    }
+                } else {
+                    throw std::runtime_error("unknown setting '" + key + "'");
+                }
+            }
+            profile.addRule(std::move(rule));
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error(source + ":" + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+    return profile;
+}
+
+std::string GenerationProfile::toString() const {
+    std::ostringstream out;
+    if (!file_size_.empty()) {
+        out << "FILE_SIZE " << file_size_.toString() << "\n";
+    }
+    for (const auto& rule : rules_) {
+        out << rule.path;
+        if (rule.hasType) out << " type=" << typeName(rule.type);
+        if (rule.hasOccurs) {
+            out << " occurs=" << rule.minOccurs << ".."
+                << (rule.maxOccurs < 0 ? std::string("*") : std::to_string(rule.maxOccurs));
+        }
+        if (!rule.repeat.empty()) out << " repeat=" << rule.repeat.toString();
+        if (rule.cardinality > 0) out << " cardinality=" << rule.cardinality;
+        if (rule.skew > 0.0) out << " skew=" << formatNumber(rule.skew);
+        if (rule.nullRate >= 0.0) out << " null=" << formatNumber(rule.nullRate);
+        if (!rule.value.empty()) out << " value=" << rule.value.toString();
+        if (!rule.length.empty()) out << " length=" << rule.length.toString();
+        out << "\n";
+    }
+    return out.str();
+}
+
+void GenerationProfile::save(const std::string& file) const {
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out << toString();
+    if (!out) {
+        throw std::runtime_error("Cannot write profile: " + file);
+    }
+}
+
+void GenerationProfile::addRule(PathProfile rule) {
+    if (rule.cardinality > 0) {
+        rule.pick = rule.skew > 0.0
+            ? Distribution::zipf(rule.cardinality, rule.skew)
+            : Distribution::uniform(1.0, static_cast<double>(rule.cardinality));
+    }
+    components_.push_back(splitPath(rule.path));
+    rules_.push_back(std::move(rule));
+}
+
+bool GenerationProfile::hasStructure() const {
+    for (const auto& rule : rules_) {
+        if (rule.hasType) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<XsdSchema> GenerationProfile::toSchema() const {
+    auto schema = std::make_shared<XsdSchema>();
+    std::vector<std::pair<std::vector<std::string>, std::shared_ptr<XsdElement>>> declared;
+
+    for (size_t r = 0; r < rules_.size(); ++r) {
+        const PathProfile& rule = rules_[r];
+        if (!rule.hasType) {
+            continue;
+        }
+        const auto& components = components_[r];
+        if (rule.path[0] == '.') {
+            throw std::runtime_error("Structure path '" + rule.path + "' must be absolute");
+        }
+
+        auto element = std::make_shared<XsdElement>();
+        element->type = rule.type;
+        element->isAttribute = components.back()[0] == '@';
+        element->name = element->isAttribute ? components.back().substr(1) : components.back();
+        if (rule.hasOccurs) {
+            element->minOccurs = rule.minOccurs;
+            element->maxOccurs = rule.maxOccurs;
+        }
+
+        if (components.size() == 1) {
+            if (schema->getRootElement()) {
+                throw std::runtime_error("Profile declares two root elements: " +
+                                         schema->getRootElement()->name + " and " + rule.path);
+            }
+            schema->setRootElement(element);
+        } else {
+            std::vector<std::string> parentPath(components.begin(), components.end() - 1);
+            auto parent = std::find_if(declared.begin(), declared.end(),
+                                       [&](const auto& entry) { return entry.first == parentPath; });
+            if (parent == declared.end() || parent->second->isAttribute) {
+                throw std::runtime_error("Profile path '" + rule.path + "' has no declared parent element");
+            }
+            if (element->isAttribute) {
+                // A text leaf keeps its type: simple content with attributes
+                parent->second->attributes.push_back(element);
+            } else {
+                parent->second->type = XsdType::COMPLEX;
+                parent->second->children.push_back(element);
+            }
+        }
+        declared.emplace_back(components, element);
+    }
+
+    if (!schema->getRootElement()) {
+        throw std::runtime_error("Profile declares no root element");
+    }
+    return schema;
+}
+
+const PathProfile* GenerationProfile::find(const std::vector<std::string>& path) const {
+    const PathProfile* best = nullptr;
+    size_t bestScore = 0;
+
+    for (size_t r = 0; r < rules_.size(); ++r) {
+        const auto& components = components_[r];
+        bool anywhere = rules_[r].path[0] == '.';
+        if (components.size() > path.size() || (!anywhere && components.size() != path.size())) {
+            continue;
+        }
+        size_t offset = path.size() - components.size();
+        if (!std::equal(components.begin(), components.end(), path.begin() + offset)) {
+            continue;
+        }
+
+        // Absolute paths beat any suffix; longer suffixes beat shorter ones
+        size_t score = anywhere ? components.size() : path.size() + 1;
+        if (score > bestScore) {
+            best = &rules_[r];
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+} // namespace expocli
@@ -1,134 +1,508 @@
 #include "generator/xml_generator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
-#include <sstream>
-#include <filesystem>
+#include <limits>
+#include <mutex>
 #include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 
 namespace expocli {
 
+namespace {
+
+// Output is handed to fwrite in blocks of this size
+constexpr size_t kFlushThreshold = 1 << 20;
+
+// Distinct values cached per path; others are regenerated on each use
+constexpr uint64_t kMaxPooledValues = 1 << 16;
+
+// Seed of document `index`: independent streams that only depend on the run seed
+uint64_t documentSeed(uint64_t seed, uint64_t index) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (index + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Elements from the root down to the shallowest complex element with an
+// unbounded child: the lists that grow when a size target is set. Empty if
+// the schema has no unbounded element.
+std::vector<const XsdElement*> findGrowthPath(const XsdSchema& schema) {
+    auto root = schema.getRootElement();
+    if (!root) {
+        return {};
+    }
+
+    std::vector<std::vector<const XsdElement*>> queue{{root.get()}};
+    std::set<const XsdElement*> visited{root.get()};
+    for (size_t i = 0; i < queue.size(); ++i) {
+        std::vector<const XsdElement*> path = queue[i];
+        const XsdElement* element = path.back();
+        for (const auto& child : element->children) {
+            if (child->isUnbounded()) {
+                return path;
+            }
+        }
+        for (const auto& child : element->children) {
+            if (child->type == XsdType::COMPLEX && visited.insert(child.get()).second) {
+                path.push_back(child.get());
+                queue.push_back(path);
+                path.pop_back();
+            }
+        }
+    }
+    return {};
+}
+
+std::string formatSize(uint64_t bytes) {
+    static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        ++unit;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return oss.str();
+}
+
+} // anonymous namespace
+
 XmlGenerator::XmlGenerator() {
 }
 
+XmlGenerator::XmlGenerator(uint64_t seed)
+    : data_gen_(seed) {
+}
+
+GenerationSummary XmlGenerator::generateFiles(
+    const XsdSchema& schema,
+    const std::string& destDir,
+    const GenerationOptions& options
+) {
+    if (!schema.getRootElement()) {
+        throw std::runtime_error("Schema has no root element defined");
+    }
+
+    const int count = options.count;
+    GenerationSummary summary;
+    if (count <= 0) {
+        return summary;
+    }
+    summary.threads = options.threads;
+    if (summary.threads == 0) {
+        summary.threads = std::thread::hardware_concurrency();
+        if (summary.threads == 0) {
+            summary.threads = 4;
+        }
+    }
+    summary.threads = std::max<size_t>(1, std::min<size_t>(summary.threads, count));
+
+    // Per-file size: drawn from the profile's FILE_SIZE distribution, or an
+    // equal share of the target
+    const GenerationProfile* profile = options.profile.get();
+    bool sizedByProfile = profile && !profile->fileSize().empty();
+    uint64_t budget = 0;
+    if (options.targetBytes > 0 && !sizedByProfile) {
+        budget = std::max<uint64_t>(1, options.targetBytes / count);
+    }
+    if ((budget > 0 || sizedByProfile) && findGrowthPath(schema).empty()) {
+        std::cout << "Note: schema has no unbounded element, files keep their natural size" << std::endl;
+    }
+    if (options.targetBytes > 0 && sizedByProfile) {
+        std::cout << "Note: file sizes follow the profile's FILE_SIZE, TARGET SIZE is ignored" << std::endl;
+    }
+
+    // Distinct values must be the same in every thread
+    uint64_t poolSeed = options.seed ? *options.seed
+                                     : (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+
+    std::cout << "Generating " << count << " XML files";
+    if (summary.threads > 1) {
+        std::cout << " on " << summary.threads << " threads";
+    }
+    std::cout << "..." << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int> nextIndex{0};
+    std::atomic<int> written{0};
+    std::atomic<uint64_t> totalBytes{0};
+    int completed = 0;
+    std::mutex outputMutex;
+
+    auto worker = [&]() {
+        // Seeded runs give every document its own stream; unseeded runs keep
+        // one random stream per thread
+        XmlGenerator generator = options.seed ? XmlGenerator(*options.seed) : XmlGenerator();
+        generator.setProfile(profile, poolSeed);
+
+        while (true) {
+            int i = nextIndex.fetch_add(1);
+            if (i >= count) {
+                break;
+            }
+            if (options.seed) {
+                generator.reseed(documentSeed(*options.seed, static_cast<uint64_t>(i)));
+            }
+            uint64_t fileBudget = budget;
+            if (sizedByProfile) {
+                double size = profile->fileSize().sample(generator.data_gen_.engine());
+                fileBudget = size < 1.0 ? 1 : static_cast<uint64_t>(size);
+            }
+
+            // Create filename with zero-padded number
+            std::ostringstream filename;
+            filename << destDir << "/"
+                     << options.prefix
+                     << std::setfill('0') << std::setw(4) << (i + 1)
+                     << ".xml";
+
+            bool saved = false;
+            std::FILE* file = std::fopen(filename.str().c_str(), "wb");
+            if (file) {
+                try {
+                    totalBytes += generator.writeDocument(schema, file, fileBudget);
+                    saved = true;
+                } catch (const std::exception&) {
+                    saved = false;
+                }
+                saved = std::fclose(file) == 0 && saved;
+            }
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            if (!saved) {
+                std::cerr << "Error: Failed to save file " << filename.str() << std::endl;
+            } else {
+                ++written;
+            }
+
+            // Progress indicator (every 10%)
+            ++completed;
+            if (count >= 10 && completed % (count / 10) == 0) {
+                int percent = static_cast<int>((static_cast<int64_t>(completed) * 100) / count);
+                std::cout << "Progress: " << percent << "% (" << completed << "/" << count << ")" << std::endl;
+            }
+        }
+    };
+
+    if (summary.threads == 1) {
+        worker();
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(summary.threads);
+        for (size_t t = 0; t < summary.threads; ++t) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    summary.files = written;
+    summary.bytes = totalBytes;
+    summary.elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream details;
+    details << formatSize(summary.bytes) << ", " << std::fixed << std::setprecision(0)
+            << summary.elapsedMs << " ms";
+    std::cout << "Successfully generated " << summary.files << " XML files in " << destDir
+              << " (" << details.str() << ")" << std::endl;
+    return summary;
+}
+
 void XmlGenerator::generateFiles(
     const XsdSchema& schema,
     int count,
     const std::string& destDir,
     const std::string& prefix
 ) {
-    std::cout << "Generating " << count << " XML files..." << std::endl;
+    GenerationOptions options;
+    options.count = count;
+    options.prefix = prefix;
+    generateFiles(schema, destDir, options);
+}
 
-    for (int i = 0; i < count; ++i) {
-        // Generate document
-        pugi::xml_document doc = generateDocument(schema);
-
-        // Create filename with zero-padded number
-        std::ostringstream filename;
-        filename << destDir << "/"
-                 << prefix
-                 << std::setfill('0') << std::setw(4) << (i + 1)
-                 << ".xml";
-
-        // Save document
-        if (!doc.save_file(filename.str().c_str())) {
-            std::cerr << "Error: Failed to save file " << filename.str() << std::endl;
-            continue;
+uint64_t XmlGenerator::writeDocument(const XsdSchema& schema, std::FILE* out, uint64_t sizeBudget) {
+    if (growth_schema_ != &schema || !root_node_) {
+        growth_path_ = findGrowthPath(schema);
+        growth_schema_ = &schema;
+        root_node_.reset();
+        if (schema.getRootElement()) {
+            root_node_ = makeNode(*schema.getRootElement(), nullptr);
         }
+    }
 
-        // Progress indicator (every 10%)
-        if (count >= 10 && (i + 1) % (count / 10) == 0) {
-            int percent = ((i + 1) * 100) / count;
-            std::cout << "Progress: " << percent << "% (" << (i + 1) << "/" << count << ")" << std::endl;
-        }
+    out_ = out;
+    buffer_.clear();
+    written_ = 0;
+    budget_ = sizeBudget;
+    grown_ = false;
+
+    // Same layout as pugixml's default output
+    static const char declaration[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    append(declaration, sizeof(declaration) - 1);
+
+    // Generate root element
+    if (root_node_) {
+        writeElement(*root_node_, 0);
     }
 
-    std::cout << "Successfully generated " << count << " XML files in " << destDir << std::endl;
+    flush();
+    return written_;
 }
 
-pugi::xml_document XmlGenerator::generateDocument(const XsdSchema& schema) {
-    pugi::xml_document doc;
+void XmlGenerator::setProfile(const GenerationProfile* profile, uint64_t poolSeed) {
+    profile_ = profile;
+    pool_seed_ = poolSeed;
+    root_node_.reset();
+}
 
-    // Add XML declaration
-    auto decl = doc.prepend_child(pugi::node_declaration);
-    decl.append_attribute("version") = "1.0";
-    decl.append_attribute("encoding") = "UTF-8";
+std::unique_ptr<XmlGenerator::PathNode> XmlGenerator::makeNode(
+    const XsdElement& element,
+    const PathNode* parent
+) {
+    auto node = std::make_unique<PathNode>();
+    node->element = &element;
+    node->parent = parent;
 
-    // Generate root element
-    auto root = schema.getRootElement();
-    if (root) {
-        auto rootNode = doc.append_child(root->name.c_str());
+    // FNV-1a over the path, so distinct values differ between paths
+    std::string name = element.isAttribute ? "@" + element.name : element.name;
+    uint64_t hash = parent ? parent->pathHash : 14695981039346656037ull;
+    for (char c : "/" + name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    node->pathHash = hash;
 
-        // Generate attributes first
-        for (const auto& attr : root->attributes) {
-            std::string value = data_gen_.generateValue(attr->type);
-            rootNode.append_attribute(attr->name.c_str()).set_value(value.c_str());
+    if (profile_) {
+        std::vector<std::string> path{name};
+        for (const PathNode* ancestor = parent; ancestor; ancestor = ancestor->parent) {
+            path.push_back(ancestor->element->name);
         }
+        std::reverse(path.begin(), path.end());
+        node->profile = profile_->find(path);
+    }
+    return node;
+}
 
-        // Generate children for complex type
-        if (root->type == XsdType::COMPLEX) {
-            for (const auto& child : root->children) {
-                generateElement(rootNode, child);
-            }
+void XmlGenerator::expand(PathNode& node) {
+    for (const auto& attr : node.element->attributes) {
+        node.attributes.push_back(makeNode(*attr, &node));
+    }
+    for (const auto& child : node.element->children) {
+        node.children.push_back(makeNode(*child, &node));
+    }
+    node.expanded = true;
+}
+
+std::string XmlGenerator::generateValue(PathNode& node) {
+    const PathProfile* profile = node.profile;
+    XsdType type = node.element->type;
+    if (!profile) {
+        return data_gen_.generateValue(type);
+    }
+    if (profile->cardinality == 0) {
+        return data_gen_.generateValue(type, *profile);
+    }
+
+    // One of the path's distinct values; the same rank always gives the same
+    // value, in every document and on every thread
+    auto rank = static_cast<uint64_t>(profile->pick.sampleInteger(data_gen_.engine()) - 1);
+    auto cached = node.pool.find(rank);
+    if (cached != node.pool.end()) {
+        return cached->second;
+    }
+
+    std::string value;
+    if (type == XsdType::INTEGER && profile->value.empty()) {
+        value = std::to_string(rank + 1);
+    } else {
+        pool_gen_.reseed(documentSeed(pool_seed_ ^ node.pathHash, rank));
+        if (type == XsdType::STRING && profile->length.empty()) {
+            value = pool_gen_.generateWord(pool_gen_.randomInt(5, 20));
         } else {
-            // Simple type root (rare but possible)
-            rootNode.text().set(data_gen_.generateValue(root->type).c_str());
+            value = pool_gen_.generateValue(type, *profile);
         }
     }
-
-    return doc;
+    if (node.pool.size() < kMaxPooledValues) {
+        node.pool.emplace(rank, value);
+    }
+    return value;
 }
 
-void XmlGenerator::generateElement(
-    pugi::xml_node& parent,
-    const std::shared_ptr<XsdElement>& element
-) {
+void XmlGenerator::generateElement(PathNode& node, size_t depth) {
     // Determine how many times to create this element
-    int count = determineRepeatCount(element);
+    int count = determineRepeatCount(node);
+
+    // Elements leading to the growing lists must be present
+    if (count == 0 && budget_ > 0 && !grown_ &&
+        depth < growth_path_.size() && growth_path_[depth] == node.element) {
+        count = 1;
+    }
 
     for (int i = 0; i < count; ++i) {
-        auto node = parent.append_child(element->name.c_str());
+        writeElement(node, depth);
+    }
+}
 
-        // Generate attributes first
-        for (const auto& attr : element->attributes) {
-            std::string value = data_gen_.generateValue(attr->type);
-            node.append_attribute(attr->name.c_str()).set_value(value.c_str());
+void XmlGenerator::writeElement(PathNode& node, size_t depth) {
+    const XsdElement& element = *node.element;
+    if (!node.expanded) {
+        expand(node);
+    }
+
+    indent(depth);
+    append("<", 1);
+    append(element.name.data(), element.name.size());
+
+    // Generate attributes first
+    for (const auto& attr : node.attributes) {
+        if (attr->profile && attr->profile->nullRate > 0.0 &&
+            std::uniform_real_distribution<double>(0.0, 1.0)(data_gen_.engine()) < attr->profile->nullRate) {
+            continue;
         }
+        append(" ", 1);
+        append(attr->element->name.data(), attr->element->name.size());
+        append("=\"", 2);
+        appendEscaped(generateValue(*attr), true);
+        append("\"", 1);
+    }
 
-        if (element->type == XsdType::COMPLEX) {
-            // Complex type - generate children
-            for (const auto& child : element->children) {
-                generateElement(node, child);
-            }
-        } else {
-            // Simple type - generate value
-            std::string value = data_gen_.generateValue(element->type);
-            node.text().set(value.c_str());
+    if (element.type != XsdType::COMPLEX) {
+        // Simple type - generate value
+        append(">", 1);
+        appendEscaped(generateValue(node), false);
+        append("</", 2);
+        append(element.name.data(), element.name.size());
+        append(">\n", 2);
+        return;
+    }
+
+    append(">\n", 2);
+    uint64_t emptyMark = written_ + buffer_.size();
+
+    bool grow = budget_ > 0 && !grown_ && !growth_path_.empty() && growth_path_.back() == &element;
+    if (grow) {
+        grown_ = true;
+    }
+
+    size_t unboundedLeft = 0;
+    if (grow) {
+        for (const auto& child : element.children) {
+            unboundedLeft += child->isUnbounded() ? 1 : 0;
         }
     }
+
+    // Complex type - generate children
+    for (const auto& child : node.children) {
+        if (!grow || !child->element->isUnbounded()) {
+            generateElement(*child, depth + 1);
+            continue;
+        }
+
+        // Repeat the list until it has its share of the remaining budget
+        uint64_t position = written_ + buffer_.size();
+        uint64_t share = budget_ > position ? (budget_ - position) / unboundedLeft : 0;
+        --unboundedLeft;
+        int minimum = determineRepeatCount(*child);
+        for (int i = 0; i < minimum || written_ + buffer_.size() < position + share; ++i) {
+            writeElement(*child, depth + 1);
+        }
+    }
+
+    if (written_ + buffer_.size() == emptyMark && buffer_.size() >= 2) {
+        // No children: self-closing tag, as pugixml writes it
+        buffer_.resize(buffer_.size() - 2);
+        append(" />\n", 4);
+        return;
+    }
+
+    indent(depth);
+    append("</", 2);
+    append(element.name.data(), element.name.size());
+    append(">\n", 2);
 }
 
-int XmlGenerator::determineRepeatCount(const std::shared_ptr<XsdElement>& element) {
-    // If element is optional (minOccurs=0), randomly decide whether to include it
-    if (element->isOptional()) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> include_dist(0, 1);
+void XmlGenerator::indent(size_t depth) {
+    buffer_.append(depth, '\t');
+}
+
+void XmlGenerator::append(const char* data, size_t length) {
+    buffer_.append(data, length);
+    if (buffer_.size() >= kFlushThreshold) {
+        flush();
+    }
+}
 
-        // 70% chance to include optional elements
-        if (include_dist(gen) < 0.7) {
+void XmlGenerator::appendEscaped(const std::string& value, bool attribute) {
+    const char* special = attribute ? "&<>\"" : "&<>";
+    size_t start = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (!std::strchr(special, value[i])) {
+            continue;
+        }
+        buffer_.append(value, start, i - start);
+        switch (value[i]) {
+            case '&': buffer_ += "&amp;"; break;
+            case '<': buffer_ += "&lt;"; break;
+            case '>': buffer_ += "&gt;"; break;
+            default: buffer_ += "&quot;"; break;
+        }
+        start = i + 1;
+    }
+    buffer_.append(value, start, std::string::npos);
+}
+
+void XmlGenerator::flush() {
+    if (buffer_.empty()) {
+        return;
+    }
+    if (std::fwrite(buffer_.data(), 1, buffer_.size(), out_) != buffer_.size()) {
+        throw std::runtime_error("Failed to write generated document");
+    }
+    written_ += buffer_.size();
+    buffer_.clear();
+}
+
+int XmlGenerator::determineRepeatCount(const PathNode& node) {
+    const XsdElement* element = node.element;
+    const PathProfile* profile = node.profile;
+
+    if (profile && profile->nullRate >= 0.0) {
+        // The profile's null rate replaces the schema's optionality
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(data_gen_.engine()) < profile->nullRate) {
+            return 0;
+        }
+    } else if (element->isOptional()) {
+        // Optional elements (minOccurs=0) are included half of the time
+        if (data_gen_.randomInt(0, 1) == 0) {
             return 0;  // Skip this element
         }
     }
 
+    if (profile && !profile->repeat.empty()) {
+        int64_t count = profile->repeat.sampleInteger(data_gen_.engine());
+        count = std::max<int64_t>(count, std::max(element->minOccurs, 1));
+        if (!element->isUnbounded()) {
+            count = std::min<int64_t>(count, std::max(element->maxOccurs, 1));
+        }
+        return static_cast<int>(std::min<int64_t>(count, std::numeric_limits<int>::max()));
+    }
+
     // If not repeatable, return minOccurs (usually 1)
     if (!element->isRepeatable()) {
         return element->minOccurs > 0 ? element->minOccurs : 1;
     }
 
     // For repeatable elements, generate a random count between minOccurs and maxOccurs
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-
     int minCount = element->minOccurs;
     int maxCount = element->maxOccurs;
 
@@ -151,8 +525,7 @@ int XmlGenerator::determineRepeatCount(const std::shared_ptr<XsdElement>& elemen
         return minCount;
     }
 
-    std::uniform_int_distribution<> count_dist(minCount, maxCount);
-    return count_dist(gen);
+    return data_gen_.randomInt(minCount, maxCount);
 }
 
 } // namespace expocli
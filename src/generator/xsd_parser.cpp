@@ -2,26 +2,94 @@
 #include <iostream>
 #include <algorithm>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
 
 namespace expocli {
 
-// Initialize static member
-std::map<std::string, std::shared_ptr<XsdElement>> XsdParser::named_types_;
-
 std::unique_ptr<XsdSchema> XsdParser::parse(const std::string& xsd_file_path) {
-    // Clear previous types
-    named_types_.clear();
+    XsdParser parser;
+    return parser.parseFile(xsd_file_path);
+}
 
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(xsd_file_path.c_str());
+std::vector<std::string> XsdParser::collectSchemaFiles(const std::string& xsd_file_path) {
+    std::vector<std::string> files;
+    std::set<std::string> seen;
+    std::vector<std::string> pending{xsd_file_path};
 
-    if (!result) {
-        throw std::runtime_error("Failed to parse XSD file: " + std::string(result.description()));
+    while (!pending.empty()) {
+        std::string path = pending.back();
+        pending.pop_back();
+        if (!seen.insert(std::filesystem::absolute(path).lexically_normal().string()).second) {
+            continue;
+        }
+        files.push_back(path);
+
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            continue;
+        }
+        std::string text(static_cast<size_t>(in.tellg()), '\0');
+        in.seekg(0);
+        in.read(&text[0], static_cast<std::streamsize>(text.size()));
+        auto locations = scanIncludeLocations(text, path);
+        pending.insert(pending.end(), locations.rbegin(), locations.rend());
     }
+    return files;
+}
 
-    auto schema = std::make_unique<XsdSchema>();
+// Building a DOM just to find the includes would cost as much as parsing the
+// schema, so the text is scanned for schemaLocation attributes instead
+std::vector<std::string> XsdParser::scanIncludeLocations(const std::string& text,
+                                                         const std::string& schemaPath) {
+    std::vector<std::string> locations;
+    std::filesystem::path baseDir = std::filesystem::path(schemaPath).parent_path();
+    static const std::string attrName = "schemaLocation";
+    const std::boyer_moore_horspool_searcher searcher(attrName.begin(), attrName.end());
+
+    for (auto match = std::search(text.begin(), text.end(), searcher); match != text.end();
+         match = std::search(match + attrName.size(), text.end(), searcher)) {
+        size_t pos = static_cast<size_t>(match - text.begin());
+        size_t tagStart = text.rfind('<', pos);
+        if (tagStart == std::string::npos) {
+            continue;
+        }
+        // Skip commented-out declarations
+        size_t commentStart = text.rfind("<!--", pos);
+        if (commentStart != std::string::npos) {
+            size_t commentEnd = text.find("-->", commentStart);
+            if (commentEnd == std::string::npos || commentEnd > pos) {
+                continue;
+            }
+        }
+
+        size_t nameEnd = text.find_first_of(" \t\r\n/>", tagStart + 1);
+        std::string tag = stripNamespacePrefix(text.substr(tagStart + 1, nameEnd - tagStart - 1));
+        if (tag != "include" && tag != "import" && tag != "redefine") {
+            continue;
+        }
+
+        size_t quote = text.find_first_not_of(" \t\r\n=", pos + attrName.size());
+        if (quote == std::string::npos || (text[quote] != '"' && text[quote] != '\'')) {
+            continue;
+        }
+        size_t valueEnd = text.find(text[quote], quote + 1);
+        if (valueEnd == std::string::npos) {
+            continue;
+        }
+        std::string location = text.substr(quote + 1, valueEnd - quote - 1);
+        if (location.empty() || location.find("://") != std::string::npos) {
+            continue;
+        }
+        locations.push_back((baseDir / location).string());
+    }
+    return locations;
+}
 
-    // Find the schema element (handle different namespace prefixes)
+pugi::xml_node XsdParser::findSchemaNode(const pugi::xml_document& doc) {
+    // Handle different namespace prefixes
     pugi::xml_node schemaNode = doc.child("xs:schema");
     if (!schemaNode) {
         schemaNode = doc.child("xsd:schema");
@@ -29,7 +97,65 @@ std::unique_ptr<XsdSchema> XsdParser::parse(const std::string& xsd_file_path) {
     if (!schemaNode) {
         schemaNode = doc.child("schema");
     }
+    return schemaNode;
+}
+
+std::vector<std::string> XsdParser::includeLocations(const pugi::xml_node& schemaNode,
+                                                     const std::string& schemaPath) {
+    std::vector<std::string> locations;
+    std::filesystem::path baseDir = std::filesystem::path(schemaPath).parent_path();
+
+    for (pugi::xml_node child : schemaNode.children()) {
+        std::string tag = stripNamespacePrefix(child.name());
+        if (tag != "include" && tag != "import" && tag != "redefine") {
+            continue;
+        }
+        std::string location = child.attribute("schemaLocation").value();
+        // Remote schemas are not fetched
+        if (location.empty() || location.find("://") != std::string::npos) {
+            continue;
+        }
+        locations.push_back((baseDir / location).string());
+    }
+    return locations;
+}
+
+void XsdParser::loadIncludedTypes(const pugi::xml_node& schemaNode, const std::string& schemaPath) {
+    for (const std::string& location : includeLocations(schemaNode, schemaPath)) {
+        if (!loaded_files_.insert(std::filesystem::absolute(location).lexically_normal().string()).second) {
+            continue;
+        }
+
+        pugi::xml_document doc;
+        pugi::xml_parse_result result = doc.load_file(location.c_str());
+        if (!result) {
+            throw std::runtime_error("Failed to parse included XSD file " + location + ": " +
+                                     std::string(result.description()));
+        }
+        pugi::xml_node includedSchema = findSchemaNode(doc);
+        if (!includedSchema) {
+            throw std::runtime_error("No schema element found in included XSD file " + location);
+        }
+
+        loadIncludedTypes(includedSchema, location);
+        parseAndStoreNamedTypes(includedSchema, doc);
+    }
+}
+
+std::unique_ptr<XsdSchema> XsdParser::parseFile(const std::string& xsd_file_path) {
+    named_types_.clear();
+    loaded_files_ = {std::filesystem::absolute(xsd_file_path).lexically_normal().string()};
+
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load_file(xsd_file_path.c_str());
+
+    if (!result) {
+        throw std::runtime_error("Failed to parse XSD file: " + std::string(result.description()));
+    }
+
+    auto schema = std::make_unique<XsdSchema>();
 
+    pugi::xml_node schemaNode = findSchemaNode(doc);
     if (!schemaNode) {
         throw std::runtime_error("No schema element found in XSD file");
     }
@@ -40,7 +166,9 @@ std::unique_ptr<XsdSchema> XsdParser::parse(const std::string& xsd_file_path) {
         schema->setTargetNamespace(targetNs);
     }
 
-    // First pass: parse and store all named types (complexType, simpleType)
+    // First pass: parse and store all named types (complexType, simpleType),
+    // starting with those of included schemas
+    loadIncludedTypes(schemaNode, xsd_file_path);
     parseAndStoreNamedTypes(schemaNode, doc);
 
     // Find the root element (first xs:element)
@@ -1,13 +1,23 @@
 #include "parser/lexer.h"
 #include "parser/parser.h"
 #include "executor/query_executor.h"
+#include "executor/schema_planner.h"
+#include "executor/memory_budget.h"
+#include "executor/scan_checkpoint.h"
+#include "executor/incremental_state.h"
 #include "utils/result_formatter.h"
 #include "utils/app_context.h"
 #include "utils/command_handler.h"
+#include "utils/workload.h"
+#include "utils/slow_query_log.h"
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <iomanip>
+#include <chrono>
+#include <optional>
+#include <memory>
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
@@ -93,7 +103,23 @@ void printUsage(const char* programName) {
     std::cout << "expocli - a FT XML parser for FT/DSI/DIP\n";
     std::cout << "Usage:\n";
     std::cout << "  " << programName << "              # Start interactive mode\n";
-    std::cout << "  " << programName << " [query]      # Execute single query\n\n";
+    std::cout << "  " << programName << " [query]      # Execute single query\n";
+    std::cout << "  " << programName << " --capture <file>\n";
+    std::cout << "                       # Interactive mode, recording queries to a workload file\n";
+    std::cout << "  " << programName << " --replay <file> [--concurrency <n>] [--speed <x>]\n";
+    std::cout << "                       # Replay a captured workload and report latency deltas\n";
+    std::cout << "                       # (speed 0 = no pacing, 1 = recorded pacing, 2 = twice as fast)\n";
+    std::cout << "  " << programName << " --max-memory <size> ...\n";
+    std::cout << "                       # Cap the memory documents take in flight (e.g. 512MB)\n";
+    std::cout << "  " << programName << " --timeout <s> --max-cpu-seconds <s> --max-bytes-scanned <size>\n";
+    std::cout << "          --max-rows <n> --max-result-memory <size> [--partial] ...\n";
+    std::cout << "                       # Per-query limits (as SET TIMEOUT ...; --partial = SET ON_LIMIT PARTIAL)\n";
+    std::cout << "  " << programName << " --checkpoint <file> ...\n";
+    std::cout << "                       # Save scan progress; rerunning the query resumes where it stopped\n";
+    std::cout << "                       # (as SET CHECKPOINT <file>)\n";
+    std::cout << "  " << programName << " --incremental <file> ...\n";
+    std::cout << "                       # Parse only the records appended to files since the last run\n";
+    std::cout << "                       # (as SET INCREMENTAL <file>)\n\n";
     std::cout << "Query Syntax:\n";
     std::cout << "  SELECT <field>[,<field>...] FROM <path>\n";
     std::cout << "  [WHERE <condition> [AND|OR <condition>...]]\n";
@@ -128,15 +154,33 @@ void printUsage(const char* programName) {
     std::cout << "Configuration Commands:\n";
     std::cout << "  SET XSD <path>        Set XSD schema file path\n";
     std::cout << "  SET DEST <path>       Set destination directory path\n";
+    std::cout << "  SET SLOW_QUERY_MS <n> Log queries taking >= n ms (OFF to disable)\n";
+    std::cout << "  SET SLOW_QUERY_LOG <path>  Slow query log file (default ~/.expocli_slow_queries.log)\n";
+    std::cout << "  SET MEMORY <size>     Memory budget for documents in flight (OFF to disable)\n";
+    std::cout << "  SET TIMEOUT <s>       Stop queries after s seconds (also MAX_CPU_SECONDS <s>,\n";
+    std::cout << "                        MAX_BYTES_SCANNED <size>, MAX_ROWS <n>, MAX_RESULT_MEMORY <size>;\n";
+    std::cout << "                        OFF to disable)\n";
+    std::cout << "  SET ON_LIMIT <FAIL|PARTIAL>  Fail, or return the rows so far, when a limit is hit\n";
     std::cout << "  SHOW XSD              Display current XSD path\n";
-    std::cout << "  SHOW DEST             Display current DEST path\n\n";
+    std::cout << "  SHOW DEST             Display current DEST path\n";
+    std::cout << "  SHOW MEMORY           Display the memory budget and peak in flight\n";
+    std::cout << "  SHOW LIMITS           Display the per-query limits\n\n";
     std::cout << "Generation Commands:\n";
     std::cout << "  GENERATE XML <count>              Generate <count> XML files from XSD\n";
-    std::cout << "  GENERATE XML <count> PREFIX <pre> Generate with custom filename prefix\n\n";
+    std::cout << "  GENERATE XML <count> PREFIX <pre> Generate with custom filename prefix\n";
+    std::cout << "  ... SEED <n>                      Reproducible output (same files for any thread count)\n";
+    std::cout << "  ... THREADS <n>                   Worker threads (default: one per core)\n";
+    std::cout << "  ... TARGET SIZE <n>[KB|MB|GB|TB]  Grow the files to this total size\n";
+    std::cout << "  ... PROFILE <file>                Value, repeat and file-size distributions\n";
+    std::cout << "  PROFILE <path> [INTO <file>]      Profile a corpus for look-alike generation\n";
+    std::cout << "                                    (GENERATE from it needs no XSD)\n\n";
     std::cout << "Validation Commands:\n";
     std::cout << "  CHECK <file>        Validate a single XML file against XSD\n";
     std::cout << "  CHECK <directory>   Validate all XML files in a directory\n";
-    std::cout << "  CHECK <pattern>     Validate files matching pattern (e.g., /path/*.xml)\n\n";
+    std::cout << "  CHECK <pattern>     Validate files matching pattern (e.g., /path/*.xml)\n";
+    std::cout << "  CHECK STREAM <path> Validate while reading (no DOM; reports line numbers)\n";
+    std::cout << "                      Files of 256 MB or more are always streamed\n";
+    std::cout << "  (Files unchanged since the last CHECK reuse its verdict)\n\n";
 }
 
 // Helper function to draw progress bar
@@ -155,12 +199,16 @@ std::string drawProgressBar(size_t completed, size_t total, size_t barWidth = 30
     return bar;
 }
 
-void executeQuery(const std::string& query, const expocli::AppContext* context = nullptr) {
+// Returns false if the query failed; outStats receives file and row counts
+bool executeQuery(const std::string& query, const expocli::AppContext* context = nullptr,
+                  expocli::ExecutionStats* outStats = nullptr) {
     if (query.empty()) {
-        return;
+        return true;
     }
 
     try {
+        auto queryStart = std::chrono::steady_clock::now();
+
         // Lexical analysis
         expocli::Lexer lexer(query);
         auto tokens = lexer.tokenize();
@@ -169,6 +217,25 @@ void executeQuery(const std::string& query, const expocli::AppContext* context =
         expocli::Parser parser(tokens);
         auto ast = parser.parse();
 
+        // Resolve paths and comparison types against the schema documents
+        // conform to: the VALIDATE AGAINST schema, else the one set by SET XSD
+        std::string planningSchema = ast->validate_schema;
+        if (planningSchema.empty() && context && context->hasXsdPath()) {
+            planningSchema = context->getXsdPath().value();
+        }
+        if (!planningSchema.empty()) {
+            std::shared_ptr<const expocli::CompiledSchema> schema;
+            try {
+                schema = expocli::CompiledSchema::load(planningSchema);
+            } catch (const std::exception&) {
+                // Unusable schema: run unplanned (VALIDATE AGAINST reports the error)
+            }
+            if (schema) {
+                expocli::SchemaPlanner::plan(*ast, *schema, planningSchema);
+            }
+        }
+        std::chrono::duration<double, std::milli> parseTime = std::chrono::steady_clock::now() - queryStart;
+
         // Check for ambiguous attributes if in verbose mode
         if (context && context->isVerbose()) {
             auto ambiguous = expocli::QueryExecutor::checkForAmbiguousAttributes(*ast);
@@ -186,10 +253,34 @@ void executeQuery(const std::string& query, const expocli::AppContext* context =
 
         // Execute query
         std::vector<expocli::ResultRow> results;
+        expocli::ExecutionStats stats;
+
+        expocli::QueryLimits limits = context ? context->getQueryLimits() : expocli::QueryLimits();
+
+        // Checkpointed scan (--checkpoint): resumes a run of the same query
+        std::unique_ptr<expocli::ScanCheckpoint> checkpoint;
+        if (context && !context->getCheckpointPath().empty()) {
+            checkpoint = std::make_unique<expocli::ScanCheckpoint>(context->getCheckpointPath(), query);
+        }
+
+        // Growing files (--incremental): parse only what was appended since the last run
+        std::unique_ptr<expocli::IncrementalState> incremental;
+        if (context && !context->getIncrementalPath().empty()) {
+            if (expocli::IncrementalState::supports(*ast)) {
+                incremental = std::make_unique<expocli::IncrementalState>(context->getIncrementalPath(), query);
+            } else {
+                std::cerr << "Note: queries with FOR clauses or VALIDATE AGAINST read files in full\n";
+            }
+        }
+
+        // Attribute per-file costs only when the slow query log is enabled
+        std::optional<double> slowQueryMs = context ? context->getSlowQueryThresholdMs() : std::nullopt;
+        if (slowQueryMs) {
+            stats.top_files_limit = expocli::SlowQueryLog::kTopFiles;
+        }
 
         if (context && context->isVerbose()) {
             // Use progress tracking in VERBOSE mode
-            expocli::ExecutionStats stats;
             std::string lastProgressLine;
 
             auto progressCallback = [&lastProgressLine](size_t completed, size_t total, size_t threadCount) {
@@ -217,7 +308,8 @@ void executeQuery(const std::string& query, const expocli::AppContext* context =
                 std::cout << lastProgressLine << std::flush;
             };
 
-            results = expocli::QueryExecutor::executeWithProgress(*ast, progressCallback, &stats);
+            results = expocli::QueryExecutor::executeWithProgress(*ast, progressCallback, &stats, limits,
+                                                                checkpoint.get(), incremental.get());
 
             // Clear progress line
             if (!lastProgressLine.empty()) {
@@ -237,20 +329,63 @@ void executeQuery(const std::string& query, const expocli::AppContext* context =
 
         } else {
             // Non-verbose mode: use standard execution
-            results = expocli::QueryExecutor::execute(*ast);
+            results = expocli::QueryExecutor::execute(*ast, &stats, limits, checkpoint.get(), incremental.get());
         }
 
         // Format and print results
+        auto formatStart = std::chrono::steady_clock::now();
         expocli::ResultFormatter::print(results);
+        if (incremental) {
+            try {
+                incremental->save();
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: " << e.what() << std::endl;
+            }
+            std::cout << "Incremental: " << incremental->appendedFiles() << " file(s) read from their last record, "
+                      << incremental->fullFiles() << " in full (" << incremental->bytesRead() << " bytes read)\n";
+        }
+        if (stats.resumed_files > 0) {
+            std::cout << "Resumed from checkpoint " << context->getCheckpointPath() << ": "
+                      << stats.resumed_files << " file(s) already scanned\n";
+        }
+        if (!stats.limit_reached.empty()) {
+            std::cout << stats.limit_reached << "; the result is partial\n";
+        }
+        if (stats.invalid_files > 0) {
+            std::cout << "Skipped " << stats.invalid_files << " file(s) failing validation against "
+                      << ast->validate_schema << "\n";
+        }
+        auto queryEnd = std::chrono::steady_clock::now();
+
+        // Slow query log
+        std::chrono::duration<double, std::milli> totalTime = queryEnd - queryStart;
+        if (slowQueryMs && totalTime.count() >= *slowQueryMs) {
+            std::chrono::duration<double, std::milli> formatTime = queryEnd - formatStart;
+            stats.stages.insert(stats.stages.begin(), {"parse", parseTime.count()});
+            stats.stages.push_back({"format", formatTime.count()});
+            try {
+                expocli::SlowQueryLog::append(context->getSlowQueryLogPath(), query, totalTime.count(), stats);
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: " << e.what() << std::endl;
+            }
+        }
+
+        if (outStats) {
+            *outStats = stats;
+        }
+        return true;
 
     } catch (const expocli::ParseError& e) {
         std::cerr << "Parse Error: " << e.what() << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
     }
+    return false;
 }
 
-void interactiveMode() {
+// Interactive mode; if capturePath is set, queries are recorded to a workload file
+void interactiveMode(const std::string& capturePath = "", const expocli::QueryLimits& limits = {},
+                     const std::string& checkpointPath = "", const std::string& incrementalPath = "") {
     // Register signal handler for CTRL-C
     std::signal(SIGINT, signalHandler);
 
@@ -259,9 +394,21 @@ void interactiveMode() {
 
     // Create application context and command handler
     expocli::AppContext context;
+    context.setQueryLimits(limits);
+    context.setCheckpointPath(checkpointPath);
+    context.setIncrementalPath(incrementalPath);
     expocli::CommandHandler commandHandler(context);
 
+    // Workload capture (--capture)
+    expocli::WorkloadRecorder recorder;
+    if (!capturePath.empty()) {
+        recorder.open(capturePath);
+    }
+
     printWelcome();
+    if (recorder.isActive()) {
+        std::cout << "Capturing workload to " << recorder.path() << "\n\n";
+    }
 
     std::string query;
     char* lineBuffer = nullptr;
@@ -354,8 +501,21 @@ void interactiveMode() {
             // Check if it's a SET or SHOW command
             if (!commandHandler.handleCommand(query)) {
                 // Not a command, execute as a query
-                executeQuery(query, &context);
+                expocli::ExecutionStats stats;
+                auto start = std::chrono::steady_clock::now();
+                bool ok = executeQuery(query, &context, &stats);
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
                 std::cout << std::endl;
+
+                if (recorder.isActive()) {
+                    expocli::WorkloadEntry entry;
+                    entry.elapsed_ms = elapsed.count();
+                    entry.rows = stats.result_rows;
+                    entry.files = stats.total_files;
+                    entry.ok = ok;
+                    entry.query = query;
+                    recorder.record(entry);
+                }
             }
 
             // Reset for next query
@@ -372,9 +532,60 @@ void interactiveMode() {
 
 int main(int argc, char* argv[]) {
     try {
+        // Leading options, for every mode below; query limits become the
+        // session's (--timeout 30 is SET TIMEOUT 30)
+        expocli::QueryLimits limits;
+        std::string checkpointPath;
+        std::string incrementalPath;
+        while (argc >= 2 && std::strncmp(argv[1], "--", 2) == 0) {
+            std::string option = argv[1];
+            std::string setting = option.substr(2);
+            std::transform(setting.begin(), setting.end(), setting.begin(), [](unsigned char c) {
+                return c == '-' ? '_' : static_cast<char>(std::toupper(c));
+            });
+
+            int used = 2;
+            if (option == "--partial") {
+                limits.partial = true;
+                used = 1;
+            } else if (option == "--max-memory") {
+                uint64_t bytes = 0;
+                if (argc < 3 || !expocli::MemoryBudget::parseSize(argv[2], bytes) || bytes == 0) {
+                    std::cerr << "Error: --max-memory requires a size such as 512MB\n";
+                    return 1;
+                }
+                expocli::MemoryBudget::setLimit(bytes);
+            } else if (option == "--checkpoint") {
+                if (argc < 3) {
+                    std::cerr << "Error: --checkpoint requires a file path\n";
+                    return 1;
+                }
+                checkpointPath = argv[2];
+            } else if (option == "--incremental") {
+                if (argc < 3) {
+                    std::cerr << "Error: --incremental requires a file path\n";
+                    return 1;
+                }
+                incrementalPath = argv[2];
+            } else if (expocli::QueryLimits::isSetting(setting) && setting != "ON_LIMIT") {
+                std::string error;
+                if (argc < 3 || !limits.set(setting, argv[2], error)) {
+                    std::cerr << "Error: " << (argc < 3 ? option + " requires a value" : error) << "\n";
+                    return 1;
+                }
+            } else {
+                break;
+            }
+
+            // Drop the option, keeping the program name first
+            argv[used] = argv[0];
+            argv += used;
+            argc -= used;
+        }
+
         // No arguments: enter interactive mode
         if (argc < 2) {
-            interactiveMode();
+            interactiveMode("", limits, checkpointPath, incrementalPath);
             return 0;
         }
 
@@ -385,9 +596,62 @@ int main(int argc, char* argv[]) {
             return 0;
         }
 
+        // Interactive mode with workload capture
+        if (arg == "--capture") {
+            if (argc < 3) {
+                std::cerr << "Error: --capture requires a workload file path\n";
+                return 1;
+            }
+            interactiveMode(argv[2], limits, checkpointPath, incrementalPath);
+            return 0;
+        }
+
+        // Replay a captured workload
+        if (arg == "--replay") {
+            if (argc < 3) {
+                std::cerr << "Error: --replay requires a workload file path\n";
+                return 1;
+            }
+
+            expocli::ReplayOptions options;
+            options.limits = limits;
+            for (int i = 3; i < argc; ++i) {
+                std::string opt = argv[i];
+                if (opt == "--concurrency" && i + 1 < argc) {
+                    options.concurrency = std::max(1, std::atoi(argv[++i]));
+                } else if (opt == "--speed" && i + 1 < argc) {
+                    options.speed = std::max(0.0, std::atof(argv[++i]));
+                } else {
+                    std::cerr << "Error: Unknown replay option: " << opt << "\n";
+                    return 1;
+                }
+            }
+
+            auto entries = expocli::WorkloadReplayer::load(argv[2]);
+            std::cout << "Replaying " << entries.size() << " queries from " << argv[2]
+                      << " (concurrency " << options.concurrency << ", speed ";
+            if (options.speed > 0) {
+                std::cout << options.speed << "x";
+            } else {
+                std::cout << "unpaced";
+            }
+            std::cout << ")\n\n";
+
+            auto start = std::chrono::steady_clock::now();
+            auto results = expocli::WorkloadReplayer::replay(entries, options);
+            std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+            expocli::WorkloadReplayer::printReport(results, wall.count());
+            return 0;
+        }
+
         // Single query mode: execute query from command line
         std::string query = argv[1];
-        executeQuery(query);
+        expocli::AppContext context;
+        context.setQueryLimits(limits);
+        context.setCheckpointPath(checkpointPath);
+        context.setIncrementalPath(incrementalPath);
+        executeQuery(query, &context);
 
         return 0;
 
@@ -1,5 +1,7 @@
 #include "parser/parser.h"
+#include "utils/temporal.h"
 #include <algorithm>
+#include <cctype>
 
 namespace expocli {
 
@@ -37,6 +39,11 @@ std::unique_ptr<Query> Parser::parse() {
 
     query->from_path = parseFilePath();
 
+    // Parse optional VALIDATE AGAINST clause
+    if (checkWord("VALIDATE") && checkWord("AGAINST", 1)) {
+        parseValidateClause(*query);
+    }
+
     // Parse optional FOR clauses (can have multiple for nested iteration)
     while (check(TokenType::FOR)) {
         query->for_clauses.push_back(parseForClause());
@@ -120,6 +127,24 @@ bool Parser::check(TokenType type) const {
     return peek().type == type;
 }
 
+bool Parser::checkWord(const char* word, size_t ahead) const {
+    size_t index = current_ + ahead;
+    if (index >= tokens_.size() || tokens_[index].type != TokenType::IDENTIFIER) {
+        return false;
+    }
+    const std::string& value = tokens_[index].value;
+    size_t length = std::char_traits<char>::length(word);
+    if (value.size() != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (std::toupper(static_cast<unsigned char>(value[i])) != word[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Parser::match(TokenType type) {
     if (check(type)) {
         advance();
@@ -370,6 +395,14 @@ std::string Parser::parseFilePath() {
             break;
         }
 
+        // Contextual keywords of the VALIDATE clause end the path when they
+        // stand apart from it (e.g. "FROM data VALIDATE AGAINST ...")
+        if (!path.empty() && current_ > 0 &&
+            current.position > tokens_[current_ - 1].position + tokens_[current_ - 1].value.size() &&
+            (checkWord("VALIDATE") || checkWord("SKIP") || checkWord("FAIL"))) {
+            break;
+        }
+
         // Collect path components
         // Accept identifiers, slashes, dots, and also keywords that might appear in filenames
         // (like "xml", "data", etc.) but stop at statement keywords
@@ -411,6 +444,29 @@ std::string Parser::parseFilePath() {
     return path;
 }
 
+// Parse VALIDATE AGAINST <xsd> [SKIP INVALID | FAIL]
+void Parser::parseValidateClause(Query& query) {
+    advance();  // VALIDATE
+    advance();  // AGAINST
+
+    if (peek().type == TokenType::END_OF_INPUT) {
+        throw ParseError("Expected XSD path after VALIDATE AGAINST");
+    }
+    query.validate_schema = parseFilePath();
+
+    if (checkWord("SKIP")) {
+        advance();
+        if (!checkWord("INVALID")) {
+            throw ParseError("Expected INVALID after SKIP");
+        }
+        advance();
+        query.invalid_policy = InvalidDocumentPolicy::SKIP;
+    } else if (checkWord("FAIL")) {
+        advance();
+        query.invalid_policy = InvalidDocumentPolicy::FAIL;
+    }
+}
+
 // Parse FOR...IN clause (with optional AT position)
 ForClause Parser::parseForClause() {
     ForClause forClause;
@@ -623,12 +679,33 @@ std::unique_ptr<WhereExpr> Parser::parseWhereCondition() {
 
     // Parse value
     Token valueToken = peek();
-    if (valueToken.type == TokenType::NUMBER) {
+    if ((checkWord("DATE") || checkWord("DATETIME")) &&
+        current_ + 1 < tokens_.size() && tokens_[current_ + 1].type == TokenType::STRING_LITERAL) {
+        // Typed literal: DATE 'YYYY-MM-DD' or DATETIME 'YYYY-MM-DDThh:mm:ss[Z]'
+        bool isDate = checkWord("DATE");
+        advance(); // consume DATE/DATETIME
+        condition->value = advance().value;
+        const std::string& text = condition->value;
+        bool valid = isDate ? Temporal::parseDate(text.data(), text.size(), condition->temporal_value)
+                            : Temporal::parseDateTime(text.data(), text.size(), condition->temporal_value);
+        if (!valid) {
+            throw ParseError("Invalid " + std::string(isDate ? "DATE" : "DATETIME") + " literal '" + text +
+                             "' (expected " + (isDate ? "YYYY-MM-DD" : "YYYY-MM-DDThh:mm:ss") + ")");
+        }
+        condition->is_numeric = false;
+        condition->is_temporal = true;
+    }
+    else if (valueToken.type == TokenType::NUMBER) {
         condition->value = advance().value;
         condition->is_numeric = true;
     }
-    else if (valueToken.type == TokenType::STRING_LITERAL ||
-             valueToken.type == TokenType::IDENTIFIER) {
+    else if (valueToken.type == TokenType::STRING_LITERAL) {
+        // A quoted ISO-8601 date or date-time compares chronologically
+        condition->value = advance().value;
+        condition->is_numeric = false;
+        condition->is_temporal = Temporal::parse(condition->value, condition->temporal_value);
+    }
+    else if (valueToken.type == TokenType::IDENTIFIER) {
         condition->value = advance().value;
         condition->is_numeric = false;
     }
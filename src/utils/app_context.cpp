@@ -34,4 +34,44 @@ bool AppContext::isVerbose() const {
     return verbose_;
 }
 
+void AppContext::setSlowQueryThresholdMs(std::optional<double> ms) {
+    slow_query_ms_ = ms;
+}
+
+std::optional<double> AppContext::getSlowQueryThresholdMs() const {
+    return slow_query_ms_;
+}
+
+void AppContext::setSlowQueryLogPath(const std::string& path) {
+    slow_query_log_path_ = path;
+}
+
+std::string AppContext::getSlowQueryLogPath() const {
+    return slow_query_log_path_;
+}
+
+void AppContext::setQueryLimits(const QueryLimits& limits) {
+    query_limits_ = limits;
+}
+
+const QueryLimits& AppContext::getQueryLimits() const {
+    return query_limits_;
+}
+
+void AppContext::setCheckpointPath(const std::string& path) {
+    checkpoint_path_ = path;
+}
+
+std::string AppContext::getCheckpointPath() const {
+    return checkpoint_path_;
+}
+
+void AppContext::setIncrementalPath(const std::string& path) {
+    incremental_path_ = path;
+}
+
+std::string AppContext::getIncrementalPath() const {
+    return incremental_path_;
+}
+
 } // namespace expocli
@@ -2,14 +2,47 @@
 #include "parser/lexer.h"
 #include "generator/xsd_parser.h"
 #include "generator/xml_generator.h"
+#include "generator/corpus_profiler.h"
 #include "validator/xml_validator.h"
+#include "validator/compiled_schema.h"
+#include "validator/validation_cache.h"
+#include "executor/query_executor.h"
+#include "executor/memory_budget.h"
+#include "utils/slow_query_log.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
 
 namespace expocli {
 
+namespace {
+
+// Uppercased token value, used for options that are not lexer keywords
+std::string upperValue(const Token& token) {
+    std::string value = token.value;
+    std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+    return value;
+}
+
+std::string formatSize(uint64_t bytes) {
+    static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        ++unit;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return oss.str();
+}
+
+} // anonymous namespace
+
 CommandHandler::CommandHandler(AppContext& context)
     : context_(context) {}
 
@@ -42,6 +75,11 @@ bool CommandHandler::handleCommand(const std::string& input) {
         return handleCheckCommand(input);
     }
 
+    // Check if it's a PROFILE command (not a lexer keyword)
+    if (tokens[0].type == TokenType::IDENTIFIER && upperValue(tokens[0]) == "PROFILE") {
+        return handleProfileCommand(input);
+    }
+
     // Not a recognized command, treat as query
     return false;
 }
@@ -50,17 +88,31 @@ bool CommandHandler::handleSetCommand(const std::string& input) {
     Lexer lexer(input);
     auto tokens = lexer.tokenize();
 
-    // Expect: SET <XSD|DEST|VERBOSE> <path>
+    // Expect: SET <XSD|DEST|VERBOSE|SLOW_QUERY_MS|SLOW_QUERY_LOG|MEMORY|CHECKPOINT|INCREMENTAL|<limit>> <value>
     if (tokens.size() < 2) {
         std::cerr << "Error: SET command requires a parameter\n";
         std::cerr << "Usage: SET XSD /path/to/file.xsd\n";
         std::cerr << "       SET DEST /path/to/directory\n";
         std::cerr << "       SET VERBOSE\n";
+        std::cerr << "       SET SLOW_QUERY_MS <ms|OFF>\n";
+        std::cerr << "       SET SLOW_QUERY_LOG /path/to/file.log\n";
+        std::cerr << "       SET MEMORY <size|OFF>\n";
+        std::cerr << "       SET CHECKPOINT </path/to/file|OFF>\n";
+        std::cerr << "       SET INCREMENTAL </path/to/file|OFF>\n";
+        std::cerr << "       SET <TIMEOUT|MAX_CPU_SECONDS> <seconds|OFF>\n";
+        std::cerr << "       SET <MAX_BYTES_SCANNED|MAX_RESULT_MEMORY> <size|OFF>\n";
+        std::cerr << "       SET MAX_ROWS <n|OFF>\n";
+        std::cerr << "       SET ON_LIMIT <FAIL|PARTIAL>\n";
         return true;
     }
 
     TokenType paramType = tokens[1].type;
 
+    // Session options named by identifier rather than keyword
+    if (paramType == TokenType::IDENTIFIER) {
+        return handleSetOption(upperValue(tokens[1]), tokens);
+    }
+
     // Handle VERBOSE (no path required)
     if (paramType == TokenType::VERBOSE) {
         context_.setVerbose(true);
@@ -116,6 +168,130 @@ bool CommandHandler::handleSetCommand(const std::string& input) {
     return true;
 }
 
+bool CommandHandler::handleSetOption(const std::string& option, const std::vector<Token>& tokens) {
+    // Value tokens follow the option name (tokens[0] is SET)
+    bool hasValue = tokens.size() > 2 && tokens[2].type != TokenType::END_OF_INPUT;
+
+    if (option == "SLOW_QUERY_MS") {
+        if (!hasValue) {
+            std::cerr << "Error: SET SLOW_QUERY_MS requires a threshold in milliseconds or OFF\n";
+            return true;
+        }
+        if (tokens[2].type == TokenType::IDENTIFIER && upperValue(tokens[2]) == "OFF") {
+            context_.setSlowQueryThresholdMs(std::nullopt);
+            std::cout << "Slow query log disabled\n";
+            return true;
+        }
+        if (tokens[2].type != TokenType::NUMBER) {
+            std::cerr << "Error: Invalid SLOW_QUERY_MS value: " << tokens[2].value << "\n";
+            return true;
+        }
+        double threshold = std::stod(tokens[2].value);
+        context_.setSlowQueryThresholdMs(threshold);
+        if (context_.getSlowQueryLogPath().empty()) {
+            context_.setSlowQueryLogPath(SlowQueryLog::defaultPath());
+        }
+        std::cout << "Slow query log enabled: queries taking >= " << tokens[2].value
+                  << " ms are logged to " << context_.getSlowQueryLogPath() << "\n";
+        return true;
+    }
+
+    if (option == "SLOW_QUERY_LOG") {
+        // Path may be quoted or span several tokens (./logs/slow.log)
+        std::string path;
+        for (size_t i = 2; i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT; ++i) {
+            path += tokens[i].value;
+        }
+        if (path.empty()) {
+            std::cerr << "Error: SET SLOW_QUERY_LOG requires a file path\n";
+            return true;
+        }
+        context_.setSlowQueryLogPath(path);
+        std::cout << "Slow query log file set to: " << path << "\n";
+        return true;
+    }
+
+    if (option == "CHECKPOINT" || option == "INCREMENTAL") {
+        bool checkpoint = option == "CHECKPOINT";
+        if (hasValue && tokens[2].type == TokenType::IDENTIFIER && upperValue(tokens[2]) == "OFF" &&
+            (tokens.size() < 4 || tokens[3].type == TokenType::END_OF_INPUT)) {
+            if (checkpoint) {
+                context_.setCheckpointPath("");
+                std::cout << "Scan checkpoints disabled\n";
+            } else {
+                context_.setIncrementalPath("");
+                std::cout << "Incremental reading disabled\n";
+            }
+            return true;
+        }
+        std::string path;
+        for (size_t i = 2; i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT; ++i) {
+            path += tokens[i].value;
+        }
+        if (path.empty()) {
+            std::cerr << "Error: SET " << option << " requires a file path or OFF\n";
+            return true;
+        }
+        if (checkpoint) {
+            context_.setCheckpointPath(path);
+            std::cout << "Scan progress is checkpointed to: " << path << "\n";
+        } else {
+            context_.setIncrementalPath(path);
+            std::cout << "Files are read from their last recorded record, kept in: " << path << "\n";
+        }
+        return true;
+    }
+
+    if (option == "MEMORY") {
+        if (!hasValue) {
+            std::cerr << "Error: SET MEMORY requires a size such as 512MB, or OFF\n";
+            return true;
+        }
+        if (tokens[2].type == TokenType::IDENTIFIER && upperValue(tokens[2]) == "OFF") {
+            MemoryBudget::setLimit(0);
+            std::cout << "Memory budget disabled\n";
+            return true;
+        }
+        // 512MB lexes as a number and a unit
+        std::string size;
+        for (size_t i = 2; i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT; ++i) {
+            size += tokens[i].value;
+        }
+        uint64_t bytes = 0;
+        if (tokens[2].type != TokenType::NUMBER || !MemoryBudget::parseSize(size, bytes) || bytes == 0) {
+            std::cerr << "Error: Invalid MEMORY value: " << size << "\n";
+            return true;
+        }
+        MemoryBudget::setLimit(bytes);
+        std::ostringstream oss;
+        oss << "Memory budget set to " << size << " (documents take about "
+            << std::fixed << std::setprecision(1) << MemoryBudget::expansionFactor()
+            << "x their file size)\n";
+        std::cout << oss.str();
+        return true;
+    }
+
+    if (QueryLimits::isSetting(option)) {
+        // 10GB and 2.5 lex as several tokens
+        std::string value;
+        for (size_t i = 2; i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT; ++i) {
+            value += tokens[i].value;
+        }
+        QueryLimits limits = context_.getQueryLimits();
+        std::string error;
+        if (!hasValue || !limits.set(option, value, error)) {
+            std::cerr << "Error: " << (hasValue ? error : "SET " + option + " requires a value") << "\n";
+            return true;
+        }
+        context_.setQueryLimits(limits);
+        std::cout << option << " set to " << value << "\n";
+        return true;
+    }
+
+    std::cerr << "Error: Unknown SET parameter: " << tokens[1].value << "\n";
+    return true;
+}
+
 bool CommandHandler::handleShowCommand(const std::string& input) {
     Lexer lexer(input);
     auto tokens = lexer.tokenize();
@@ -135,6 +311,31 @@ bool CommandHandler::handleShowCommand(const std::string& input) {
         showXsdPath();
     } else if (paramType == TokenType::DEST) {
         showDestPath();
+    } else if (paramType == TokenType::IDENTIFIER && upperValue(tokens[1]) == "SLOW_QUERY_MS") {
+        auto threshold = context_.getSlowQueryThresholdMs();
+        if (threshold) {
+            std::cout << "SLOW_QUERY_MS: " << *threshold << " (log: " << context_.getSlowQueryLogPath() << ")\n";
+        } else {
+            std::cout << "SLOW_QUERY_MS: OFF\n";
+        }
+    } else if (paramType == TokenType::IDENTIFIER && upperValue(tokens[1]) == "CHECKPOINT") {
+        std::string path = context_.getCheckpointPath();
+        std::cout << "CHECKPOINT: " << (path.empty() ? "OFF" : path) << "\n";
+    } else if (paramType == TokenType::IDENTIFIER && upperValue(tokens[1]) == "INCREMENTAL") {
+        std::string path = context_.getIncrementalPath();
+        std::cout << "INCREMENTAL: " << (path.empty() ? "OFF" : path) << "\n";
+    } else if (paramType == TokenType::IDENTIFIER && upperValue(tokens[1]) == "LIMITS") {
+        std::cout << context_.getQueryLimits().describe();
+    } else if (paramType == TokenType::IDENTIFIER && upperValue(tokens[1]) == "MEMORY") {
+        uint64_t limit = MemoryBudget::limit();
+        if (limit > 0) {
+            std::ostringstream oss;
+            oss << "MEMORY: " << formatSize(limit) << " (expansion " << std::fixed << std::setprecision(1)
+                << MemoryBudget::expansionFactor() << "x, peak in flight " << formatSize(MemoryBudget::peak()) << ")\n";
+            std::cout << oss.str();
+        } else {
+            std::cout << "MEMORY: OFF\n";
+        }
     } else {
         std::cerr << "Error: Unknown SHOW parameter. Use XSD or DEST\n";
     }
@@ -146,6 +347,23 @@ void CommandHandler::setXsdPath(const std::string& path) {
     if (validateXsdFile(path)) {
         context_.setXsdPath(path);
         std::cout << "XSD path set to: " << path << "\n";
+
+        // Compile now (or fetch from the schema cache) so CHECK, GENERATE and
+        // VALIDATE AGAINST start without parsing the XSD
+        try {
+            auto start = std::chrono::steady_clock::now();
+            CompiledSchema::LoadSource source;
+            auto schema = CompiledSchema::load(path, &source);
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            std::ostringstream elapsed;
+            elapsed << std::fixed << std::setprecision(1) << ms;
+            std::cout << "Schema " << (source == CompiledSchema::LoadSource::COMPILED ? "compiled" : "loaded from cache")
+                      << " (" << schema->elementCount() << " element declarations, "
+                      << elapsed.str() << " ms)\n";
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: " << e.what() << "\n";
+        }
     }
 }
 
@@ -259,11 +477,14 @@ bool CommandHandler::handleGenerateCommand(const std::string& input) {
     Lexer lexer(input);
     auto tokens = lexer.tokenize();
 
-    // Expect: GENERATE XML <count> [PREFIX <prefix>]
+    // Expect: GENERATE XML <count> [PREFIX <prefix>] [SEED <n>] [THREADS <n>]
+    //                              [TARGET SIZE <size>] [PROFILE <file>]
     if (tokens.size() < 3) {
         std::cerr << "Error: GENERATE command requires XML and count\n";
         std::cerr << "Usage: GENERATE XML <count>\n";
         std::cerr << "       GENERATE XML <count> PREFIX <prefix>\n";
+        std::cerr << "       GENERATE XML <count> [SEED <n>] [THREADS <n>] [TARGET SIZE <size>]\n";
+        std::cerr << "                            [PROFILE <file>]\n";
         return true;
     }
 
@@ -279,30 +500,122 @@ bool CommandHandler::handleGenerateCommand(const std::string& input) {
         return true;
     }
 
-    int count = 0;
+    GenerationOptions options;
     try {
-        count = std::stoi(tokens[2].value);
+        options.count = std::stoi(tokens[2].value);
     } catch (...) {
         std::cerr << "Error: Invalid count value\n";
         return true;
     }
 
-    if (count <= 0) {
+    if (options.count <= 0) {
         std::cerr << "Error: Count must be positive\n";
         return true;
     }
 
-    // Check for optional PREFIX
-    std::string prefix = "generated_";
-    if (tokens.size() >= 5 && tokens[3].type == TokenType::PREFIX) {
-        if (tokens[4].type == TokenType::IDENTIFIER ||
-            tokens[4].type == TokenType::STRING_LITERAL) {
-            prefix = tokens[4].value;
+    // Optional clauses, in any order
+    auto wholeNumber = [&](size_t index, uint64_t& value) {
+        if (index >= tokens.size() || tokens[index].type != TokenType::NUMBER ||
+            tokens[index].value.find('.') != std::string::npos) {
+            return false;
+        }
+        try {
+            value = std::stoull(tokens[index].value);
+        } catch (...) {
+            return false;
+        }
+        return true;
+    };
+
+    size_t i = 3;
+    while (i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT) {
+        std::string option = upperValue(tokens[i]);
+        uint64_t value = 0;
+
+        if (tokens[i].type == TokenType::PREFIX) {
+            if (i + 1 < tokens.size() &&
+                (tokens[i + 1].type == TokenType::IDENTIFIER ||
+                 tokens[i + 1].type == TokenType::STRING_LITERAL)) {
+                options.prefix = tokens[i + 1].value;
+            }
+            i += 2;
+        } else if (option == "SEED") {
+            if (!wholeNumber(i + 1, value)) {
+                std::cerr << "Error: SEED requires a non-negative integer\n";
+                return true;
+            }
+            options.seed = value;
+            i += 2;
+        } else if (option == "THREADS") {
+            if (!wholeNumber(i + 1, value) || value == 0) {
+                std::cerr << "Error: THREADS requires a positive integer\n";
+                return true;
+            }
+            options.threads = static_cast<size_t>(value);
+            i += 2;
+        } else if (option == "TARGET" && i + 1 < tokens.size() && upperValue(tokens[i + 1]) == "SIZE") {
+            // <n> [B|KB|MB|GB|TB], units are powers of 1024
+            if (!wholeNumber(i + 2, value) || value == 0) {
+                std::cerr << "Error: TARGET SIZE requires a size such as 500MB or 10GB\n";
+                return true;
+            }
+            i += 3;
+            uint64_t multiplier = 1;
+            if (i < tokens.size() && tokens[i].type == TokenType::IDENTIFIER) {
+                static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+                std::string unit = upperValue(tokens[i]);
+                bool known = false;
+                for (const char* name : units) {
+                    if (unit == name) {
+                        known = true;
+                        break;
+                    }
+                    multiplier *= 1024;
+                }
+                if (!known) {
+                    std::cerr << "Error: Unknown size unit: " << tokens[i].value << "\n";
+                    return true;
+                }
+                ++i;
+            }
+            options.targetBytes = value * multiplier;
+        } else if (option == "PROFILE") {
+            // Quoted, or the raw text up to the next space (paths span several tokens)
+            if (i + 1 >= tokens.size() || tokens[i + 1].type == TokenType::END_OF_INPUT) {
+                std::cerr << "Error: PROFILE requires a profile file\n";
+                return true;
+            }
+            std::string profilePath = tokens[i + 1].value;
+            size_t end = tokens[i + 1].position;
+            if (tokens[i + 1].type != TokenType::STRING_LITERAL) {
+                end = input.find_first_of(" \t", tokens[i + 1].position);
+                if (end == std::string::npos) {
+                    end = input.size();
+                }
+                profilePath = input.substr(tokens[i + 1].position, end - tokens[i + 1].position);
+            }
+            i += 2;
+            while (i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT &&
+                   tokens[i].position < end) {
+                ++i;
+            }
+            try {
+                options.profile = std::make_shared<GenerationProfile>(GenerationProfile::load(profilePath));
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return true;
+            }
+        } else {
+            std::cerr << "Error: Unexpected token in GENERATE command: " << tokens[i].value << "\n";
+            return true;
         }
     }
 
+    // A profile written by PROFILE declares the structure itself
+    bool profileStructure = options.profile && options.profile->hasStructure();
+
     // Check if XSD is set
-    if (!context_.hasXsdPath()) {
+    if (!profileStructure && !context_.hasXsdPath()) {
         std::cerr << "Error: XSD path not set. Use SET XSD <path> first\n";
         return true;
     }
@@ -313,17 +626,22 @@ bool CommandHandler::handleGenerateCommand(const std::string& input) {
         return true;
     }
 
-    std::string xsdPath = context_.getXsdPath().value();
     std::string destPath = context_.getDestPath().value();
 
     try {
-        // Parse XSD schema
-        std::cout << "Parsing XSD schema: " << xsdPath << "\n";
-        auto schema = XsdParser::parse(xsdPath);
+        std::shared_ptr<XsdSchema> schema;
+        if (profileStructure) {
+            schema = options.profile->toSchema();
+        } else {
+            // Load the XSD schema (compiled tables are cached between sessions)
+            std::string xsdPath = context_.getXsdPath().value();
+            std::cout << "Parsing XSD schema: " << xsdPath << "\n";
+            schema = CompiledSchema::load(xsdPath)->toSchema();
+        }
 
         // Generate XML files
         XmlGenerator generator;
-        generator.generateFiles(*schema, count, destPath, prefix);
+        generator.generateFiles(*schema, destPath, options);
 
     } catch (const std::exception& e) {
         std::cerr << "Error generating XML files: " << e.what() << "\n";
@@ -333,6 +651,81 @@ bool CommandHandler::handleGenerateCommand(const std::string& input) {
     return true;
 }
 
+bool CommandHandler::handleProfileCommand(const std::string& input) {
+    Lexer lexer(input);
+    auto tokens = lexer.tokenize();
+
+    // Expect: PROFILE <path/pattern> [INTO <file>]
+    if (tokens.size() < 2 || tokens[1].type == TokenType::END_OF_INPUT) {
+        std::cerr << "Error: PROFILE command requires a path or pattern\n";
+        std::cerr << "Usage: PROFILE /path/to/corpus/\n";
+        std::cerr << "       PROFILE /path/to/*.xml INTO corpus.profile\n";
+        return true;
+    }
+
+    // Collect the pattern up to INTO, as CHECK does
+    std::string pattern;
+    size_t i = 1;
+    for (; i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT; ++i) {
+        if (!pattern.empty() && tokens[i].type == TokenType::IDENTIFIER &&
+            upperValue(tokens[i]) == "INTO" &&
+            tokens[i].position > tokens[i - 1].position + tokens[i - 1].value.size()) {
+            break;
+        }
+        if (!pattern.empty() &&
+            (tokens[i].type == TokenType::STRING_LITERAL ||
+             tokens[i - 1].type == TokenType::STRING_LITERAL)) {
+            pattern += " ";
+        }
+        pattern += tokens[i].value;
+    }
+
+    // Output file: quoted, or the raw text after INTO
+    std::string outputPath;
+    if (i < tokens.size() && tokens[i].type != TokenType::END_OF_INPUT) {
+        if (i + 1 >= tokens.size() || tokens[i + 1].type == TokenType::END_OF_INPUT) {
+            std::cerr << "Error: INTO requires a profile file\n";
+            return true;
+        }
+        if (tokens[i + 1].type == TokenType::STRING_LITERAL) {
+            outputPath = tokens[i + 1].value;
+        } else {
+            outputPath = input.substr(tokens[i + 1].position);
+            outputPath.erase(outputPath.find_last_not_of(" \t") + 1);
+        }
+    }
+
+    std::vector<std::string> files = XmlValidator::expandPattern(pattern);
+    if (files.empty()) {
+        std::cerr << "No XML files found matching pattern: " << pattern << "\n";
+        return true;
+    }
+
+    try {
+        CorpusSummary summary;
+        GenerationProfile profile = CorpusProfiler::profile(files, &summary);
+
+        std::ostringstream details;
+        details << std::fixed << std::setprecision(1) << summary.bytes / 1024.0 << " KB, "
+                << summary.paths << " paths";
+        if (summary.skipped > 0) {
+            details << ", " << summary.skipped << " unreadable file(s) skipped";
+        }
+        std::cout << "Profiled " << summary.files << " file(s) (" << details.str() << ")\n";
+
+        if (outputPath.empty()) {
+            std::cout << "\n" << profile.toString();
+        } else {
+            profile.save(outputPath);
+            std::cout << "Profile written to: " << outputPath << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error profiling corpus: " << e.what() << "\n";
+    }
+
+    return true;
+}
+
 bool CommandHandler::handleCheckCommand(const std::string& input) {
     Lexer lexer(input);
     auto tokens = lexer.tokenize();
@@ -343,6 +736,7 @@ bool CommandHandler::handleCheckCommand(const std::string& input) {
         std::cerr << "Usage: CHECK /path/to/file.xml\n";
         std::cerr << "       CHECK /path/to/directory/\n";
         std::cerr << "       CHECK /path/to/*.xml\n";
+        std::cerr << "       CHECK STREAM /path/to/huge.xml\n";
         return true;
     }
 
@@ -352,9 +746,19 @@ bool CommandHandler::handleCheckCommand(const std::string& input) {
         return true;
     }
 
+    // Optional STREAM keyword: validate while reading instead of loading a DOM
+    size_t firstPathToken = 1;
+    bool forceStreaming = false;
+    if (tokens.size() > 2 && tokens[1].type == TokenType::IDENTIFIER &&
+        upperValue(tokens[1]) == "STREAM" && tokens[2].type != TokenType::END_OF_INPUT &&
+        tokens[2].position > tokens[1].position + tokens[1].value.size()) {
+        forceStreaming = true;
+        firstPathToken = 2;
+    }
+
     // Collect path from remaining tokens
     std::string pattern;
-    for (size_t i = 1; i < tokens.size(); ++i) {
+    for (size_t i = firstPathToken; i < tokens.size(); ++i) {
         if (tokens[i].type == TokenType::END_OF_INPUT) {
             break;
         }
@@ -391,15 +795,12 @@ bool CommandHandler::handleCheckCommand(const std::string& input) {
     std::cout << "\nValidating " << files.size() << " file(s) against XSD: "
               << xsdPath << "\n\n";
 
-    // Validate all files
-    XmlValidator validator;
-    auto results = validator.validateFiles(files, xsdPath);
-
-    // Display results
+    // Validate all files: the schema is parsed once and files are checked
+    // in parallel, with results printed in order as they complete
     int validCount = 0;
     int invalidCount = 0;
 
-    for (const auto& [filename, result] : results) {
+    auto printResult = [&](const std::string& filename, const ValidationResult& result) {
         // Get just the filename for cleaner display
         std::filesystem::path p(filename);
         std::string displayName = p.filename().string();
@@ -428,6 +829,9 @@ bool CommandHandler::handleCheckCommand(const std::string& input) {
                 if (!error.path.empty()) {
                     std::cout << " at " << error.path;
                 }
+                if (error.line >= 0) {
+                    std::cout << " (line " << error.line << ")";
+                }
                 std::cout << "\n";
             }
 
@@ -438,6 +842,32 @@ bool CommandHandler::handleCheckCommand(const std::string& input) {
                 }
             }
         }
+    };
+
+    size_t threadCount = QueryExecutor::shouldUseThreading(files.size())
+        ? QueryExecutor::getOptimalThreadCount() : 1;
+
+    XmlValidator validator;
+    if (forceStreaming) {
+        validator.setStreamingThreshold(0);
+    }
+
+    // Verdicts of files unchanged since an earlier CHECK come from the cache
+    std::unique_ptr<ValidationCache> cache;
+    std::string cacheDir = ValidationCache::cacheDirectory();
+    if (!cacheDir.empty()) {
+        try {
+            cache = std::make_unique<ValidationCache>(
+                cacheDir, validator.resultKey(*CompiledSchema::load(xsdPath)));
+            validator.setCache(cache.get());
+        } catch (const std::exception&) {
+            // validateFiles() reports the schema error for every file
+        }
+    }
+
+    validator.validateFiles(files, xsdPath, printResult, threadCount);
+    if (cache) {
+        cache->save();
     }
 
     // Summary
@@ -448,6 +878,9 @@ bool CommandHandler::handleCheckCommand(const std::string& input) {
         int errorCount = files.size() - validCount - invalidCount;
         std::cout << ", " << errorCount << " error(s)";
     }
+    if (cache && cache->hits() > 0) {
+        std::cout << " (" << cache->hits() << " unchanged since the last CHECK)";
+    }
     std::cout << "\n";
 
     return true;
@@ -0,0 +1,218 @@
+#include "utils/slow_query_log.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace expocli {
+
+namespace {
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 8);
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::ostringstream hex;
+                    hex << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    out += hex.str();
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+std::string SlowQueryLog::defaultPath() {
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && *home != '\0') {
+        return std::string(home) + "/.expocli_slow_queries.log";
+    }
+    return ".expocli_slow_queries.log";
+}
+
+std::string SlowQueryLog::normalizeQuery(const std::string& query) {
+    std::string out;
+    std::string lastWord;      // Last identifier/keyword seen (uppercased)
+    bool keepNextPath = false; // FROM target is kept verbatim
+    size_t i = 0;
+
+    auto emitSpace = [&]() {
+        if (!out.empty() && out.back() != ' ') out += ' ';
+    };
+
+    while (i < query.size()) {
+        char c = query[i];
+
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            emitSpace();
+            ++i;
+            continue;
+        }
+
+        // FROM <path>: keep the path so queries on different data stay distinct
+        if (keepNextPath) {
+            keepNextPath = false;
+            size_t end = i;
+            if (c == '"' || c == '\'') {
+                end = query.find(c, i + 1);
+                end = (end == std::string::npos) ? query.size() : end + 1;
+            } else {
+                while (end < query.size() && !std::isspace(static_cast<unsigned char>(query[end]))) ++end;
+            }
+            out += query.substr(i, end - i);
+            i = end;
+            continue;
+        }
+
+        // String literals
+        if (c == '"' || c == '\'') {
+            size_t end = query.find(c, i + 1);
+            i = (end == std::string::npos) ? query.size() : end + 1;
+            out += '?';
+            lastWord.clear();
+            continue;
+        }
+
+        // LIKE /regex/
+        if (c == '/' && (lastWord == "LIKE")) {
+            size_t end = i + 1;
+            while (end < query.size() && query[end] != '/') {
+                if (query[end] == '\\') ++end;
+                ++end;
+            }
+            i = std::min(query.size(), end + 1);
+            out += "/?/";
+            lastWord.clear();
+            continue;
+        }
+
+        // Numeric literals (not part of an identifier or path component)
+        bool prevIsWordChar = !out.empty() && (isIdentifierChar(out.back()) || out.back() == '.' || out.back() == '/');
+        if (std::isdigit(static_cast<unsigned char>(c)) && !prevIsWordChar) {
+            size_t end = i;
+            while (end < query.size() && (std::isdigit(static_cast<unsigned char>(query[end])) || query[end] == '.')) ++end;
+            if (end >= query.size() || !isIdentifierChar(query[end])) {
+                out += '?';
+                i = end;
+                lastWord.clear();
+                continue;
+            }
+        }
+
+        // Identifiers and keywords
+        if (isIdentifierChar(c)) {
+            size_t end = i;
+            while (end < query.size() && isIdentifierChar(query[end])) ++end;
+            std::string word = query.substr(i, end - i);
+            out += word;
+            lastWord = word;
+            for (char& w : lastWord) w = static_cast<char>(std::toupper(static_cast<unsigned char>(w)));
+            if (lastWord == "FROM") {
+                keepNextPath = true;
+            }
+            i = end;
+            continue;
+        }
+
+        out += c;
+        if (c != ' ') lastWord.clear();
+        ++i;
+    }
+
+    // Trim trailing space and semicolon
+    while (!out.empty() && (out.back() == ' ' || out.back() == ';')) out.pop_back();
+
+    // Collapse IN lists of any length: (?, ?, ?) -> (?)
+    std::string collapsed;
+    for (size_t p = 0; p < out.size(); ++p) {
+        if (out[p] == '(' && p + 1 < out.size() && out[p + 1] == '?') {
+            size_t q = p + 2;
+            bool onlyPlaceholders = true;
+            while (q < out.size() && out[q] != ')') {
+                if (out[q] != '?' && out[q] != ',' && out[q] != ' ') {
+                    onlyPlaceholders = false;
+                    break;
+                }
+                ++q;
+            }
+            if (onlyPlaceholders && q < out.size()) {
+                collapsed += "(?)";
+                p = q;
+                continue;
+            }
+        }
+        collapsed += out[p];
+    }
+    return collapsed;
+}
+
+void SlowQueryLog::append(
+    const std::string& path,
+    const std::string& query,
+    double totalMs,
+    const ExecutionStats& stats
+) {
+    std::ofstream out(path, std::ios::app);
+    if (!out) {
+        throw std::runtime_error("Cannot write slow query log: " + path);
+    }
+
+    auto now = std::chrono::system_clock::now();
+    long long timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count();
+
+    std::ostringstream record;
+    record << std::fixed << std::setprecision(3);
+    record << "{\"timestamp_ms\": " << timestampMs
+           << ", \"total_ms\": " << totalMs
+           << ", \"query\": \"" << jsonEscape(query) << "\""
+           << ", \"normalized\": \"" << jsonEscape(normalizeQuery(query)) << "\""
+           << ", \"plan\": \"" << jsonEscape(stats.plan) << "\""
+           << ", \"files\": " << stats.total_files
+           << ", \"threads\": " << stats.thread_count
+           << ", \"rows\": " << stats.result_rows
+           << ", \"parse_ms_total\": " << stats.total_parse_ms
+           << ", \"eval_ms_total\": " << stats.total_eval_ms;
+
+    record << ", \"stages\": {";
+    for (size_t i = 0; i < stats.stages.size(); ++i) {
+        if (i > 0) record << ", ";
+        record << "\"" << jsonEscape(stats.stages[i].name) << "\": " << stats.stages[i].ms;
+    }
+    record << "}";
+
+    record << ", \"top_files\": [";
+    for (size_t i = 0; i < stats.top_files.size(); ++i) {
+        const auto& f = stats.top_files[i];
+        if (i > 0) record << ", ";
+        record << "{\"path\": \"" << jsonEscape(f.path) << "\""
+               << ", \"bytes\": " << f.bytes
+               << ", \"parse_ms\": " << f.parse_ms
+               << ", \"eval_ms\": " << f.eval_ms
+               << ", \"rows\": " << f.rows << "}";
+    }
+    record << "]}";
+
+    out << record.str() << "\n";
+}
+
+} // namespace expocli
@@ -0,0 +1,183 @@
+#include "utils/temporal.h"
+
+namespace expocli {
+
+namespace {
+
+constexpr int64_t kMicrosPerSecond = 1000000;
+constexpr int64_t kMicrosPerDay = 86400 * kMicrosPerSecond;
+
+// Reads exactly `count` digits
+bool readDigits(const char* text, size_t length, size_t& pos, size_t count, int& value) {
+    if (pos + count > length) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        unsigned digit = static_cast<unsigned char>(text[pos + i]) - '0';
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + static_cast<int>(digit);
+    }
+    pos += count;
+    return true;
+}
+
+// Days from 1970-01-01 to the given proleptic Gregorian date
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+bool isLeapYear(int64_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// [-]YYYY[Y...]-MM-DD, returning days since the epoch
+bool readDate(const char* text, size_t length, size_t& pos, int64_t& days) {
+    bool negative = pos < length && text[pos] == '-';
+    if (negative) {
+        ++pos;
+    }
+
+    // Four or five year digits: microseconds since the epoch stay within int64
+    int64_t year = 0;
+    size_t yearDigits = 0;
+    while (pos < length && text[pos] >= '0' && text[pos] <= '9') {
+        year = year * 10 + (text[pos] - '0');
+        ++pos;
+        if (++yearDigits > 5) {
+            return false;
+        }
+    }
+    if (yearDigits < 4) {
+        return false;
+    }
+    if (negative) {
+        year = -year;
+    }
+
+    int month = 0;
+    int day = 0;
+    if (pos >= length || text[pos++] != '-' || !readDigits(text, length, pos, 2, month) ||
+        pos >= length || text[pos++] != '-' || !readDigits(text, length, pos, 2, day)) {
+        return false;
+    }
+
+    static const int kDaysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12) {
+        return false;
+    }
+    int monthDays = kDaysInMonth[month - 1] + (month == 2 && isLeapYear(year) ? 1 : 0);
+    if (day < 1 || day > monthDays) {
+        return false;
+    }
+
+    days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return true;
+}
+
+// Optional Z or (+|-)hh:mm at the end of the value, as an offset from UTC
+bool readZone(const char* text, size_t length, size_t& pos, int64_t& offsetMicros) {
+    offsetMicros = 0;
+    if (pos == length) {
+        return true;
+    }
+    if (text[pos] == 'Z') {
+        return ++pos == length;
+    }
+    if (text[pos] != '+' && text[pos] != '-') {
+        return false;
+    }
+    int sign = text[pos++] == '-' ? -1 : 1;
+    int hours = 0;
+    int minutes = 0;
+    if (!readDigits(text, length, pos, 2, hours) || pos >= length || text[pos++] != ':' ||
+        !readDigits(text, length, pos, 2, minutes) || pos != length) {
+        return false;
+    }
+    if (hours > 14 || minutes > 59 || (hours == 14 && minutes != 0)) {
+        return false;
+    }
+    offsetMicros = sign * (hours * 3600 + minutes * 60) * kMicrosPerSecond;
+    return true;
+}
+
+} // namespace
+
+bool Temporal::parseDate(const char* text, size_t length, int64_t& micros) {
+    size_t pos = 0;
+    int64_t days = 0;
+    int64_t offset = 0;
+    if (!readDate(text, length, pos, days) || !readZone(text, length, pos, offset)) {
+        return false;
+    }
+    micros = days * kMicrosPerDay - offset;
+    return true;
+}
+
+bool Temporal::parseDateTime(const char* text, size_t length, int64_t& micros) {
+    size_t pos = 0;
+    int64_t days = 0;
+    if (!readDate(text, length, pos, days) || pos >= length || text[pos++] != 'T') {
+        return false;
+    }
+
+    int hours = 0;
+    int minutes = 0;
+    int seconds = 0;
+    if (!readDigits(text, length, pos, 2, hours) || pos >= length || text[pos++] != ':' ||
+        !readDigits(text, length, pos, 2, minutes) || pos >= length || text[pos++] != ':' ||
+        !readDigits(text, length, pos, 2, seconds)) {
+        return false;
+    }
+
+    // Fraction: microsecond precision, extra digits are truncated
+    int64_t fraction = 0;
+    if (pos < length && text[pos] == '.') {
+        ++pos;
+        size_t digits = 0;
+        int64_t scale = 100000;
+        while (pos < length && text[pos] >= '0' && text[pos] <= '9') {
+            fraction += (text[pos] - '0') * scale;
+            scale /= 10;
+            ++pos;
+            ++digits;
+        }
+        if (digits == 0) {
+            return false;
+        }
+    }
+
+    // 24:00:00 is the end of the day
+    bool endOfDay = hours == 24 && minutes == 0 && seconds == 0 && fraction == 0;
+    if ((hours > 23 && !endOfDay) || minutes > 59 || seconds > 59) {
+        return false;
+    }
+
+    int64_t offset = 0;
+    if (!readZone(text, length, pos, offset)) {
+        return false;
+    }
+
+    micros = days * kMicrosPerDay +
+             (hours * 3600 + minutes * 60 + seconds) * kMicrosPerSecond + fraction - offset;
+    return true;
+}
+
+bool Temporal::parse(const char* text, size_t length, int64_t& micros) {
+    // A date-time has a 'T' after the date
+    for (size_t i = 0; i < length; ++i) {
+        if (text[i] == 'T') {
+            return parseDateTime(text, length, micros);
+        }
+    }
+    return parseDate(text, length, micros);
+}
+
+} // namespace expocli
@@ -0,0 +1,263 @@
+#include "utils/workload.h"
+#include "parser/lexer.h"
+#include "parser/parser.h"
+#include "executor/query_executor.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace expocli {
+
+namespace {
+
+const char* kWorkloadHeader = "# expocli workload v1";
+const char* kWorkloadColumns = "# timestamp_ms\toffset_ms\telapsed_ms\trows\tfiles\tstatus\tquery";
+
+// Keep one query per line: tabs and newlines become spaces
+std::string sanitizeQuery(const std::string& query) {
+    std::string result = query;
+    for (char& c : result) {
+        if (c == '\t' || c == '\n' || c == '\r') {
+            c = ' ';
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> splitTabs(const std::string& line, size_t maxFields) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (fields.size() + 1 < maxFields) {
+        size_t tab = line.find('\t', start);
+        if (tab == std::string::npos) break;
+        fields.push_back(line.substr(start, tab - start));
+        start = tab + 1;
+    }
+    fields.push_back(line.substr(start));  // Last field keeps any remaining text
+    return fields;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+    return values[std::min(values.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+} // anonymous namespace
+
+void WorkloadRecorder::open(const std::string& path) {
+    std::ifstream existing(path);
+    bool isNew = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+    existing.close();
+
+    out_.open(path, std::ios::app);
+    if (!out_) {
+        throw std::runtime_error("Cannot open workload file for writing: " + path);
+    }
+    if (isNew) {
+        out_ << kWorkloadHeader << "\n" << kWorkloadColumns << "\n";
+        out_.flush();
+    }
+
+    path_ = path;
+    start_ = std::chrono::steady_clock::now();
+}
+
+void WorkloadRecorder::record(WorkloadEntry entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.is_open()) {
+        return;
+    }
+
+    // Entries are recorded after execution; back-date to submission time
+    auto now = std::chrono::system_clock::now();
+    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count();
+    entry.timestamp_ms = nowMs - static_cast<int64_t>(entry.elapsed_ms);
+
+    std::chrono::duration<double, std::milli> sinceStart = std::chrono::steady_clock::now() - start_;
+    entry.offset_ms = std::max(0.0, sinceStart.count() - entry.elapsed_ms);
+
+    out_ << entry.timestamp_ms << "\t"
+         << std::fixed << std::setprecision(3) << entry.offset_ms << "\t"
+         << entry.elapsed_ms << "\t"
+         << entry.rows << "\t"
+         << entry.files << "\t"
+         << (entry.ok ? "ok" : "error") << "\t"
+         << sanitizeQuery(entry.query) << "\n";
+    out_.flush();  // Keep the log usable if the session is killed
+}
+
+std::vector<WorkloadEntry> WorkloadReplayer::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open workload file: " + path);
+    }
+
+    std::vector<WorkloadEntry> entries;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        auto fields = splitTabs(line, 7);
+        if (fields.size() != 7) {
+            throw std::runtime_error("Malformed workload line " + std::to_string(lineNumber) +
+                                     " in " + path);
+        }
+
+        try {
+            WorkloadEntry entry;
+            entry.timestamp_ms = std::stoll(fields[0]);
+            entry.offset_ms = std::stod(fields[1]);
+            entry.elapsed_ms = std::stod(fields[2]);
+            entry.rows = std::stoul(fields[3]);
+            entry.files = std::stoul(fields[4]);
+            entry.ok = (fields[5] == "ok");
+            entry.query = fields[6];
+            entries.push_back(entry);
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("Malformed workload line " + std::to_string(lineNumber) +
+                                     " in " + path);
+        }
+    }
+
+    return entries;
+}
+
+std::vector<ReplayResult> WorkloadReplayer::replay(
+    const std::vector<WorkloadEntry>& entries,
+    const ReplayOptions& options
+) {
+    std::vector<ReplayResult> results(entries.size());
+
+    // Scheduled start of each entry relative to replay start. Offsets restart
+    // at zero for each captured session, so only forward gaps are kept.
+    std::vector<double> scheduleMs(entries.size(), 0.0);
+    if (options.speed > 0) {
+        for (size_t i = 1; i < entries.size(); ++i) {
+            double gap = std::max(0.0, entries[i].offset_ms - entries[i - 1].offset_ms);
+            scheduleMs[i] = scheduleMs[i - 1] + gap / options.speed;
+        }
+    }
+
+    std::atomic<size_t> next{0};
+    auto replayStart = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        while (true) {
+            size_t i = next.fetch_add(1);
+            if (i >= entries.size()) {
+                break;
+            }
+
+            if (options.speed > 0) {
+                auto due = replayStart + std::chrono::microseconds(
+                    static_cast<int64_t>(scheduleMs[i] * 1000.0));
+                std::this_thread::sleep_until(due);
+            }
+
+            ReplayResult& result = results[i];
+            result.recorded = entries[i];
+
+            auto start = std::chrono::steady_clock::now();
+            try {
+                Lexer lexer(entries[i].query);
+                auto tokens = lexer.tokenize();
+                Parser parser(tokens);
+                auto ast = parser.parse();
+                auto rows = QueryExecutor::execute(*ast, nullptr, options.limits);
+                result.rows = rows.size();
+            } catch (const std::exception& e) {
+                result.ok = false;
+                result.error = e.what();
+            }
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            result.elapsed_ms = elapsed.count();
+        }
+    };
+
+    size_t threadCount = std::max<size_t>(1, std::min(options.concurrency, entries.size()));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return results;
+}
+
+void WorkloadReplayer::printReport(const std::vector<ReplayResult>& results, double wallSeconds) {
+    std::cout << std::left << std::setw(6) << "#" << std::right
+              << std::setw(14) << "recorded ms"
+              << std::setw(14) << "replay ms"
+              << std::setw(12) << "delta ms"
+              << std::setw(10) << "delta %"
+              << std::setw(10) << "rows" << "  query\n";
+    std::cout << std::string(100, '-') << "\n";
+
+    double totalRecorded = 0.0;
+    double totalReplay = 0.0;
+    size_t errors = 0;
+    size_t rowMismatches = 0;
+    std::vector<double> replayLatencies;
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        double delta = r.elapsed_ms - r.recorded.elapsed_ms;
+        double deltaPct = r.recorded.elapsed_ms > 0 ? (delta / r.recorded.elapsed_ms) * 100.0 : 0.0;
+        bool rowsDiffer = r.ok && r.recorded.ok && r.rows != r.recorded.rows;
+
+        totalRecorded += r.recorded.elapsed_ms;
+        totalReplay += r.elapsed_ms;
+        replayLatencies.push_back(r.elapsed_ms);
+        if (!r.ok) ++errors;
+        if (rowsDiffer) ++rowMismatches;
+
+        std::string query = r.recorded.query;
+        if (query.length() > 50) {
+            query = query.substr(0, 47) + "...";
+        }
+
+        std::ostringstream rows;
+        rows << r.rows << (rowsDiffer ? "*" : "");
+
+        std::cout << std::left << std::setw(6) << (i + 1) << std::right
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(14) << r.recorded.elapsed_ms
+                  << std::setw(14) << r.elapsed_ms
+                  << std::setw(12) << std::showpos << delta << std::noshowpos
+                  << std::setw(9) << std::showpos << deltaPct << std::noshowpos << "%"
+                  << std::setw(10) << (r.ok ? rows.str() : "ERROR")
+                  << "  " << query << "\n";
+    }
+
+    std::cout << "\n";
+    std::cout << "Queries:          " << results.size() << "\n";
+    std::cout << "Errors:           " << errors << "\n";
+    std::cout << "Row mismatches:   " << rowMismatches << (rowMismatches > 0 ? " (marked *)" : "") << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Recorded total:   " << totalRecorded << " ms\n";
+    std::cout << "Replay total:     " << totalReplay << " ms";
+    if (totalRecorded > 0) {
+        std::cout << " (" << std::showpos << ((totalReplay - totalRecorded) / totalRecorded) * 100.0
+                  << std::noshowpos << "%)";
+    }
+    std::cout << "\n";
+    std::cout << "Replay p50 / p99: " << percentile(replayLatencies, 0.50) << " / "
+              << percentile(replayLatencies, 0.99) << " ms\n";
+    std::cout << "Wall time:        " << wallSeconds << " s\n";
+}
+
+} // namespace expocli
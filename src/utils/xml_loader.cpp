@@ -1,5 +1,6 @@
 #include "utils/xml_loader.h"
 #include <algorithm>
+#include <fstream>
 
 namespace expocli {
 
@@ -16,6 +17,35 @@ std::unique_ptr<pugi::xml_document> XmlLoader::load(const std::string& filepath)
     return doc;
 }
 
+std::string XmlLoader::readFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Failed to load XML file: " + filepath +
+                               "\nError: File was not found");
+    }
+
+    std::string bytes(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    if (!file.read(&bytes[0], static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Failed to load XML file: " + filepath +
+                               "\nError: Error reading from file/stream");
+    }
+    return bytes;
+}
+
+std::unique_ptr<pugi::xml_document> XmlLoader::load(const std::string& filepath, const std::string& bytes) {
+    auto doc = std::make_unique<pugi::xml_document>();
+
+    pugi::xml_parse_result result = doc->load_buffer(bytes.data(), bytes.size());
+
+    if (!result) {
+        throw std::runtime_error("Failed to load XML file: " + filepath +
+                               "\nError: " + result.description());
+    }
+
+    return doc;
+}
+
 bool XmlLoader::isXmlFile(const std::string& filepath) {
     // Check file extension
     if (filepath.length() < 4) return false;
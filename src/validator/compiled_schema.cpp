@@ -0,0 +1,648 @@
+#include "validator/compiled_schema.h"
+#include "generator/xsd_parser.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace expocli {
+
+// Translates the shared_ptr tree produced by XsdParser into flat tables
+class CompiledSchemaBuilder {
+public:
+    explicit CompiledSchemaBuilder(CompiledSchema& out) : out_(out) {}
+
+    uint32_t addElement(const std::shared_ptr<XsdElement>& element) {
+        uint32_t index = static_cast<uint32_t>(out_.elements_.size());
+        out_.elements_.emplace_back();
+        out_.elements_[index] = makeElement(*element);
+        return index;
+    }
+
+private:
+    CompiledElement makeElement(const XsdElement& element) {
+        CompiledElement compiled;
+        compiled.name = intern(element.name);
+        compiled.type = element.type;
+        compiled.minOccurs = element.minOccurs;
+        compiled.maxOccurs = element.maxOccurs;
+        compiled.contentType = compileContentType(element);
+        return compiled;
+    }
+
+    // Named types are cloned per element by the parser but share their child
+    // and attribute declarations, so the first child pointer identifies the
+    // content model. Elements without children are compiled individually.
+    uint32_t compileContentType(const XsdElement& element) {
+        const void* key = nullptr;
+        if (!element.children.empty()) {
+            key = element.children.front().get();
+        } else if (!element.attributes.empty()) {
+            key = element.attributes.front().get();
+        }
+        if (key != nullptr) {
+            auto it = memo_.find(key);
+            if (it != memo_.end() && sameDeclarations(element, it->second.first)) {
+                return it->second.second;
+            }
+        }
+
+        uint32_t typeIndex = static_cast<uint32_t>(out_.contentTypes_.size());
+        out_.contentTypes_.emplace_back();
+        if (key != nullptr) {
+            memo_[key] = {&element, typeIndex};  // Registered first so recursive models terminate
+        }
+
+        // Attributes: first declaration of a name wins
+        CompiledContentType type;
+        type.firstAttribute = static_cast<uint32_t>(out_.attributes_.size());
+        std::vector<uint32_t> attributeNames;
+        for (const auto& attr : element.attributes) {
+            uint32_t nameId = intern(attr->name);
+            bool duplicate = false;
+            for (uint32_t existing : attributeNames) {
+                duplicate = duplicate || existing == nameId;
+            }
+            if (duplicate) {
+                continue;
+            }
+            attributeNames.push_back(nameId);
+            out_.attributes_.push_back({nameId, attr->type, !attr->isOptional()});
+        }
+        type.attributeCount = static_cast<uint32_t>(attributeNames.size());
+
+        // Children occupy a contiguous range; nested models are appended after it
+        type.firstChild = static_cast<uint32_t>(out_.elements_.size());
+        type.childCount = static_cast<uint32_t>(element.children.size());
+        out_.elements_.resize(out_.elements_.size() + element.children.size());
+        std::vector<uint32_t> childNames;
+        for (size_t i = 0; i < element.children.size(); ++i) {
+            CompiledElement child = makeElement(*element.children[i]);
+            out_.elements_[type.firstChild + i] = child;
+            childNames.push_back(child.name);
+        }
+
+        type.childLookup = buildHash(childNames);
+        type.attributeLookup = buildHash(attributeNames);
+        out_.contentTypes_[typeIndex] = type;
+        return typeIndex;
+    }
+
+    static bool sameDeclarations(const XsdElement& a, const XsdElement* b) {
+        return a.children.size() == b->children.size() &&
+               a.attributes.size() == b->attributes.size() &&
+               std::equal(a.children.begin(), a.children.end(), b->children.begin()) &&
+               std::equal(a.attributes.begin(), a.attributes.end(), b->attributes.begin());
+    }
+
+    uint32_t intern(const std::string& name) {
+        auto it = nameIds_.find(name);
+        if (it != nameIds_.end()) {
+            return it->second;
+        }
+        uint32_t id = static_cast<uint32_t>(out_.names_.size());
+        out_.names_.push_back(name);
+        nameIds_.emplace(name, id);
+        return id;
+    }
+
+    // Find a seed (growing the table if needed) that maps every distinct
+    // name to its own bucket. Repeated names resolve to their first slot.
+    PerfectHash buildHash(const std::vector<uint32_t>& nameIds) {
+        std::vector<uint32_t> distinct;
+        std::vector<int32_t> firstSlot;
+        for (size_t i = 0; i < nameIds.size(); ++i) {
+            bool seen = false;
+            for (uint32_t id : distinct) {
+                seen = seen || id == nameIds[i];
+            }
+            if (!seen) {
+                distinct.push_back(nameIds[i]);
+                firstSlot.push_back(static_cast<int32_t>(i));
+            }
+        }
+
+        uint32_t size = 1;
+        while (size < distinct.size()) {
+            size <<= 1;
+        }
+
+        std::vector<int32_t> table;
+        for (;; size <<= 1) {
+            for (uint32_t seed = 1; seed <= 64; ++seed) {
+                table.assign(size, -1);
+                bool collision = false;
+                for (size_t i = 0; i < distinct.size() && !collision; ++i) {
+                    const std::string& name = out_.names_[distinct[i]];
+                    uint32_t bucket = CompiledSchema::hashName(name.data(), name.size(), seed) & (size - 1);
+                    collision = table[bucket] >= 0;
+                    table[bucket] = firstSlot[i];
+                }
+                if (!collision) {
+                    PerfectHash hash;
+                    hash.offset = static_cast<uint32_t>(out_.slots_.size());
+                    hash.mask = size - 1;
+                    hash.seed = seed;
+                    out_.slots_.insert(out_.slots_.end(), table.begin(), table.end());
+                    return hash;
+                }
+            }
+            if (size > (1u << 24)) {
+                throw std::runtime_error("Cannot build name lookup table for schema");
+            }
+        }
+    }
+
+    CompiledSchema& out_;
+    std::unordered_map<std::string, uint32_t> nameIds_;
+    std::unordered_map<const void*, std::pair<const XsdElement*, uint32_t>> memo_;
+};
+
+std::unique_ptr<CompiledSchema> CompiledSchema::compile(const XsdSchema& schema) {
+    auto compiled = std::make_unique<CompiledSchema>();
+    auto root = schema.getRootElement();
+    if (!root) {
+        return compiled;
+    }
+
+    compiled->targetNamespace_ = schema.getTargetNamespace();
+    CompiledSchemaBuilder builder(*compiled);
+    compiled->rootIndex_ = builder.addElement(root);
+    compiled->hasRoot_ = true;
+    return compiled;
+}
+
+// Rebuilds the element tree, one children/attributes list per content type
+class SchemaRebuilder {
+public:
+    explicit SchemaRebuilder(const CompiledSchema& schema)
+        : schema_(schema), models_(schema.contentTypes_.size()) {}
+
+    std::shared_ptr<XsdElement> element(uint32_t index) {
+        const CompiledElement& decl = schema_.element(index);
+        auto element = std::make_shared<XsdElement>();
+        element->name = schema_.name(decl.name);
+        element->type = decl.type;
+        element->minOccurs = decl.minOccurs;
+        element->maxOccurs = decl.maxOccurs;
+        const Model& model = buildModel(decl.contentType);
+        element->children = model.children;
+        element->attributes = model.attributes;
+        return element;
+    }
+
+private:
+    struct Model {
+        bool built = false;
+        std::vector<std::shared_ptr<XsdElement>> children;
+        std::vector<std::shared_ptr<XsdElement>> attributes;
+    };
+
+    const Model& buildModel(uint32_t typeIndex) {
+        if (models_[typeIndex].built) {
+            return models_[typeIndex];
+        }
+        models_[typeIndex].built = true;  // Guards against recursive models
+
+        const CompiledContentType& type = schema_.contentType(typeIndex);
+        Model model;
+        model.built = true;
+        for (uint32_t i = 0; i < type.attributeCount; ++i) {
+            const CompiledAttribute& decl = schema_.attribute(type.firstAttribute + i);
+            auto attr = std::make_shared<XsdElement>();
+            attr->name = schema_.name(decl.name);
+            attr->type = decl.type;
+            attr->isAttribute = true;
+            attr->minOccurs = decl.required ? 1 : 0;
+            model.attributes.push_back(attr);
+        }
+        for (uint32_t i = 0; i < type.childCount; ++i) {
+            model.children.push_back(element(type.firstChild + i));
+        }
+        models_[typeIndex] = std::move(model);
+        return models_[typeIndex];
+    }
+
+    const CompiledSchema& schema_;
+    std::vector<Model> models_;
+};
+
+std::unique_ptr<XsdSchema> CompiledSchema::toSchema() const {
+    auto schema = std::make_unique<XsdSchema>();
+    schema->setTargetNamespace(targetNamespace_);
+    if (hasRoot_) {
+        SchemaRebuilder rebuilder(*this);
+        schema->setRootElement(rebuilder.element(rootIndex_));
+    }
+    return schema;
+}
+
+namespace {
+
+constexpr char kImageMagic[8] = {'E', 'X', 'P', 'O', 'X', 'S', 'D', 'C'};
+constexpr uint32_t kImageVersion = 1;
+
+// Fixed-width fields in host byte order: images are local cache files
+class ImageWriter {
+public:
+    explicit ImageWriter(std::string& out) : out_(out) {}
+
+    void u32(uint32_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+    void str(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        out_.append(value);
+    }
+
+private:
+    std::string& out_;
+};
+
+class ImageReader {
+public:
+    explicit ImageReader(const std::string& in, size_t pos) : in_(in), pos_(pos) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == in_.size(); }
+
+    uint32_t u32() {
+        uint32_t value = 0;
+        if (!take(sizeof(value))) {
+            return 0;
+        }
+        std::memcpy(&value, in_.data() + pos_ - sizeof(value), sizeof(value));
+        return value;
+    }
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+    std::string str() {
+        uint32_t length = u32();
+        if (!take(length)) {
+            return std::string();
+        }
+        return in_.substr(pos_ - length, length);
+    }
+
+    // Element count of a table whose entries take at least entrySize bytes
+    uint32_t count(size_t entrySize) {
+        uint32_t n = u32();
+        if (n > (in_.size() - pos_) / entrySize) {
+            ok_ = false;
+            return 0;
+        }
+        return n;
+    }
+
+private:
+    bool take(size_t length) {
+        if (!ok_ || length > in_.size() - pos_) {
+            ok_ = false;
+            return false;
+        }
+        pos_ += length;
+        return true;
+    }
+
+    const std::string& in_;
+    size_t pos_;
+    bool ok_ = true;
+};
+
+bool validHash(const PerfectHash& hash, size_t slotCount) {
+    uint64_t size = static_cast<uint64_t>(hash.mask) + 1;
+    return (size & (size - 1)) == 0 && hash.offset <= slotCount && size <= slotCount - hash.offset;
+}
+
+} // namespace
+
+std::string CompiledSchema::serialize() const {
+    std::string out(kImageMagic, sizeof(kImageMagic));
+    ImageWriter writer(out);
+    writer.u32(kImageVersion);
+    writer.str(targetNamespace_);
+    writer.u32(hasRoot_ ? 1 : 0);
+    writer.u32(rootIndex_);
+
+    writer.u32(static_cast<uint32_t>(names_.size()));
+    for (const auto& name : names_) {
+        writer.str(name);
+    }
+    writer.u32(static_cast<uint32_t>(elements_.size()));
+    for (const auto& element : elements_) {
+        writer.u32(element.name);
+        writer.u32(static_cast<uint32_t>(element.type));
+        writer.i32(element.minOccurs);
+        writer.i32(element.maxOccurs);
+        writer.u32(element.contentType);
+    }
+    writer.u32(static_cast<uint32_t>(attributes_.size()));
+    for (const auto& attr : attributes_) {
+        writer.u32(attr.name);
+        writer.u32(static_cast<uint32_t>(attr.type));
+        writer.u32(attr.required ? 1 : 0);
+    }
+    writer.u32(static_cast<uint32_t>(contentTypes_.size()));
+    for (const auto& type : contentTypes_) {
+        writer.u32(type.firstChild);
+        writer.u32(type.childCount);
+        writer.u32(type.firstAttribute);
+        writer.u32(type.attributeCount);
+        for (const PerfectHash* hash : {&type.childLookup, &type.attributeLookup}) {
+            writer.u32(hash->offset);
+            writer.u32(hash->mask);
+            writer.u32(hash->seed);
+        }
+    }
+    writer.u32(static_cast<uint32_t>(slots_.size()));
+    for (int32_t slot : slots_) {
+        writer.i32(slot);
+    }
+    return out;
+}
+
+std::unique_ptr<CompiledSchema> CompiledSchema::deserialize(const std::string& data) {
+    if (data.size() < sizeof(kImageMagic) ||
+        std::memcmp(data.data(), kImageMagic, sizeof(kImageMagic)) != 0) {
+        return nullptr;
+    }
+    ImageReader reader(data, sizeof(kImageMagic));
+    if (reader.u32() != kImageVersion) {
+        return nullptr;
+    }
+
+    auto schema = std::make_unique<CompiledSchema>();
+    schema->targetNamespace_ = reader.str();
+    schema->hasRoot_ = reader.u32() != 0;
+    schema->rootIndex_ = reader.u32();
+
+    schema->names_.resize(reader.count(4));
+    for (auto& name : schema->names_) {
+        name = reader.str();
+    }
+    schema->elements_.resize(reader.count(20));
+    for (auto& element : schema->elements_) {
+        element.name = reader.u32();
+        element.type = static_cast<XsdType>(reader.u32());
+        element.minOccurs = reader.i32();
+        element.maxOccurs = reader.i32();
+        element.contentType = reader.u32();
+    }
+    schema->attributes_.resize(reader.count(12));
+    for (auto& attr : schema->attributes_) {
+        attr.name = reader.u32();
+        attr.type = static_cast<XsdType>(reader.u32());
+        attr.required = reader.u32() != 0;
+    }
+    schema->contentTypes_.resize(reader.count(40));
+    for (auto& type : schema->contentTypes_) {
+        type.firstChild = reader.u32();
+        type.childCount = reader.u32();
+        type.firstAttribute = reader.u32();
+        type.attributeCount = reader.u32();
+        for (PerfectHash* hash : {&type.childLookup, &type.attributeLookup}) {
+            hash->offset = reader.u32();
+            hash->mask = reader.u32();
+            hash->seed = reader.u32();
+        }
+    }
+    schema->slots_.resize(reader.count(4));
+    for (auto& slot : schema->slots_) {
+        slot = reader.i32();
+    }
+    if (!reader.ok() || !reader.atEnd()) {
+        return nullptr;
+    }
+
+    // Every index must stay in range: lookups do not bounds-check
+    const size_t nameCount = schema->names_.size();
+    const size_t elementCount = schema->elements_.size();
+    const size_t attributeCount = schema->attributes_.size();
+    const size_t slotCount = schema->slots_.size();
+    if (schema->hasRoot_ && schema->rootIndex_ >= elementCount) {
+        return nullptr;
+    }
+    for (const auto& element : schema->elements_) {
+        if (element.name >= nameCount || element.contentType >= schema->contentTypes_.size() ||
+            static_cast<uint32_t>(element.type) > static_cast<uint32_t>(XsdType::COMPLEX)) {
+            return nullptr;
+        }
+    }
+    for (const auto& attr : schema->attributes_) {
+        if (attr.name >= nameCount ||
+            static_cast<uint32_t>(attr.type) > static_cast<uint32_t>(XsdType::COMPLEX)) {
+            return nullptr;
+        }
+    }
+    for (const auto& type : schema->contentTypes_) {
+        if (type.firstChild > elementCount || type.childCount > elementCount - type.firstChild ||
+            type.firstAttribute > attributeCount ||
+            type.attributeCount > attributeCount - type.firstAttribute ||
+            !validHash(type.childLookup, slotCount) || !validHash(type.attributeLookup, slotCount)) {
+            return nullptr;
+        }
+        for (uint32_t i = 0; i <= type.childLookup.mask; ++i) {
+            int32_t slot = schema->slots_[type.childLookup.offset + i];
+            if (slot < -1 || slot >= static_cast<int64_t>(type.childCount)) {
+                return nullptr;
+            }
+        }
+        for (uint32_t i = 0; i <= type.attributeLookup.mask; ++i) {
+            int32_t slot = schema->slots_[type.attributeLookup.offset + i];
+            if (slot < -1 || slot >= static_cast<int64_t>(type.attributeCount)) {
+                return nullptr;
+            }
+        }
+    }
+    return schema;
+}
+
+uint64_t CompiledSchema::fingerprint() const {
+    std::string image = serialize();
+    uint64_t h = 14695981039346656037ull;
+    for (char c : image) {
+        h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+std::string CompiledSchema::cacheDirectory() {
+    if (const char* dir = std::getenv("EXPOCLI_SCHEMA_CACHE")) {
+        std::string value = dir;
+        return value == "off" || value == "OFF" ? std::string() : value;
+    }
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return (std::filesystem::path(xdg) / "expocli" / "schemas").string();
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return (std::filesystem::path(home) / ".cache" / "expocli" / "schemas").string();
+    }
+    return std::string();
+}
+
+namespace {
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    out.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    return static_cast<bool>(in.read(&out[0], static_cast<std::streamsize>(out.size())));
+}
+
+// 128-bit key over the content of every schema file (two independent
+// 64-bit lanes fed a word at a time). Paths are not part of the key: the
+// same schema set checked out elsewhere shares its cache entry.
+std::string contentKey(const std::vector<std::string>& files) {
+    uint64_t a = 14695981039346656037ull;
+    uint64_t b = 0x9E3779B97F4A7C15ull ^ kImageVersion;
+    auto mixWord = [&](uint64_t word) {
+        a = (a ^ word) * 0x100000001B3ull;
+        a ^= a >> 32;
+        b = (b + word + 1) * 0xBF58476D1CE4E5B9ull;
+        b ^= b >> 29;
+    };
+    auto feed = [&](const char* data, size_t length) {
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            mixWord(word);
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, length - i);
+        mixWord(tail ^ (static_cast<uint64_t>(length - i) << 56));
+    };
+
+    std::string content;
+    for (const auto& file : files) {
+        if (!readFile(file, content)) {
+            return std::string();
+        }
+        uint64_t length = content.size();
+        feed(reinterpret_cast<const char*>(&length), sizeof(length));
+        feed(content.data(), content.size());
+    }
+
+    char key[33];
+    std::snprintf(key, sizeof(key), "%016llx%016llx",
+                  static_cast<unsigned long long>(a), static_cast<unsigned long long>(b));
+    return key;
+}
+
+// Written to a temporary file first, so concurrent sessions never see a
+// partial image. Failures only cost a recompile next time.
+void storeImage(const std::filesystem::path& file, const std::string& image) {
+    std::error_code ec;
+    std::filesystem::create_directories(file.parent_path(), ec);
+    if (ec) {
+        return;
+    }
+    std::filesystem::path temp = file;
+    temp += ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.write(image.data(), static_cast<std::streamsize>(image.size()))) {
+            out.close();
+            std::filesystem::remove(temp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temp, file, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const CompiledSchema> CompiledSchema::load(const std::string& xsdFile,
+                                                           LoadSource* source) {
+    struct Stamp {
+        std::string path;
+        std::filesystem::file_time_type mtime;
+        uintmax_t size;
+    };
+    struct Entry {
+        std::vector<Stamp> files;
+        std::shared_ptr<const CompiledSchema> schema;
+    };
+    static std::mutex cacheMutex;
+    static std::map<std::string, Entry> cache;
+
+    auto stamp = [](const std::string& path, Stamp& out) {
+        std::error_code ec;
+        out.path = path;
+        out.mtime = std::filesystem::last_write_time(path, ec);
+        out.size = ec ? 0 : std::filesystem::file_size(path, ec);
+        return !ec;
+    };
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(xsdFile);
+    if (it != cache.end()) {
+        bool unchanged = true;
+        for (const auto& file : it->second.files) {
+            Stamp current;
+            unchanged = unchanged && stamp(file.path, current) &&
+                        current.mtime == file.mtime && current.size == file.size;
+        }
+        if (unchanged) {
+            if (source) {
+                *source = LoadSource::MEMORY;
+            }
+            return it->second.schema;
+        }
+    }
+
+    // Stamps are taken before reading so a concurrent edit forces a reload
+    std::vector<std::string> files = XsdParser::collectSchemaFiles(xsdFile);
+    std::vector<Stamp> stamps(files.size());
+    bool stamped = true;
+    for (size_t i = 0; i < files.size(); ++i) {
+        stamped = stamp(files[i], stamps[i]) && stamped;
+    }
+
+    std::string cacheDir = cacheDirectory();
+    std::string key = cacheDir.empty() ? std::string() : contentKey(files);
+    std::filesystem::path imageFile;
+    std::shared_ptr<const CompiledSchema> schema;
+    LoadSource loadedFrom = LoadSource::COMPILED;
+
+    if (!key.empty()) {
+        imageFile = std::filesystem::path(cacheDir) / (key + ".ecs");
+        std::string image;
+        if (readFile(imageFile.string(), image)) {
+            schema = deserialize(image);
+            loadedFrom = LoadSource::DISK_CACHE;
+        }
+    }
+
+    if (!schema) {
+        loadedFrom = LoadSource::COMPILED;
+        try {
+            schema = compile(*XsdParser::parse(xsdFile));
+        } catch (const std::exception& e) {
+            throw std::runtime_error(std::string("Failed to parse XSD schema: ") + e.what());
+        }
+        if (!imageFile.empty()) {
+            storeImage(imageFile, schema->serialize());
+        }
+    }
+
+    if (stamped) {
+        cache[xsdFile] = {std::move(stamps), schema};
+    }
+    if (source) {
+        *source = loadedFrom;
+    }
+    return schema;
+}
+
+} // namespace expocli
@@ -0,0 +1,562 @@
+#include "validator/streaming_validator.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace expocli {
+
+namespace {
+
+constexpr size_t kReadBufferSize = 1 << 20;
+
+// Buffered byte reader that keeps track of the current line
+class XmlReader {
+public:
+    bool open(const std::string& path) {
+        in_.open(path, std::ios::binary);
+        buffer_.resize(kReadBufferSize);
+        return in_.good();
+    }
+
+    int peek() {
+        if (pos_ == end_ && !fill()) return -1;
+        return static_cast<unsigned char>(buffer_[pos_]);
+    }
+
+    int get() {
+        if (pos_ == end_ && !fill()) return -1;
+        char c = buffer_[pos_++];
+        if (c == '\n') ++line_;
+        return static_cast<unsigned char>(c);
+    }
+
+    int line() const { return line_; }
+
+    // Consume the exact literal; false if the input differs
+    bool expect(const char* literal) {
+        for (; *literal; ++literal) {
+            if (get() != static_cast<unsigned char>(*literal)) return false;
+        }
+        return true;
+    }
+
+    // Consume input up to and including the terminator (at most 3 chars),
+    // optionally collecting the content before it. False at end of input.
+    bool readUntil(const char* terminator, std::string* out) {
+        size_t length = std::strlen(terminator);
+        char window[4] = {0, 0, 0, 0};
+        size_t seen = 0;
+        while (true) {
+            int c = get();
+            if (c < 0) return false;
+            if (out) out->push_back(static_cast<char>(c));
+            std::memmove(window, window + 1, 2);
+            window[2] = static_cast<char>(c);
+            if (++seen >= length && std::memcmp(window + 3 - length, terminator, length) == 0) {
+                if (out) out->resize(out->size() - length);
+                return true;
+            }
+        }
+    }
+
+private:
+    bool fill() {
+        if (!in_) return false;
+        in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        end_ = static_cast<size_t>(in_.gcount());
+        pos_ = 0;
+        return end_ > 0;
+    }
+
+    std::ifstream in_;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    int line_ = 1;
+};
+
+bool isSpace(int c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isNameEnd(int c) {
+    return c < 0 || isSpace(c) || c == '/' || c == '>' || c == '=';
+}
+
+void appendUtf8(std::string& out, unsigned long cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Expand character/entity references and normalise line ends the way the
+// DOM parser does; attribute values also get whitespace converted to spaces
+std::string decode(const std::string& raw, bool attribute) {
+    std::string out;
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c == '\r') {
+            if (i + 1 < raw.size() && raw[i + 1] == '\n') ++i;
+            out += attribute ? ' ' : '\n';
+        } else if (attribute && (c == '\n' || c == '\t')) {
+            out += ' ';
+        } else if (c == '&') {
+            size_t semi = raw.find(';', i + 1);
+            std::string ref = semi == std::string::npos ? "" : raw.substr(i + 1, semi - i - 1);
+            if (ref == "lt") out += '<';
+            else if (ref == "gt") out += '>';
+            else if (ref == "amp") out += '&';
+            else if (ref == "apos") out += '\'';
+            else if (ref == "quot") out += '"';
+            else if (ref.size() > 1 && ref[0] == '#') {
+                bool hex = ref[1] == 'x';
+                char* end = nullptr;
+                unsigned long cp = std::strtoul(ref.c_str() + (hex ? 2 : 1), &end, hex ? 16 : 10);
+                if (*end != '\0') {
+                    out += c;
+                    continue;
+                }
+                appendUtf8(out, cp);
+            } else {
+                out += c;  // Unknown reference is kept verbatim
+                continue;
+            }
+            i = semi;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// Raised for documents that are not well-formed
+struct SyntaxError {
+    std::string message;
+    int line;
+};
+
+class StreamingRun {
+public:
+    StreamingRun(const CompiledSchema& schema, ValidationResult& result)
+        : schema_(schema), result_(result) {}
+
+    void run(XmlReader& reader) {
+        while (!stopped_) {
+            int c = reader.get();
+            if (c < 0) break;
+            if (c != '<') {
+                handleText(reader, c);
+                continue;
+            }
+
+            int line = reader.line();
+            int next = reader.peek();
+            if (next == '?') {
+                if (!reader.readUntil("?>", nullptr)) {
+                    throw SyntaxError{"Error parsing document declaration/processing instruction", line};
+                }
+            } else if (next == '!') {
+                reader.get();
+                handleMarkupDeclaration(reader, line);
+            } else if (next == '/') {
+                reader.get();
+                handleEndTag(reader, line);
+            } else {
+                handleStartTag(reader, line);
+            }
+        }
+
+        if (stopped_) return;
+        if (!frames_.empty()) {
+            throw SyntaxError{"Start-end tags mismatch", reader.line()};
+        }
+        if (!rootSeen_) {
+            throw SyntaxError{"No document element found", reader.line()};
+        }
+    }
+
+private:
+    struct Frame {
+        size_t nameOffset;
+        size_t nameLength;
+        const CompiledElement* element;  // nullptr: subtree is not validated
+        size_t counterBase;
+        size_t unexpectedBase;
+        int line;
+        bool textCaptured;
+    };
+
+    std::string buildPath() const {
+        std::string path;
+        for (const auto& frame : frames_) {
+            path += '/';
+            path.append(names_, frame.nameOffset, frame.nameLength);
+        }
+        return path;
+    }
+
+    bool capturesText() const {
+        return !frames_.empty() && frames_.back().element != nullptr &&
+               frames_.back().element->type != XsdType::COMPLEX && !frames_.back().textCaptured;
+    }
+
+    // Character data: only the first non-blank run of a simple element is kept,
+    // matching the value the DOM validator reads through node.text()
+    void handleText(XmlReader& reader, int first) {
+        bool capture = capturesText();
+        bool blank = true;
+        segment_.clear();
+        int c = first;
+        while (true) {
+            if (!isSpace(c)) blank = false;
+            if (capture) segment_ += static_cast<char>(c);
+            int next = reader.peek();
+            if (next < 0 || next == '<') break;
+            c = reader.get();
+        }
+        if (capture && !blank) {
+            text_ = decode(segment_, false);
+            frames_.back().textCaptured = true;
+        }
+    }
+
+    void handleMarkupDeclaration(XmlReader& reader, int line) {
+        int next = reader.peek();
+        if (next == '-') {
+            if (!reader.expect("--") || !reader.readUntil("-->", nullptr)) {
+                throw SyntaxError{"Error parsing comment", line};
+            }
+        } else if (next == '[') {
+            bool capture = capturesText();
+            segment_.clear();
+            if (!reader.expect("[CDATA[") || !reader.readUntil("]]>", capture ? &segment_ : nullptr)) {
+                throw SyntaxError{"Error parsing CDATA section", line};
+            }
+            if (capture) {
+                text_ = segment_;  // CDATA content is taken literally
+                frames_.back().textCaptured = true;
+            }
+        } else {
+            // DOCTYPE (possibly with an internal subset)
+            int depth = 0;
+            int quote = 0;
+            while (true) {
+                int c = reader.get();
+                if (c < 0) throw SyntaxError{"Error parsing document type declaration", line};
+                if (quote) {
+                    if (c == quote) quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '[') {
+                    ++depth;
+                } else if (c == ']') {
+                    --depth;
+                } else if (c == '>' && depth <= 0) {
+                    break;
+                }
+            }
+        }
+    }
+
+    void readName(XmlReader& reader, std::string& name) {
+        name.clear();
+        while (!isNameEnd(reader.peek())) {
+            name += static_cast<char>(reader.get());
+        }
+    }
+
+    void skipSpace(XmlReader& reader) {
+        while (isSpace(reader.peek())) reader.get();
+    }
+
+    void handleStartTag(XmlReader& reader, int line) {
+        readName(reader, tagName_);
+        if (tagName_.empty()) throw SyntaxError{"Error parsing start element tag", line};
+
+        attributes_.clear();
+        bool selfClosing = false;
+        while (true) {
+            skipSpace(reader);
+            int c = reader.peek();
+            if (c == '/') {
+                reader.get();
+                if (reader.get() != '>') throw SyntaxError{"Error parsing start element tag", line};
+                selfClosing = true;
+                break;
+            }
+            if (c == '>') {
+                reader.get();
+                break;
+            }
+            if (c < 0) throw SyntaxError{"Error parsing start element tag", line};
+
+            std::string attrName;
+            readName(reader, attrName);
+            skipSpace(reader);
+            if (attrName.empty() || reader.get() != '=') {
+                throw SyntaxError{"Error parsing attribute", line};
+            }
+            skipSpace(reader);
+            int quote = reader.get();
+            if (quote != '"' && quote != '\'') throw SyntaxError{"Error parsing attribute", line};
+            segment_.clear();
+            while (true) {
+                int v = reader.get();
+                if (v < 0) throw SyntaxError{"Error parsing attribute", line};
+                if (v == quote) break;
+                segment_ += static_cast<char>(v);
+            }
+            attributes_.emplace_back(std::move(attrName), decode(segment_, true));
+        }
+
+        startElement(line);
+        if (selfClosing) {
+            endElement();
+        }
+    }
+
+    void handleEndTag(XmlReader& reader, int line) {
+        readName(reader, tagName_);
+        skipSpace(reader);
+        if (reader.get() != '>') throw SyntaxError{"Error parsing end element tag", line};
+        if (frames_.empty() ||
+            names_.compare(frames_.back().nameOffset, frames_.back().nameLength, tagName_) != 0) {
+            throw SyntaxError{"Start-end tags mismatch", line};
+        }
+        endElement();
+    }
+
+    void pushFrame(const CompiledElement* element, int line) {
+        Frame frame;
+        frame.nameOffset = names_.size();
+        frame.nameLength = tagName_.size();
+        frame.element = element;
+        frame.counterBase = counters_.size();
+        frame.unexpectedBase = unexpected_.size();
+        frame.line = line;
+        frame.textCaptured = false;
+        names_ += tagName_;
+
+        if (element != nullptr && element->type == XsdType::COMPLEX) {
+            counters_.resize(counters_.size() +
+                             schema_.contentType(element->contentType).childCount, 0);
+        }
+        frames_.push_back(frame);
+    }
+
+    void startElement(int line) {
+        if (frames_.empty()) {
+            if (rootSeen_) {
+                pushFrame(nullptr, line);  // Content after the document element
+                return;
+            }
+            rootSeen_ = true;
+
+            const CompiledElement& root = schema_.root();
+            const std::string& rootName = schema_.name(root.name);
+            if (tagName_ != rootName) {
+                result_.addError(
+                    "Root element name mismatch. Expected: " + rootName + ", Found: " + tagName_,
+                    "/" + tagName_, line);
+                stopped_ = true;
+                return;
+            }
+            pushFrame(&root, line);
+            validateAttributes(root, line);
+            return;
+        }
+
+        Frame& parent = frames_.back();
+        if (parent.element == nullptr || parent.element->type != XsdType::COMPLEX) {
+            pushFrame(nullptr, line);
+            return;
+        }
+
+        const CompiledContentType& contentType = schema_.contentType(parent.element->contentType);
+        int32_t slot = schema_.findChild(contentType, tagName_.data(), tagName_.size());
+        if (slot < 0) {
+            recordUnexpected(parent);
+            pushFrame(nullptr, line);
+            return;
+        }
+
+        ++counters_[parent.counterBase + slot];
+        const CompiledElement& element = schema_.element(contentType.firstChild + slot);
+        pushFrame(&element, line);
+        validateAttributes(element, line);
+    }
+
+    void recordUnexpected(const Frame& parent) {
+        for (size_t i = parent.unexpectedBase; i < unexpected_.size(); ++i) {
+            if (unexpected_[i].first == tagName_) {
+                ++unexpected_[i].second;
+                return;
+            }
+        }
+        unexpected_.emplace_back(tagName_, 1);
+    }
+
+    void validateAttributes(const CompiledElement& element, int line) {
+        const CompiledContentType& contentType = schema_.contentType(element.contentType);
+
+        attributeValues_.assign(contentType.attributeCount, nullptr);
+        bool hasUnexpected = false;
+        for (const auto& [attrName, attrValue] : attributes_) {
+            int32_t slot = schema_.findAttribute(contentType, attrName.data(), attrName.size());
+            if (slot < 0) {
+                hasUnexpected = true;
+            } else if (attributeValues_[slot] == nullptr) {
+                attributeValues_[slot] = &attrValue;
+            }
+        }
+
+        for (uint32_t i = 0; i < contentType.attributeCount; ++i) {
+            const CompiledAttribute& schemaAttr = schema_.attribute(contentType.firstAttribute + i);
+            const std::string* attrValue = attributeValues_[i];
+            if (attrValue == nullptr) {
+                if (schemaAttr.required) {
+                    result_.addError("Missing required attribute: " + schema_.name(schemaAttr.name),
+                                     buildPath(), line);
+                }
+            } else if (!XmlValidator::matchesType(attrValue->c_str(), schemaAttr.type)) {
+                result_.addError("Attribute '" + schema_.name(schemaAttr.name) +
+                                 "' has invalid value type: " + *attrValue,
+                                 buildPath(), line);
+            }
+        }
+
+        if (hasUnexpected) {
+            for (const auto& attr : attributes_) {
+                if (schema_.findAttribute(contentType, attr.first.data(), attr.first.size()) < 0) {
+                    result_.addWarning("Unexpected attribute '" + attr.first + "' at " +
+                                       buildPath() + " (line " + std::to_string(line) + ")");
+                }
+            }
+        }
+    }
+
+    void endElement() {
+        const Frame& frame = frames_.back();
+        if (frame.element != nullptr) {
+            if (frame.element->type == XsdType::COMPLEX) {
+                checkOccurrences(frame);
+            } else {
+                checkText(frame);
+            }
+        }
+
+        counters_.resize(frame.counterBase);
+        unexpected_.resize(frame.unexpectedBase);
+        names_.resize(frame.nameOffset);
+        frames_.pop_back();
+    }
+
+    void checkOccurrences(const Frame& frame) {
+        const CompiledContentType& contentType = schema_.contentType(frame.element->contentType);
+        for (uint32_t i = 0; i < contentType.childCount; ++i) {
+            const CompiledElement& schemaChild = schema_.element(contentType.firstChild + i);
+            int count = counters_[frame.counterBase + i];
+
+            if (count < schemaChild.minOccurs) {
+                result_.addError(
+                    "Element '" + schema_.name(schemaChild.name) + "' appears " +
+                    std::to_string(count) + " times, but minOccurs is " +
+                    std::to_string(schemaChild.minOccurs),
+                    buildPath(), frame.line);
+            }
+            if (schemaChild.maxOccurs != -1 && count > schemaChild.maxOccurs) {
+                result_.addError(
+                    "Element '" + schema_.name(schemaChild.name) + "' appears " +
+                    std::to_string(count) + " times, but maxOccurs is " +
+                    std::to_string(schemaChild.maxOccurs),
+                    buildPath(), frame.line);
+            }
+        }
+
+        if (unexpected_.size() > frame.unexpectedBase) {
+            std::sort(unexpected_.begin() + frame.unexpectedBase, unexpected_.end());
+            std::string path = buildPath();
+            for (size_t i = frame.unexpectedBase; i < unexpected_.size(); ++i) {
+                result_.addWarning(
+                    "Unexpected element '" + unexpected_[i].first + "' (appears " +
+                    std::to_string(unexpected_[i].second) + " times) at " + path +
+                    " (line " + std::to_string(frame.line) + ")");
+            }
+        }
+    }
+
+    void checkText(const Frame& frame) {
+        if (!frame.textCaptured) {
+            text_.clear();
+        }
+        if (text_.empty() && frame.element->minOccurs != 0) {
+            result_.addError("Required element is empty", buildPath(), frame.line);
+        } else if (!text_.empty() && !XmlValidator::matchesType(text_.c_str(), frame.element->type)) {
+            result_.addError("Value does not match expected type: " + text_, buildPath(), frame.line);
+        }
+    }
+
+    const CompiledSchema& schema_;
+    ValidationResult& result_;
+
+    std::vector<Frame> frames_;
+    std::string names_;                                   // Names of open elements, concatenated
+    std::vector<int> counters_;                           // Occurrence counters of open content models
+    std::vector<std::pair<std::string, int>> unexpected_; // Undeclared children of open elements
+    std::vector<std::pair<std::string, std::string>> attributes_;
+    std::vector<const std::string*> attributeValues_;
+    std::string tagName_;
+    std::string segment_;
+    std::string text_;
+    bool rootSeen_ = false;
+    bool stopped_ = false;
+};
+
+} // anonymous namespace
+
+ValidationResult StreamingValidator::validateFile(const std::string& xmlFile) {
+    ValidationResult result;
+
+    // Check if XML file exists
+    if (!std::filesystem::exists(xmlFile)) {
+        result.addError("XML file does not exist: " + xmlFile);
+        return result;
+    }
+
+    if (!schema_.hasRoot()) {
+        result.addError("Schema has no root element defined");
+        return result;
+    }
+
+    XmlReader reader;
+    if (!reader.open(xmlFile)) {
+        result.addError("Failed to parse XML file: Error opening file", xmlFile);
+        return result;
+    }
+
+    StreamingRun run(schema_, result);
+    try {
+        run.run(reader);
+    } catch (const SyntaxError& e) {
+        result.addError("Failed to parse XML file: " + e.message, xmlFile, e.line);
+    }
+
+    return result;
+}
+
+} // namespace expocli
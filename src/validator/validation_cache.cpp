@@ -0,0 +1,303 @@
+#include "validator/validation_cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace expocli {
+
+namespace {
+
+constexpr char kCacheMagic[8] = {'E', 'X', 'P', 'O', 'V', 'A', 'L', 'C'};
+constexpr uint32_t kCacheVersion = 1;
+
+// Fixed-width fields in host byte order, as in the schema cache images
+class CacheWriter {
+public:
+    explicit CacheWriter(std::string& out) : out_(out) {}
+
+    void u32(uint32_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void u64(uint64_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void str(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        out_.append(value);
+    }
+
+private:
+    std::string& out_;
+};
+
+class CacheReader {
+public:
+    CacheReader(const std::string& in, size_t pos) : in_(in), pos_(pos) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == in_.size(); }
+
+    uint32_t u32() { return read<uint32_t>(); }
+    uint64_t u64() { return read<uint64_t>(); }
+    std::string str() {
+        uint32_t length = u32();
+        if (!take(length)) {
+            return std::string();
+        }
+        return in_.substr(pos_ - length, length);
+    }
+
+private:
+    const std::string& in_;
+    size_t pos_;
+    bool ok_ = true;
+
+    bool take(size_t length) {
+        if (!ok_ || in_.size() - pos_ < length) {
+            ok_ = false;
+            return false;
+        }
+        pos_ += length;
+        return true;
+    }
+
+    template <typename T>
+    T read() {
+        T value = 0;
+        if (take(sizeof(value))) {
+            std::memcpy(&value, in_.data() + pos_ - sizeof(value), sizeof(value));
+        }
+        return value;
+    }
+};
+
+// 64-bit hash of a file's content, a word at a time; 0 if it cannot be read
+uint64_t hashFile(const std::string& path) {
+    FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        return 0;
+    }
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    uint64_t total = 0;
+    char buffer[1 << 16];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        size_t i = 0;
+        for (; i + 8 <= read; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, buffer + i, sizeof(word));
+            h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 31;
+        }
+        for (; i < read; ++i) {
+            h = (h ^ static_cast<unsigned char>(buffer[i])) * 0x100000001B3ull;
+        }
+        total += read;
+    }
+    bool failed = std::ferror(in) != 0;
+    std::fclose(in);
+    if (failed) {
+        return 0;
+    }
+    h = (h ^ total) * 0x94D049BB133111EBull;
+    h ^= h >> 29;
+    return h == 0 ? 1 : h;
+}
+
+int64_t now() {
+    return std::filesystem::file_time_type::clock::now().time_since_epoch().count();
+}
+
+} // namespace
+
+ValidationCache::ValidationCache(const std::string& directory, uint64_t schemaKey) {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.evc", static_cast<unsigned long long>(schemaKey));
+    file_ = (std::filesystem::path(directory) / name).string();
+    load();
+}
+
+std::string ValidationCache::cacheDirectory() {
+    if (const char* dir = std::getenv("EXPOCLI_VALIDATION_CACHE")) {
+        std::string value = dir;
+        return value == "off" || value == "OFF" ? std::string() : value;
+    }
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return (std::filesystem::path(xdg) / "expocli" / "validation").string();
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return (std::filesystem::path(home) / ".cache" / "expocli" / "validation").string();
+    }
+    return std::string();
+}
+
+void ValidationCache::load() {
+    std::ifstream in(file_, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return;
+    }
+    std::string data(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    if (!in.read(&data[0], static_cast<std::streamsize>(data.size())) ||
+        data.size() < sizeof(kCacheMagic) ||
+        std::memcmp(data.data(), kCacheMagic, sizeof(kCacheMagic)) != 0) {
+        return;
+    }
+
+    CacheReader reader(data, sizeof(kCacheMagic));
+    if (reader.u32() != kCacheVersion) {
+        return;
+    }
+    int64_t savedAt = static_cast<int64_t>(reader.u64());
+
+    // A damaged file is dropped as a whole
+    std::unordered_map<std::string, Entry> entries;
+    while (reader.ok() && !reader.atEnd()) {
+        std::string path = reader.str();
+        Entry& entry = entries[path];
+        entry.size = reader.u64();
+        entry.mtime = static_cast<int64_t>(reader.u64());
+        entry.hash = reader.u64();
+        entry.result.isValid = reader.u32() != 0;
+        uint32_t errorCount = reader.u32();
+        for (uint32_t i = 0; i < errorCount && reader.ok(); ++i) {
+            ValidationError error;
+            error.message = reader.str();
+            error.path = reader.str();
+            error.line = static_cast<int>(reader.u32());
+            entry.result.errors.push_back(std::move(error));
+        }
+        uint32_t warningCount = reader.u32();
+        for (uint32_t i = 0; i < warningCount && reader.ok(); ++i) {
+            entry.result.warnings.push_back(reader.str());
+        }
+    }
+    if (reader.ok()) {
+        savedAt_ = savedAt;
+        entries_ = std::move(entries);
+    }
+}
+
+bool ValidationCache::lookup(const std::string& file, ValidationResult& result, FileStamp& stamp) {
+    std::error_code ec;
+    stamp.valid = false;
+    stamp.key = std::filesystem::absolute(file, ec).lexically_normal().string();
+    if (ec) {
+        return false;
+    }
+    stamp.size = std::filesystem::file_size(file, ec);
+    if (ec) {
+        return false;
+    }
+    stamp.mtime = std::filesystem::last_write_time(file, ec).time_since_epoch().count();
+    if (ec) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(stamp.key);
+        if (it != entries_.end() && it->second.size == stamp.size &&
+            it->second.mtime == stamp.mtime && stamp.mtime < savedAt_) {
+            result = it->second.result;
+            ++hits_;
+            return true;
+        }
+    }
+
+    // New, resized, or the mtime moved or is too recent to trust: compare
+    // content. The hash is taken before the file is validated, so that
+    // store() files the verdict under the bytes that were there when it
+    // started, never under a later version of the file.
+    stamp.hash = hashFile(file);
+    if (stamp.hash == 0) {
+        return false;
+    }
+    stamp.valid = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(stamp.key);
+    if (it == entries_.end() || it->second.size != stamp.size || it->second.hash != stamp.hash) {
+        return false;
+    }
+    if (it->second.mtime != stamp.mtime) {
+        it->second.mtime = stamp.mtime;
+        dirty_ = true;
+    }
+    result = it->second.result;
+    ++hits_;
+    return true;
+}
+
+void ValidationCache::store(const FileStamp& stamp, const ValidationResult& result) {
+    if (!stamp.valid || stamp.hash == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[stamp.key];
+    entry.size = stamp.size;
+    entry.mtime = stamp.mtime;
+    entry.hash = stamp.hash;
+    entry.result = result;
+    dirty_ = true;
+}
+
+void ValidationCache::save() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_) {
+        return;
+    }
+
+    // Files modified from here on are newer than savedAt
+    int64_t savedAt = now();
+    std::string out(kCacheMagic, sizeof(kCacheMagic));
+    CacheWriter writer(out);
+    writer.u32(kCacheVersion);
+    writer.u64(static_cast<uint64_t>(savedAt));
+    for (const auto& item : entries_) {
+        const Entry& entry = item.second;
+        writer.str(item.first);
+        writer.u64(entry.size);
+        writer.u64(static_cast<uint64_t>(entry.mtime));
+        writer.u64(entry.hash);
+        writer.u32(entry.result.isValid ? 1 : 0);
+        writer.u32(static_cast<uint32_t>(entry.result.errors.size()));
+        for (const auto& error : entry.result.errors) {
+            writer.str(error.message);
+            writer.str(error.path);
+            writer.u32(static_cast<uint32_t>(error.line));
+        }
+        writer.u32(static_cast<uint32_t>(entry.result.warnings.size()));
+        for (const auto& warning : entry.result.warnings) {
+            writer.str(warning);
+        }
+    }
+
+    // Written to a temporary file first, so concurrent sessions never see
+    // a partial cache
+    std::filesystem::path target(file_);
+    std::error_code ec;
+    std::filesystem::create_directories(target.parent_path(), ec);
+    if (ec) {
+        return;
+    }
+    std::filesystem::path temp = target;
+    temp += ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+            stream.close();
+            std::filesystem::remove(temp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return;
+    }
+    savedAt_ = savedAt;
+    dirty_ = false;
+}
+
+} // namespace expocli
@@ -1,13 +1,20 @@
 #include "validator/xml_validator.h"
 #include "generator/xsd_parser.h"
+#include "validator/streaming_validator.h"
+#include "validator/validation_cache.h"
 #include <pugixml.hpp>
 #include <filesystem>
 #include <glob.h>
 #include <iostream>
-#include <regex>
 #include <algorithm>
 #include <set>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <cstring>
+#include <cerrno>
+#include <cstdlib>
 
 namespace expocli {
 
@@ -55,15 +62,46 @@ std::vector<std::string> XmlValidator::expandPattern(const std::string& pattern)
 ValidationResult XmlValidator::validateFile(
     const std::string& xmlFile,
     const std::string& xsdFile
+) {
+    // Parse XSD schema
+    std::unique_ptr<XsdSchema> schema;
+    try {
+        schema = XsdParser::parse(xsdFile);
+    } catch (const std::exception& e) {
+        ValidationResult result;
+        result.addError(std::string("Failed to parse XSD schema: ") + e.what());
+        return result;
+    }
+
+    return validateFile(xmlFile, *schema);
+}
+
+ValidationResult XmlValidator::validateFile(
+    const std::string& xmlFile,
+    const XsdSchema& schema
+) {
+    return validateFile(xmlFile, *CompiledSchema::compile(schema));
+}
+
+ValidationResult XmlValidator::validateFile(
+    const std::string& xmlFile,
+    const CompiledSchema& schema
 ) {
     ValidationResult result;
 
     // Check if XML file exists
-    if (!std::filesystem::exists(xmlFile)) {
+    std::error_code ec;
+    if (!std::filesystem::exists(xmlFile, ec)) {
         result.addError("XML file does not exist: " + xmlFile);
         return result;
     }
 
+    // Huge documents are checked without materialising a DOM
+    uintmax_t fileSize = std::filesystem::file_size(xmlFile, ec);
+    if (!ec && fileSize >= streamingThreshold_) {
+        return StreamingValidator(schema).validateFile(xmlFile);
+    }
+
     // Load XML file
     pugi::xml_document doc;
     pugi::xml_parse_result parseResult = doc.load_file(xmlFile.c_str());
@@ -76,17 +114,31 @@ ValidationResult XmlValidator::validateFile(
         return result;
     }
 
-    // Parse XSD schema
-    std::unique_ptr<XsdSchema> schema;
-    try {
-        schema = XsdParser::parse(xsdFile);
-    } catch (const std::exception& e) {
-        result.addError(std::string("Failed to parse XSD schema: ") + e.what());
+    // Validate XML against schema
+    return validateAgainstSchema(doc, schema);
+}
+
+uint64_t XmlValidator::resultKey(const CompiledSchema& schema) const {
+    uint64_t key = schema.fingerprint() ^ (static_cast<uint64_t>(streamingThreshold_) * 0x9E3779B97F4A7C15ull);
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    return key ^ (key >> 31);
+}
+
+ValidationResult XmlValidator::validateCached(
+    const std::string& xmlFile,
+    const CompiledSchema& schema
+) {
+    if (!cache_) {
+        return validateFile(xmlFile, schema);
+    }
+    ValidationResult result;
+    FileStamp stamp;
+    if (cache_->lookup(xmlFile, result, stamp)) {
         return result;
     }
-
-    // Validate XML against schema
-    return validateAgainstSchema(doc, *schema);
+    result = validateFile(xmlFile, schema);
+    cache_->store(stamp, result);
+    return result;
 }
 
 std::vector<std::pair<std::string, ValidationResult>> XmlValidator::validateFiles(
@@ -94,23 +146,99 @@ std::vector<std::pair<std::string, ValidationResult>> XmlValidator::validateFile
     const std::string& xsdFile
 ) {
     std::vector<std::pair<std::string, ValidationResult>> results;
+    results.reserve(xmlFiles.size());
 
-    for (const auto& xmlFile : xmlFiles) {
-        ValidationResult result = validateFile(xmlFile, xsdFile);
-        results.push_back({xmlFile, result});
-    }
+    validateFiles(xmlFiles, xsdFile,
+        [&results](const std::string& xmlFile, const ValidationResult& result) {
+            results.push_back({xmlFile, result});
+        });
 
     return results;
 }
 
+void XmlValidator::validateFiles(
+    const std::vector<std::string>& xmlFiles,
+    const std::string& xsdFile,
+    const ValidationCallback& onResult,
+    size_t threadCount
+) {
+    // Load the compiled XSD once for the whole batch
+    std::shared_ptr<const CompiledSchema> schema;
+    try {
+        schema = CompiledSchema::load(xsdFile);
+    } catch (const std::exception& e) {
+        ValidationResult failure;
+        failure.addError(e.what());
+        for (const auto& xmlFile : xmlFiles) {
+            onResult(xmlFile, failure);
+        }
+        return;
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) {
+            threadCount = 4;
+        }
+    }
+    threadCount = std::max<size_t>(1, std::min(threadCount, xmlFiles.size()));
+
+    if (threadCount == 1) {
+        for (const auto& xmlFile : xmlFiles) {
+            onResult(xmlFile, validateCached(xmlFile, *schema));
+        }
+        return;
+    }
+
+    // Workers claim files by index; finished results wait in a reorder
+    // buffer until every earlier file has been delivered
+    std::atomic<size_t> nextIndex{0};
+    std::mutex deliverMutex;
+    std::map<size_t, ValidationResult> pending;
+    size_t nextToDeliver = 0;
+
+    auto worker = [&]() {
+        while (true) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= xmlFiles.size()) {
+                break;
+            }
+
+            ValidationResult result;
+            try {
+                result = validateCached(xmlFiles[index], *schema);
+            } catch (const std::exception& e) {
+                result.addError(std::string("Validation failed: ") + e.what(), xmlFiles[index]);
+            }
+
+            std::lock_guard<std::mutex> lock(deliverMutex);
+            pending.emplace(index, std::move(result));
+            auto it = pending.begin();
+            while (it != pending.end() && it->first == nextToDeliver) {
+                onResult(xmlFiles[nextToDeliver], it->second);
+                it = pending.erase(it);
+                ++nextToDeliver;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 ValidationResult XmlValidator::validateAgainstSchema(
     const pugi::xml_document& doc,
-    const XsdSchema& schema
+    const CompiledSchema& schema
 ) {
     ValidationResult result;
 
-    auto rootElement = schema.getRootElement();
-    if (!rootElement) {
+    if (!schema.hasRoot()) {
         result.addError("Schema has no root element defined");
         return result;
     }
@@ -129,9 +257,11 @@ ValidationResult XmlValidator::validateAgainstSchema(
     }
 
     // Check root element name matches
-    if (xmlRoot.name() != rootElement->name) {
+    const CompiledElement& rootElement = schema.root();
+    const std::string& rootName = schema.name(rootElement.name);
+    if (rootName != xmlRoot.name()) {
         result.addError(
-            "Root element name mismatch. Expected: " + rootElement->name +
+            "Root element name mismatch. Expected: " + rootName +
             ", Found: " + std::string(xmlRoot.name()),
             "/" + std::string(xmlRoot.name())
         );
@@ -139,45 +269,58 @@ ValidationResult XmlValidator::validateAgainstSchema(
     }
 
     // Validate the root element recursively
-    validateElement(xmlRoot, rootElement, result, "/" + rootElement->name);
+    ValidationScratch scratch;
+    scratch.path.push_back(rootName.c_str());
+    validateElement(xmlRoot, schema, rootElement, result, scratch);
 
     return result;
 }
 
+std::string XmlValidator::ValidationScratch::buildPath() const {
+    std::string result;
+    for (const char* name : path) {
+        result += '/';
+        result += name;
+    }
+    return result;
+}
+
 bool XmlValidator::validateElement(
     const pugi::xml_node& node,
-    const std::shared_ptr<XsdElement>& schemaElement,
+    const CompiledSchema& schema,
+    const CompiledElement& schemaElement,
     ValidationResult& result,
-    const std::string& path
+    ValidationScratch& scratch
 ) {
     bool valid = true;
+    const CompiledContentType& contentType = schema.contentType(schemaElement.contentType);
 
     // Validate attributes
-    if (!validateAttributes(node, schemaElement, result, path)) {
+    if (!validateAttributes(node, schema, contentType, result, scratch)) {
         valid = false;
     }
 
     // Validate content based on type
-    if (schemaElement->type == XsdType::COMPLEX) {
+    if (schemaElement.type == XsdType::COMPLEX) {
         // Validate child elements
-        if (!validateChildren(node, schemaElement, result, path)) {
+        if (!validateChildren(node, schema, contentType, result, scratch)) {
             valid = false;
         }
     } else {
         // Simple type - validate text content
-        std::string textValue = node.text().as_string();
+        const char* textValue = node.text().get();
 
         // Empty text is allowed if element has minOccurs=0
-        if (textValue.empty() && !schemaElement->isOptional()) {
+        if (*textValue == '\0' && schemaElement.minOccurs != 0) {
             result.addError(
                 "Required element is empty",
-                path
+                scratch.buildPath()
             );
             valid = false;
-        } else if (!textValue.empty() && !matchesType(textValue, schemaElement->type)) {
+        } else if (*textValue != '\0' && !matchesType(textValue, schemaElement.type)) {
             result.addError(
-                "Value does not match expected type: " + textValue,
-                path
+                "Value does not match expected type: " + std::string(textValue),
+                scratch.buildPath()
             );
             valid = false;
         }
@@ -188,53 +331,62 @@ bool XmlValidator::validateElement(
 
 bool XmlValidator::validateAttributes(
     const pugi::xml_node& node,
-    const std::shared_ptr<XsdElement>& schemaElement,
+    const CompiledSchema& schema,
+    const CompiledContentType& contentType,
     ValidationResult& result,
-    const std::string& path
+    ValidationScratch& scratch
 ) {
     bool valid = true;
 
-    // Check for required attributes
-    for (const auto& schemaAttr : schemaElement->attributes) {
-        pugi::xml_attribute xmlAttr = node.attribute(schemaAttr->name.c_str());
+    // Match document attributes to declaration slots in one pass
+    size_t base = scratch.attributeValues.size();
+    scratch.attributeValues.resize(base + contentType.attributeCount, nullptr);
+    bool hasUnexpected = false;
 
-        if (!xmlAttr) {
-            if (!schemaAttr->isOptional()) {
-                result.addError(
-                    "Missing required attribute: " + schemaAttr->name,
-                    path
-                );
-                valid = false;
-            }
-        } else {
-            // Validate attribute value type
-            std::string attrValue = xmlAttr.value();
-            if (!matchesType(attrValue, schemaAttr->type)) {
+    for (pugi::xml_attribute attr : node.attributes()) {
+        const char* attrName = attr.name();
+        int32_t slot = schema.findAttribute(contentType, attrName, std::strlen(attrName));
+        if (slot < 0) {
+            hasUnexpected = true;
+        } else if (scratch.attributeValues[base + slot] == nullptr) {
+            scratch.attributeValues[base + slot] = attr.value();
+        }
+    }
+
+    // Check for required attributes and value types
+    for (uint32_t i = 0; i < contentType.attributeCount; ++i) {
+        const CompiledAttribute& schemaAttr = schema.attribute(contentType.firstAttribute + i);
+        const char* attrValue = scratch.attributeValues[base + i];
+
+        if (attrValue == nullptr) {
+            if (schemaAttr.required) {
                 result.addError(
-                    "Attribute '" + schemaAttr->name +
-                    "' has invalid value type: " + attrValue,
-                    path
+                    "Missing required attribute: " + schema.name(schemaAttr.name),
+                    scratch.buildPath()
                 );
                 valid = false;
             }
+        } else if (!matchesType(attrValue, schemaAttr.type)) {
+            result.addError(
+                "Attribute '" + schema.name(schemaAttr.name) +
+                "' has invalid value type: " + attrValue,
+                scratch.buildPath()
+            );
+            valid = false;
         }
     }
+    scratch.attributeValues.resize(base);
 
     // Check for unexpected attributes (not in schema)
-    for (pugi::xml_attribute attr : node.attributes()) {
-        std::string attrName = attr.name();
-        bool found = false;
-        for (const auto& schemaAttr : schemaElement->attributes) {
-            if (schemaAttr->name == attrName) {
-                found = true;
-                break;
+    if (hasUnexpected) {
+        for (pugi::xml_attribute attr : node.attributes()) {
+            const char* attrName = attr.name();
+            if (schema.findAttribute(contentType, attrName, std::strlen(attrName)) < 0) {
+                result.addWarning(
+                    "Unexpected attribute '" + std::string(attrName) + "' at " + scratch.buildPath()
+                );
             }
         }
-        if (!found) {
-            result.addWarning(
-                "Unexpected attribute '" + attrName + "' at " + path
-            );
-        }
     }
 
     return valid;
@@ -242,89 +394,123 @@ bool XmlValidator::validateAttributes(
 
 bool XmlValidator::validateChildren(
     const pugi::xml_node& node,
-    const std::shared_ptr<XsdElement>& schemaElement,
+    const CompiledSchema& schema,
+    const CompiledContentType& contentType,
     ValidationResult& result,
-    const std::string& path
+    ValidationScratch& scratch
 ) {
     bool valid = true;
 
-    // Count occurrences of each child element
-    std::map<std::string, int> childCounts;
-    for (pugi::xml_node child : node.children()) {
-        if (child.type() == pugi::node_element) {
-            childCounts[child.name()]++;
+    // Run the occurrence counters over the child sequence
+    size_t base = scratch.counters.size();
+    scratch.counters.resize(base + contentType.childCount, 0);
+    std::vector<const char*> unexpected;
+
+    for (pugi::xml_node child = node.first_child(); child; child = child.next_sibling()) {
+        if (child.type() != pugi::node_element) {
+            continue;
+        }
+        const char* childName = child.name();
+        int32_t slot = schema.findChild(contentType, childName, std::strlen(childName));
+        if (slot < 0) {
+            unexpected.push_back(childName);
+        } else {
+            ++scratch.counters[base + slot];
         }
     }
 
-    // Validate each schema child element
-    for (const auto& schemaChild : schemaElement->children) {
-        int count = childCounts[schemaChild->name];
+    // Check occurrence bounds of each schema child
+    for (uint32_t i = 0; i < contentType.childCount; ++i) {
+        const CompiledElement& schemaChild = schema.element(contentType.firstChild + i);
+        int count = scratch.counters[base + i];
 
         // Check minOccurs
-        if (count < schemaChild->minOccurs) {
+        if (count < schemaChild.minOccurs) {
             result.addError(
-                "Element '" + schemaChild->name + "' appears " +
+                "Element '" + schema.name(schemaChild.name) + "' appears " +
                 std::to_string(count) + " times, but minOccurs is " +
-                std::to_string(schemaChild->minOccurs),
-                path
+                std::to_string(schemaChild.minOccurs),
+                scratch.buildPath()
             );
             valid = false;
         }
 
         // Check maxOccurs (if not unbounded)
-        if (schemaChild->maxOccurs != -1 && count > schemaChild->maxOccurs) {
+        if (schemaChild.maxOccurs != -1 && count > schemaChild.maxOccurs) {
             result.addError(
-                "Element '" + schemaChild->name + "' appears " +
+                "Element '" + schema.name(schemaChild.name) + "' appears " +
                 std::to_string(count) + " times, but maxOccurs is " +
-                std::to_string(schemaChild->maxOccurs),
-                path
+                std::to_string(schemaChild.maxOccurs),
+                scratch.buildPath()
             );
             valid = false;
         }
-
-        // Mark as validated
-        childCounts.erase(schemaChild->name);
     }
-
-    // Check for unexpected child elements
-    for (const auto& [childName, count] : childCounts) {
-        result.addWarning(
-            "Unexpected element '" + childName + "' (appears " +
-            std::to_string(count) + " times) at " + path
-        );
+    scratch.counters.resize(base);
+
+    // Report unexpected child elements once per name, in name order
+    if (!unexpected.empty()) {
+        std::sort(unexpected.begin(), unexpected.end(),
+                  [](const char* a, const char* b) { return std::strcmp(a, b) < 0; });
+        std::string path = scratch.buildPath();
+        for (size_t i = 0; i < unexpected.size();) {
+            size_t j = i;
+            while (j < unexpected.size() && std::strcmp(unexpected[i], unexpected[j]) == 0) {
+                ++j;
+            }
+            result.addWarning(
+                "Unexpected element '" + std::string(unexpected[i]) + "' (appears " +
+                std::to_string(j - i) + " times) at " + path
+            );
+            i = j;
+        }
     }
 
-    // Recursively validate each child element
-    for (pugi::xml_node child : node.children()) {
+    // Recursively validate each declared child element
+    for (pugi::xml_node child = node.first_child(); child; child = child.next_sibling()) {
         if (child.type() != pugi::node_element) {
             continue;
         }
 
-        std::string childName = child.name();
-        std::string childPath = path + "/" + childName;
-
-        // Find matching schema element
-        std::shared_ptr<XsdElement> matchingSchema;
-        for (const auto& schemaChild : schemaElement->children) {
-            if (schemaChild->name == childName) {
-                matchingSchema = schemaChild;
-                break;
-            }
+        const char* childName = child.name();
+        int32_t slot = schema.findChild(contentType, childName, std::strlen(childName));
+        if (slot < 0) {
+            continue;  // Already reported as unexpected element
         }
 
-        if (matchingSchema) {
-            if (!validateElement(child, matchingSchema, result, childPath)) {
-                valid = false;
-            }
+        scratch.path.push_back(childName);
+        if (!validateElement(child, schema, schema.element(contentType.firstChild + slot),
+                             result, scratch)) {
+            valid = false;
         }
-        // else: already reported as unexpected element
+        scratch.path.pop_back();
     }
 
     return valid;
 }
 
-bool XmlValidator::matchesType(const std::string& value, XsdType type) {
-    if (value.empty()) {
+namespace {
+
+bool isDigits(const char* value, size_t from, size_t to) {
+    for (size_t i = from; i < to; ++i) {
+        if (value[i] < '0' || value[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// YYYY-MM-DD at the start of value
+bool isIsoDate(const char* value) {
+    return isDigits(value, 0, 4) && value[4] == '-' &&
+           isDigits(value, 5, 7) && value[7] == '-' &&
+           isDigits(value, 8, 10);
+}
+
+} // anonymous namespace
+
+bool XmlValidator::matchesType(const char* value, XsdType type) {
+    if (*value == '\0') {
         return true; // Empty values are checked separately
     }
 
@@ -333,40 +519,37 @@ bool XmlValidator::matchesType(const std::string& value, XsdType type) {
             return true; // Any string is valid
 
         case XsdType::INTEGER: {
-            try {
-                size_t pos;
-                std::stoll(value, &pos);
-                return pos == value.length();
-            } catch (...) {
-                return false;
-            }
+            // Same acceptance as std::stoll consuming the whole value
+            char* end = nullptr;
+            errno = 0;
+            std::strtoll(value, &end, 10);
+            return end != value && *end == '\0' && errno != ERANGE;
         }
 
         case XsdType::DECIMAL: {
-            try {
-                size_t pos;
-                std::stod(value, &pos);
-                return pos == value.length();
-            } catch (...) {
-                return false;
-            }
+            // Same acceptance as std::stod consuming the whole value
+            char* end = nullptr;
+            errno = 0;
+            std::strtod(value, &end);
+            return end != value && *end == '\0' && errno != ERANGE;
         }
 
         case XsdType::BOOLEAN: {
-            return value == "true" || value == "false" ||
-                   value == "1" || value == "0";
+            return std::strcmp(value, "true") == 0 || std::strcmp(value, "false") == 0 ||
+                   std::strcmp(value, "1") == 0 || std::strcmp(value, "0") == 0;
         }
 
         case XsdType::DATE: {
             // Basic ISO date format: YYYY-MM-DD
-            std::regex datePattern(R"(\d{4}-\d{2}-\d{2})");
-            return std::regex_match(value, datePattern);
+            return std::strlen(value) == 10 && isIsoDate(value);
         }
 
         case XsdType::DATETIME: {
             // Basic ISO datetime format: YYYY-MM-DDTHH:MM:SS
-            std::regex datetimePattern(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2})");
-            return std::regex_match(value, datetimePattern);
+            return std::strlen(value) == 19 && isIsoDate(value) && value[10] == 'T' &&
+                   isDigits(value, 11, 13) && value[13] == ':' &&
+                   isDigits(value, 14, 16) && value[16] == ':' &&
+                   isDigits(value, 17, 19);
         }
 
         case XsdType::COMPLEX:
@@ -0,0 +1,9 @@
+# Generation profile for tests/schemas/library.xsd: a skewed catalogue
+FILE_SIZE             lognormal(32KB, 0.8)
+library.book          repeat=zipf(400, 1.1)
+library.book.@isbn    cardinality=1000000
+.title                length=normal(18, 6)
+.author               cardinality=200 skew=1.2 null=0.3
+.year                 value=uniform(1950, 2025)
+.price                value=lognormal(25, 0.6)
+.category             cardinality=12 skew=1.5
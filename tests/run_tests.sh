@@ -53,6 +53,16 @@ run_test "SELECT-005" \
     'SELECT book.title FROM "tests/data/";' \
     ".*"
 
+run_test "SELECT-006" \
+    "Nested FOR bindings" \
+    'SELECT d.name, e.name FROM "tests/data/company.xml" FOR d IN company.department FOR e IN d.employee;' \
+    "Sales +\| David Brown"
+
+run_test "SELECT-007" \
+    "FOR over a partial path" \
+    'SELECT x.name FROM "tests/data/" FOR x IN .department.employee;' \
+    "4 rows returned"
+
 # ============================================================================
 # CATEGORY 2: WHERE Clause - Basic Comparisons
 # ============================================================================
@@ -83,6 +93,36 @@ run_test "WHERE-005" \
     'SELECT book.title FROM "tests/data/books1.xml" WHERE book.category = Fiction;' \
     "The Great Adventure"
 
+run_test "WHERE-006" \
+    "WHERE date-time literal compares chronologically" \
+    'SELECT .name FROM "tests/data/temporal/events.xml" WHERE .starts >= "2025-03-01T12:00:00Z";' \
+    "Kickoff"
+
+run_test "WHERE-007" \
+    "WHERE DATE literal is validated" \
+    'SELECT .name FROM "tests/data/temporal/events.xml" WHERE .day < DATE "2025-02-30";' \
+    "Invalid DATE literal"
+
+run_test "WHERE-008" \
+    "Selective string equality skips other files" \
+    'SELECT .title FROM "tests/data/" WHERE .category = "Lifestyle";' \
+    "1 row returned"
+
+run_test "WHERE-009" \
+    "Entity-encoded text matches its literal" \
+    'SELECT .t FROM "tests/output/entities.xml" WHERE .t = "Tom & Jerry";' \
+    "Tom & Jerry" \
+    'printf "<r><t>Tom &amp; Jerry</t></r>" > tests/output/entities.xml'
+
+run_test "WHERE-010" \
+    "Shorthand WHERE uses the depth-first match" \
+    'SELECT name FROM "tests/output/nested.xml" WHERE price > 10; SELECT name, price FROM "tests/output/nested.xml" WHERE price IS NOT NULL;' \
+    "No results found" \
+    'printf "<r><item><sub><price>1</price><name>inner</name></sub><price>50</price><name>outer</name></item></r>" > tests/output/nested.xml' \
+    "grep -q '1 row returned' tests/output/WHERE-010.out && grep -q 'inner | 1' tests/output/WHERE-010.out && ! grep -q outer tests/output/WHERE-010.out"
+
+rm -f tests/output/entities.xml tests/output/nested.xml 2>/dev/null
+
 # ============================================================================
 # CATEGORY 3: WHERE Clause - NULL Operators
 # ============================================================================
@@ -163,6 +203,11 @@ run_test "ORDER-004" \
     'SELECT .title FROM "tests/data/books1.xml" ORDER BY price DESC;' \
     "Learning Programming"
 
+run_test "ORDER-005" \
+    "ORDER BY date-time sorts chronologically" \
+    'SELECT .name, .starts FROM "tests/data/temporal/events.xml" ORDER BY starts LIMIT 1;' \
+    "Retrospective"
+
 run_test "LIMIT-001" \
     "LIMIT results" \
     'SELECT book.title FROM "tests/data/books1.xml" LIMIT 1;' \
@@ -243,6 +288,21 @@ run_test "AGG-007" \
     'SELECT COUNT(.book), SUM(.price), AVG(.price) FROM "tests/data/books1.xml";' \
     "79.9"
 
+run_test "AGG-008" \
+    "COUNT skips tags inside comments and CDATA" \
+    'SELECT COUNT(.t) FROM "tests/output/count.xml";' \
+    "^2 *$" \
+    'printf "<r><!-- <t>x</t> --><t>a</t><t><![CDATA[<t>y</t>]]></t><t/></r>" > tests/output/count.xml'
+
+run_test "AGG-009" \
+    "FOR aggregates merge across files" \
+    'SELECT COUNT(e) FROM "tests/output/twocompanies" FOR e IN .department.employee; SELECT d.name, COUNT(e), SUM(e.salary) FROM "tests/output/twocompanies" FOR d IN company.department FOR e IN d.employee GROUP BY d.name;' \
+    "^8 *$" \
+    "rm -rf tests/output/twocompanies; mkdir -p tests/output/twocompanies; cp tests/data/company.xml tests/output/twocompanies/a.xml; cp tests/data/company.xml tests/output/twocompanies/b.xml" \
+    "grep -qE '^Engineering +\\| 4 +\\| 340000' tests/output/AGG-009.out && grep -qE '^Sales +\\| 4 +\\| 290000' tests/output/AGG-009.out && grep -q '2 rows returned' tests/output/AGG-009.out"
+
+rm -rf tests/output/count.xml tests/output/twocompanies 2>/dev/null
+
 # ============================================================================
 # CATEGORY 7: XML Attribute Querying (@attr)
 # ============================================================================
@@ -298,6 +358,11 @@ run_test "ATTR-010" \
     'SELECT DISTINCT @isbn FROM "tests/data/books1.xml";' \
     "978-1-23-456789-0"
 
+run_test "ATTR-011" \
+    "Attribute inequality only matches elements carrying the attribute" \
+    'SELECT @id, name FROM "tests/data/products.xml" WHERE @id != "P002";' \
+    "2 rows returned"
+
 # ============================================================================
 # CATEGORY 8: IN Operator
 # ============================================================================
@@ -353,6 +418,11 @@ run_test "IN-010" \
     'SELECT title FROM "tests/data/books1.xml" WHERE title IN ("The Great Adventure", "Learning Programming") AND year = 2020;' \
     "The Great Adventure"
 
+run_test "IN-011" \
+    "Numeric NOT IN combined with a comparison" \
+    'SELECT title FROM "tests/data/" WHERE book.year NOT IN (2019, 2021) AND book.price < 40;' \
+    "3 rows returned"
+
 # ============================================================================
 # CATEGORY 9: Configuration Commands
 # ============================================================================
@@ -378,6 +448,61 @@ run_test "CONFIG-004" \
     'SET DEST tests/output; SHOW DEST; exit;' \
     "tests/output"
 
+run_test "CONFIG-005" \
+    "SET SLOW_QUERY_MS enables slow query log" \
+    'SET SLOW_QUERY_LOG tests/output/slow.log; SET SLOW_QUERY_MS 0; SELECT .title FROM "tests/data/books1.xml"; exit;' \
+    "Slow query log enabled.*tests/output/slow.log" \
+    "rm -f tests/output/slow.log" \
+    "[ \$(wc -l < tests/output/slow.log) -eq 1 ] && grep -qF '\"plan\": \"path extraction\"' tests/output/slow.log && grep -qF '\"stages\": {\"parse\": ' tests/output/slow.log && grep -qF '\"top_files\": [{\"path\": \"tests/data/books1.xml\"' tests/output/slow.log"
+
+run_test "CONFIG-006" \
+    "SHOW SLOW_QUERY_MS after SET" \
+    'SET SLOW_QUERY_LOG tests/output/slow.log; SET SLOW_QUERY_MS 250; SHOW SLOW_QUERY_MS; exit;' \
+    "SLOW_QUERY_MS: 250"
+
+run_test "CONFIG-007" \
+    "SET XSD reuses the compiled schema cache" \
+    'SET XSD tests/schemas/library.xsd; exit;' \
+    "Schema loaded from cache"
+
+run_test "CONFIG-008" \
+    "Files over SET MEMORY budget are admitted one at a time" \
+    'SET MEMORY 1KB; SET VERBOSE; SELECT .title FROM "tests/data"; SHOW MEMORY; exit;' \
+    "MEMORY: 1.0 KB" \
+    "" \
+    '(rows=$($EXPOCLI_BIN "SELECT .title FROM \"tests/data\"" | grep "rows returned") && grep -qF "$rows" tests/output/CONFIG-008.out && read -r factor peak <<< "$(sed -n "s/.*expansion \([0-9.]*\)x, peak in flight \([0-9.]*\) KB.*/\1 \2/p" tests/output/CONFIG-008.out)" && awk -v factor="$factor" -v peak="$peak" -v largest="$(stat -c %s tests/data/*.xml | sort -n | tail -1)" "BEGIN { exit !(peak * 1024 <= largest * factor * 1.01) }")'
+
+run_test "CONFIG-009" \
+    "SET MAX_ROWS with ON_LIMIT PARTIAL keeps the rows so far" \
+    'SET MAX_ROWS 2; SET ON_LIMIT PARTIAL; SELECT .title FROM "tests/data"; exit;' \
+    "MAX_ROWS limit of 2 rows reached; the result is partial"
+
+run_test "CONFIG-010" \
+    "SET MAX_BYTES_SCANNED stops the query with an error" \
+    'SET MAX_BYTES_SCANNED 1KB; SELECT .title FROM "tests/data"; exit;' \
+    "Error: Query stopped: MAX_BYTES_SCANNED limit"
+
+run_test "CONFIG-011" \
+    "SET CHECKPOINT resumes a scan cut short" \
+    'SET CHECKPOINT "tests/output/scan.ckpt"; SELECT .title FROM "tests/data"; exit;' \
+    "Resumed from checkpoint tests/output/scan.ckpt: 1 file\(s\) already scanned" \
+    "rm -f tests/output/scan.ckpt; \$EXPOCLI_BIN --checkpoint tests/output/scan.ckpt --max-bytes-scanned 1KB --partial 'SELECT .title FROM \"tests/data\"'"
+
+run_test "CONFIG-012" \
+    "SET INCREMENTAL parses only appended records" \
+    'SET INCREMENTAL "tests/output/ingest.state"; SELECT .title FROM "tests/output/growing"; exit;' \
+    "Incremental: 1 file\(s\) read from their last record, 0 in full" \
+    "rm -rf tests/output/growing tests/output/ingest.state; mkdir -p tests/output/growing; cp tests/data/books1.xml tests/output/growing/; \$EXPOCLI_BIN --incremental tests/output/ingest.state 'SELECT .title FROM \"tests/output/growing\"'; sed -i 's|</library>|<book><title>Appended</title></book></library>|' tests/output/growing/books1.xml" \
+    "grep -q 'The Great Adventure' tests/output/CONFIG-012.out && grep -q 'Learning Programming' tests/output/CONFIG-012.out && grep -q 'Appended' tests/output/CONFIG-012.out && grep -q '3 rows returned' tests/output/CONFIG-012.out"
+
+run_test "CONFIG-013" \
+    "DOM fallback of COUNT charges bytes once" \
+    'SET MAX_BYTES_SCANNED 1300B; SELECT COUNT(.price) FROM "tests/output/doctype"; exit;' \
+    "^5 *$" \
+    "rm -rf tests/output/doctype; mkdir -p tests/output/doctype; sed 's|<library>|<!DOCTYPE library><library>|' tests/data/books1.xml > tests/output/doctype/books1.xml; cp tests/data/books2.xml tests/output/doctype/"
+
+rm -rf tests/output/slow.log tests/output/scan.ckpt tests/output/growing tests/output/ingest.state tests/output/doctype 2>/dev/null
+
 # ============================================================================
 # CATEGORY 10: XML Generation
 # ============================================================================
@@ -393,8 +518,51 @@ run_test "GEN-002" \
     'SET XSD tests/schemas/library.xsd; SET DEST tests/output; GENERATE XML 1 PREFIX test_; exit;' \
     "Successfully generated 1 XML"
 
+run_test "GEN-003" \
+    "Seeded corpus is the same on 1 and 4 threads" \
+    'SET XSD tests/schemas/library.xsd; SET DEST "tests/output/seed_t4"; GENERATE XML 3 SEED 5 THREADS 4; exit;' \
+    "Successfully generated 3 XML" \
+    "rm -rf tests/output/seed_t1 tests/output/seed_t4; mkdir -p tests/output/seed_t1 tests/output/seed_t4; printf 'SET XSD tests/schemas/library.xsd;\\nSET DEST \"tests/output/seed_t1\";\\nGENERATE XML 3 SEED 5 THREADS 1;\\nexit;\\n' | \$EXPOCLI_BIN" \
+    "[ \$(ls tests/output/seed_t1 | wc -l) -eq 3 ] && diff -r tests/output/seed_t1 tests/output/seed_t4"
+
+rm -rf tests/output/seed_t1 tests/output/seed_t4 2>/dev/null
+
+run_test "GEN-004" \
+    "Generate up to a target corpus size" \
+    'SET XSD tests/schemas/library.xsd; SET DEST tests/output; GENERATE XML 2 SEED 1 TARGET SIZE 64KB; exit;' \
+    "Successfully generated 2 XML files .*\(6[4-9]\.[0-9] KB"
+
+run_test "GEN-005" \
+    "Generate with a statistical profile" \
+    'SET XSD tests/schemas/library.xsd; SET DEST tests/output; GENERATE XML 2 SEED 9 PROFILE tests/profiles/library.profile; exit;' \
+    "Successfully generated 2 XML"
+
+run_test "GEN-006" \
+    "Reject a malformed profile" \
+    'SET XSD tests/schemas/library.xsd; SET DEST tests/output; GENERATE XML 1 PROFILE tests/output/bad.profile; exit;' \
+    "bad.profile:2: unknown distribution 'poisson'" \
+    'printf "# bad\\n.year value=poisson(3, 1)\\n" > tests/output/bad.profile'
+
+run_test "GEN-007" \
+    "Profile a corpus" \
+    'PROFILE tests/data/ INTO tests/output/lookalike.profile; exit;' \
+    "Profiled [0-9]+ file\(s\)"
+
+run_test "GEN-008" \
+    "Generate a look-alike corpus without an XSD" \
+    'PROFILE tests/data/books1.xml INTO tests/output/lookalike.profile; SET DEST tests/output; GENERATE XML 2 SEED 4 PROFILE tests/output/lookalike.profile; exit;' \
+    "Successfully generated 2 XML"
+
+run_test "GEN-009" \
+    "Profiled text leaf with attribute keeps text" \
+    'PROFILE tests/output/attrtext INTO tests/output/attrtext.profile; SET DEST "tests/output/attrtext_gen"; GENERATE XML 1 SEED 3 PROFILE tests/output/attrtext.profile; exit;' \
+    "Successfully generated 1 XML" \
+    "rm -rf tests/output/attrtext tests/output/attrtext_gen; mkdir -p tests/output/attrtext tests/output/attrtext_gen; printf '<bookstore><book><title lang=\"en\">Python Basics</title></book><book><title lang=\"fr\">Le Python</title></book></bookstore>' > tests/output/attrtext/shop.xml" \
+    "grep -qE '<title lang=\"[^\"]+\">[^<]+</title>' tests/output/attrtext_gen/*.xml && ! grep -q '<title[^>]*/>' tests/output/attrtext_gen/*.xml"
+
 # Clean up generated files
-rm -f tests/output/generated_*.xml tests/output/test_*.xml 2>/dev/null
+rm -f tests/output/generated_*.xml tests/output/test_*.xml tests/output/bad.profile tests/output/lookalike.profile 2>/dev/null
+rm -rf tests/output/attrtext tests/output/attrtext_gen tests/output/attrtext.profile 2>/dev/null
 
 # ============================================================================
 # CATEGORY 11: XML Validation (CHECK Command)
@@ -416,6 +584,58 @@ run_test "CHECK-003" \
     'SET XSD tests/schemas/library.xsd; CHECK tests/data/books*.xml; exit;' \
     "Summary:.*valid"
 
+run_test "CHECK-004" \
+    "Streaming validation" \
+    'SET XSD tests/schemas/library.xsd; CHECK STREAM tests/data/books1.xml; exit;' \
+    "✓.*books1.xml"
+
+run_test "CHECK-005" \
+    "Streaming validation reports line numbers" \
+    'SET XSD tests/schemas/library.xsd; CHECK STREAM tests/data/products.xml; exit;' \
+    "Root element name mismatch.*\(line [0-9]+\)"
+
+run_test "CHECK-006" \
+    "Query with VALIDATE AGAINST skips invalid files" \
+    'SELECT .title FROM tests/data VALIDATE AGAINST tests/schemas/library.xsd SKIP INVALID; exit;' \
+    "Skipped 4 file\(s\) failing validation"
+
+run_test "CHECK-007" \
+    "Query with VALIDATE AGAINST ... FAIL" \
+    'SELECT .title FROM tests/data VALIDATE AGAINST tests/schemas/library.xsd FAIL; exit;' \
+    "Error:.*is not valid against"
+
+run_test "CHECK-008" \
+    "SET XSD types comparisons from the schema" \
+    'SET XSD tests/schemas/library.xsd; SELECT .title FROM "tests/data/books1.xml" WHERE .price > "9"; exit;' \
+    "Learning Programming"
+
+run_test "CHECK-009" \
+    "SET XSD rejects paths the schema cannot contain" \
+    'SET XSD tests/schemas/library.xsd; SELECT .isbn13 FROM "tests/data/books1.xml"; exit;' \
+    "Error: Path '.isbn13' cannot match any element of schema"
+
+run_test "CHECK-010" \
+    "Unchanged files reuse the cached verdict" \
+    'SET XSD tests/schemas/library.xsd; CHECK tests/data/books*.xml; CHECK tests/data/books*.xml; exit;' \
+    "Summary: [0-9]+ valid, [0-9]+ invalid \([0-9]+ unchanged since the last CHECK\)" \
+    "rm -rf \$EXPOCLI_VALIDATION_CACHE"
+
+run_test "CHECK-011" \
+    "VALIDATE ... FAIL rejects a malformed file" \
+    'SELECT .title FROM tests/output/malformed VALIDATE AGAINST tests/schemas/library.xsd FAIL; exit;' \
+    "Error:.*broken.xml is not valid against tests/schemas/library.xsd: Start-end tags mismatch" \
+    "rm -rf tests/output/malformed; mkdir -p tests/output/malformed; cp tests/data/books1.xml tests/output/malformed/; printf '<library><book><title>Lost</book></library>' > tests/output/malformed/broken.xml" \
+    "! grep -q 'rows returned' tests/output/CHECK-011.out"
+
+run_test "CHECK-012" \
+    "SKIP INVALID counts a malformed file" \
+    'SELECT .title FROM tests/output/malformed VALIDATE AGAINST tests/schemas/library.xsd SKIP INVALID; exit;' \
+    "Skipped 1 file\(s\) failing validation" \
+    "" \
+    "grep -q '2 rows returned' tests/output/CHECK-012.out"
+
+rm -rf tests/output/malformed 2>/dev/null
+
 # ============================================================================
 # CATEGORY 12: Error Handling
 # ============================================================================
@@ -26,6 +26,11 @@ export TEST_SCHEMA_DIR="$TEST_DIR/schemas"
 export TEST_OUTPUT_DIR="$TEST_DIR/output"
 export TEST_LOG_DIR="$TEST_DIR/logs"
 
+# Keep compiled schemas out of the user's cache directory
+export EXPOCLI_SCHEMA_CACHE="$TEST_OUTPUT_DIR/schema_cache"
+# ... and CHECK verdicts, so CHECK-010 starts from an empty cache
+export EXPOCLI_VALIDATION_CACHE="$TEST_OUTPUT_DIR/validation_cache"
+
 # Detect expocli binary location with multiple strategies
 # Priority order for testing (wrapper doesn't support piped stdin):
 # 1. ./build/expocli local build (best for testing)
@@ -134,13 +139,16 @@ print_category() {
 }
 
 # Run a single test case
-# Usage: run_test "TEST-ID" "Description" "command" "expected_pattern" ["optional_setup"]
+# Usage: run_test "TEST-ID" "Description" "command" "expected_pattern" ["optional_setup"] ["optional_check"]
+# (the check is a shell command run afterwards, e.g. on files the command wrote;
+# the test fails unless it succeeds)
 run_test() {
     local test_id="$1"
     local description="$2"
     local command="$3"
     local expected_pattern="$4"
     local setup="${5:-}"
+    local check="${6:-}"
 
     TESTS_TOTAL=$((TESTS_TOTAL + 1))
 
@@ -189,6 +197,9 @@ run_test() {
         fi
         rm -f "${output_file}.combined"
     fi
+    if [ -n "$check" ] && ! eval "$check" &>/dev/null; then
+        result="FAIL"
+    fi
 
     # Check for errors (unless explicitly testing error cases)
     if [ $exit_code -ne 0 ] && [[ ! "$test_id" =~ ERR ]]; then